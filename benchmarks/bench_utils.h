@@ -0,0 +1,99 @@
+#ifndef EMP_SIGNALGP_BENCH_UTILS_H
+#define EMP_SIGNALGP_BENCH_UTILS_H
+
+// Shared helpers for SignalGP benchmarks.
+// Every benchmark executable is a suite of measurements that reports its results as a single JSON
+// object on stdout (see Reporter::Print), so `make bench` output can be diffed or fed into tooling
+// to track regressions. Benchmarks use fixed random seeds so that every run does the same work.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "base/vector.h"
+
+namespace sgp_bench {
+
+  using bench_clock_t = std::chrono::steady_clock;
+
+  /// Run fun once, return how long it took (in seconds).
+  template<typename FUN>
+  double TimeIt(FUN && fun) {
+    const auto start = bench_clock_t::now();
+    fun();
+    return std::chrono::duration<double>(bench_clock_t::now() - start).count();
+  }
+
+  /// Prevent the compiler from optimizing away a benchmark's work.
+  template<typename T>
+  void DoNotOptimize(const T & value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /// A single benchmark result.
+  struct Measurement {
+    std::string name;   ///< What was measured (e.g., "LinearProgramSignalGP/SingleProcess").
+    double value;       ///< Measured value, in units.
+    std::string unit;   ///< e.g., "steps/sec", "ns/lookup".
+    size_t count;       ///< How many operations were timed (0 if not applicable).
+    double seconds;     ///< Total time spent on the timed operations (0 if not applicable).
+  };
+
+  /// Collects measurements for a benchmark suite and prints them as JSON.
+  class Reporter {
+  protected:
+    std::string suite;
+    int seed;
+    emp::vector<Measurement> measurements;
+
+    static void PrintString(std::ostream & os, const std::string & str) {
+      os << '"';
+      for (char c : str) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+      }
+      os << '"';
+    }
+
+  public:
+    Reporter(const std::string & _suite, int _seed) : suite(_suite), seed(_seed), measurements() { ; }
+
+    const emp::vector<Measurement> & GetMeasurements() const { return measurements; }
+
+    /// Record a rate: count operations in seconds (reported as count / seconds).
+    void AddRate(const std::string & name, size_t count, double seconds, const std::string & unit) {
+      measurements.emplace_back(Measurement{name, (double)count / seconds, unit, count, seconds});
+    }
+
+    /// Record a cost: count operations in seconds (reported as nanoseconds per operation).
+    void AddCost(const std::string & name, size_t count, double seconds, const std::string & unit) {
+      measurements.emplace_back(Measurement{name, seconds * 1e9 / (double)count, unit, count, seconds});
+    }
+
+    /// Record an arbitrary (derived) value.
+    void AddValue(const std::string & name, double value, const std::string & unit) {
+      measurements.emplace_back(Measurement{name, value, unit, 0, 0.0});
+    }
+
+    /// Print all measurements as a JSON object:
+    ///   {"suite": ..., "seed": ..., "results": [{"name", "value", "unit", "count", "seconds"}, ...]}
+    void Print(std::ostream & os=std::cout) const {
+      os << "{\n  \"suite\": ";
+      PrintString(os, suite);
+      os << ",\n  \"seed\": " << seed << ",\n  \"results\": [";
+      for (size_t i = 0; i < measurements.size(); ++i) {
+        const Measurement & m = measurements[i];
+        os << (i ? ",\n" : "\n") << "    {\"name\": ";
+        PrintString(os, m.name);
+        os << ", \"value\": " << m.value << ", \"unit\": ";
+        PrintString(os, m.unit);
+        os << ", \"count\": " << m.count << ", \"seconds\": " << m.seconds << "}";
+      }
+      os << "\n  ]\n}\n";
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+// Benchmark: sending one event to many hardware units.
+// Compares queueing a copy of an event on every recipient (QueueEvent per hardware) with
+// EventLibrary::BroadcastEvent (one shared copy, queued by reference), for an event carrying a
+// heap-allocated payload and for a small trivially-copyable event. Each round sends one event to
+// every recipient and then runs every recipient once (handling the event).
+
+#include <string>
+
+#include "impls/SignalGPToy.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t NUM_HW = 500;
+constexpr size_t NUM_ROUNDS = 2000;
+
+using hw_t = ToySignalGP<>;
+
+struct PayloadEvent : public sgp::BaseEvent {
+  emp::vector<double> payload;
+  PayloadEvent(size_t id, size_t size) : BaseEvent(id), payload(size, 1.0) { ; }
+};
+
+struct SmallEvent : public sgp::BaseEvent {
+  size_t value;
+  SmallEvent(size_t id, size_t _value) : BaseEvent(id), value(_value) { ; }
+};
+
+template<typename EVENT_T>
+void Run(sgp_bench::Reporter & reporter, const std::string & name, hw_t::event_lib_t & event_lib,
+         emp::vector<hw_t *> & recipients, const EVENT_T & event) {
+  const size_t count = NUM_HW * NUM_ROUNDS;
+  double secs = sgp_bench::TimeIt([&]() {
+    for (size_t r = 0; r < NUM_ROUNDS; ++r) {
+      for (hw_t * hw : recipients) hw->QueueEvent(event);
+      for (hw_t * hw : recipients) hw->SingleProcess();
+    }
+  });
+  reporter.AddCost(name + "/QueueEvent", count, secs, "ns/recipient");
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t r = 0; r < NUM_ROUNDS; ++r) {
+      event_lib.BroadcastEvent(recipients, event);
+      for (hw_t * hw : recipients) hw->SingleProcess();
+    }
+  });
+  reporter.AddCost(name + "/BroadcastEvent", count, secs, "ns/recipient");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("broadcast", SEED);
+  hw_t::event_lib_t event_lib;
+  size_t checksum = 0;
+  const size_t payload_id = event_lib.AddEvent("Payload", [&checksum](hw_t & hw, const sgp::BaseEvent & e) {
+    checksum += static_cast<const PayloadEvent &>(e).payload.size();
+  });
+  const size_t small_id = event_lib.AddEvent("Small", [&checksum](hw_t & hw, const sgp::BaseEvent & e) {
+    checksum += static_cast<const SmallEvent &>(e).value;
+  });
+  emp::vector<hw_t> hardware(NUM_HW, hw_t(event_lib));
+  emp::vector<hw_t *> recipients;
+  for (hw_t & hw : hardware) recipients.emplace_back(&hw);
+
+  Run(reporter, "payload64", event_lib, recipients, PayloadEvent(payload_id, 64));
+  Run(reporter, "small", event_lib, recipients, SmallEvent(small_id, 1));
+  sgp_bench::DoNotOptimize(checksum);
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,78 @@
+// Benchmark: SignalGPBase's per-step dispatch overhead.
+// Runs programs whose instructions do (almost) nothing, so timings are dominated by the cost of
+// getting from SingleProcess to the derived hardware's SingleExecutionStep and from there to the
+// instruction: LinearProgramSignalGP running a single thread (and sixteen threads) through a
+// loop of Nops, and ToySignalGP (whose execution step is a single decrement).
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "impls/SignalGPToy.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t NUM_STEPS = 200000;
+
+using lp_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel,
+                                           emp::BitSet<TAG_WIDTH>,
+                                           int,
+                                           emp::MatchBin< size_t,
+                                                          emp::HammingMetric<TAG_WIDTH>,
+                                                          emp::RankedSelector<>,
+                                                          emp::AdditiveCountdownRegulator<>
+                                                        >>;
+
+void RunLinearProgram(sgp_bench::Reporter & reporter, size_t num_threads) {
+  using inst_t = typename lp_hw_t::inst_t;
+  using inst_prop_t = typename lp_hw_t::InstProperty;
+  emp::Random random(SEED);
+  typename lp_hw_t::inst_lib_t inst_lib;
+  typename lp_hw_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](lp_hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<lp_hw_t, inst_t>, "");
+  typename lp_hw_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {emp::BitSet<TAG_WIDTH>(random)});
+  for (size_t i = 0; i < 32; ++i) program.PushInst(inst_lib, "Nop", {0, 0, 0});
+  lp_hw_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  for (size_t i = 0; i < num_threads; ++i) hw.SpawnThreadWithID(0, 1.0);
+  // Threads run circular modules so that they never finish.
+  hw.SingleProcess();
+  for (size_t thread_id : hw.GetActiveThreadIDs()) {
+    hw.GetThread(thread_id).GetExecState().GetTopCallState().circular = true;
+  }
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_STEPS; ++i) hw.SingleProcess();
+  });
+  reporter.AddCost("LinearProgramSignalGP/threads" + std::to_string(num_threads),
+                   NUM_STEPS * num_threads, secs, "ns/thread-step");
+}
+
+void RunToy(sgp_bench::Reporter & reporter, size_t num_threads) {
+  using toy_hw_t = ToySignalGP<>;
+  typename toy_hw_t::event_lib_t event_lib;
+  toy_hw_t hw(event_lib);
+  hw.SetProgram({NUM_STEPS + 1});
+  for (size_t i = 0; i < num_threads; ++i) hw.SpawnThreadWithID(0);
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_STEPS; ++i) hw.SingleProcess();
+  });
+  reporter.AddCost("ToySignalGP/threads" + std::to_string(num_threads),
+                   NUM_STEPS * num_threads, secs, "ns/thread-step");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("dispatch", SEED);
+  for (size_t num_threads : {1, 16}) {
+    RunLinearProgram(reporter, num_threads);
+    RunToy(reporter, num_threads);
+  }
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Benchmark: delivering events to hardware from other threads.
+// Compares posting through the hardware's lock-free event inbox (PostEvent) with guarding
+// QueueEvent and SingleProcess with a shared mutex:
+// - uncontended: one thread sends bursts of events and runs SingleProcess after each burst
+//   (the per-event cost of each path);
+// - concurrent: producer threads send events to one ToySignalGP while the main thread keeps
+//   running it (yielding when a step handles nothing), for one and four producers. Also reports
+//   the longest SingleProcess call seen by the evaluation thread. (Results depend heavily on the
+//   number of hardware threads, which is reported too.)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "impls/SignalGPToy.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t NUM_EVENTS = 200000;  // Per producer.
+constexpr size_t BURST_SIZE = 256;
+
+using hw_t = ToySignalGP<>;
+using clock_t_ = std::chrono::steady_clock;
+
+struct SignalEvent : public sgp::BaseEvent {
+  size_t value;
+  SignalEvent(size_t id, size_t _value) : BaseEvent(id), value(_value) { ; }
+};
+
+/// Run producers (calling send(event) NUM_EVENTS times each) while running hw with step() until
+/// every event has been handled.
+template<typename SEND_FUN, typename STEP_FUN>
+void Run(sgp_bench::Reporter & reporter, const std::string & name, size_t num_producers,
+         size_t event_id, const size_t & num_handled, SEND_FUN send, STEP_FUN step) {
+  const size_t total = num_producers * NUM_EVENTS;
+  double max_step_secs = 0.0;
+  const double secs = sgp_bench::TimeIt([&]() {
+    emp::vector<std::thread> producers;
+    for (size_t p = 0; p < num_producers; ++p) {
+      producers.emplace_back([&send, event_id]() {
+        for (size_t i = 0; i < NUM_EVENTS; ++i) send(SignalEvent(event_id, i));
+      });
+    }
+    while (num_handled < total) {
+      const size_t prev_handled = num_handled;
+      const auto start = clock_t_::now();
+      step();
+      max_step_secs = std::max(max_step_secs, std::chrono::duration<double>(clock_t_::now() - start).count());
+      if (num_handled == prev_handled) std::this_thread::yield();
+    }
+    for (auto & producer : producers) producer.join();
+  });
+  const std::string prefix = name + "/producers" + std::to_string(num_producers);
+  reporter.AddRate(prefix, total, secs, "events/sec");
+  reporter.AddValue(prefix + "/max-step", max_step_secs * 1e6, "us");
+}
+
+/// Send bursts of events (with send) and run hw (with step) after each burst, all on this thread.
+template<typename SEND_FUN, typename STEP_FUN>
+void RunUncontended(sgp_bench::Reporter & reporter, const std::string & name, size_t event_id,
+                    SEND_FUN send, STEP_FUN step) {
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_EVENTS; i += BURST_SIZE) {
+      for (size_t k = 0; k < BURST_SIZE; ++k) send(SignalEvent(event_id, i + k));
+      step();
+    }
+  });
+  reporter.AddCost(name + "/uncontended", NUM_EVENTS, secs, "ns/event");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("event_inbox", SEED);
+  reporter.AddValue("hardware-threads", std::thread::hardware_concurrency(), "threads");
+  {
+    typename hw_t::event_lib_t event_lib;
+    const size_t event_id = event_lib.AddEvent("Signal", [](hw_t &, const sgp::BaseEvent &) { ; });
+    hw_t hw(event_lib);
+    hw.EnableEventInbox(1024, hw_t::event_inbox_t::FullPolicy::WAIT);
+    RunUncontended(reporter, "EventInbox", event_id,
+                   [&hw](const SignalEvent & event) { hw.PostEvent(event); },
+                   [&hw]() { hw.SingleProcess(); });
+    std::mutex mutex;
+    RunUncontended(reporter, "Mutex", event_id,
+                   [&hw, &mutex](const SignalEvent & event) { std::lock_guard<std::mutex> lock(mutex); hw.QueueEvent(event); },
+                   [&hw, &mutex]() { std::lock_guard<std::mutex> lock(mutex); hw.SingleProcess(); });
+  }
+  for (size_t num_producers : {1, 4}) {
+    // Lock-free inbox.
+    {
+      typename hw_t::event_lib_t event_lib;
+      size_t num_handled = 0;
+      const size_t event_id = event_lib.AddEvent("Signal", [&num_handled](hw_t &, const sgp::BaseEvent &) { ++num_handled; });
+      hw_t hw(event_lib);
+      hw.EnableEventInbox(1024, hw_t::event_inbox_t::FullPolicy::WAIT);
+      Run(reporter, "EventInbox", num_producers, event_id, num_handled,
+          [&hw](const SignalEvent & event) { hw.PostEvent(event); },
+          [&hw]() { hw.SingleProcess(); });
+    }
+    // Shared mutex around QueueEvent/SingleProcess.
+    {
+      typename hw_t::event_lib_t event_lib;
+      size_t num_handled = 0;
+      const size_t event_id = event_lib.AddEvent("Signal", [&num_handled](hw_t &, const sgp::BaseEvent &) { ++num_handled; });
+      hw_t hw(event_lib);
+      std::mutex mutex;
+      Run(reporter, "Mutex", num_producers, event_id, num_handled,
+          [&hw, &mutex](const SignalEvent & event) { std::lock_guard<std::mutex> lock(mutex); hw.QueueEvent(event); },
+          [&hw, &mutex]() { std::lock_guard<std::mutex> lock(mutex); hw.SingleProcess(); });
+    }
+  }
+  reporter.Print();
+  return 0;
+}
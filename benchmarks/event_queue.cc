@@ -0,0 +1,84 @@
+// Benchmark: event queue drain rate.
+// Queues bursts of events onto LinearProgramSignalGP hardware (with no program loaded) and
+// measures how quickly SingleProcess dispatches them to their handlers. Covers a plain
+// BaseEvent, an event with a (non-trivially destructible) payload, and handlers that queue
+// follow-up events.
+
+#include <string>
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t BURST_SIZE = 256;
+constexpr size_t NUM_BURSTS = 20000;
+
+using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel,
+                                              emp::BitSet<TAG_WIDTH>,
+                                              int,
+                                              emp::MatchBin< size_t,
+                                                             emp::HammingMetric<TAG_WIDTH>,
+                                                             emp::RankedSelector<>,
+                                                             emp::AdditiveCountdownRegulator<>
+                                                            >>;
+using event_lib_t = typename signalgp_t::event_lib_t;
+using event_t = typename signalgp_t::event_t;
+
+struct MessageEvent : public sgp::BaseEvent {
+  std::string msg;
+  emp::BitSet<TAG_WIDTH> tag;
+  MessageEvent(size_t id, const std::string & _msg, const emp::BitSet<TAG_WIDTH> & _tag)
+    : BaseEvent(id), msg(_msg), tag(_tag) { ; }
+};
+
+int main() {
+  sgp_bench::Reporter reporter("event_queue", SEED);
+  emp::Random random(SEED);
+  typename signalgp_t::inst_lib_t inst_lib;
+  event_lib_t event_lib;
+
+  size_t handled = 0;
+  const size_t base_id = event_lib.AddEvent("Base", [&handled](signalgp_t & hw, const event_t & e) { ++handled; });
+  const size_t msg_id = event_lib.AddEvent("Message", [&handled](signalgp_t & hw, const event_t & e) {
+    handled += static_cast<const MessageEvent &>(e).msg.size();
+  });
+  const size_t echo_id = event_lib.AddEvent("Echo", [&handled, base_id](signalgp_t & hw, const event_t & e) {
+    ++handled;
+    hw.QueueEvent(sgp::BaseEvent(base_id)); // Handled during the same SingleProcess.
+  });
+
+  signalgp_t hw(random, inst_lib, event_lib);
+  const emp::BitSet<TAG_WIDTH> tag(random);
+
+  auto run = [&](const std::string & name, size_t events_per_burst, auto && queue_burst) {
+    handled = 0;
+    const double secs = sgp_bench::TimeIt([&]() {
+      for (size_t b = 0; b < NUM_BURSTS; ++b) {
+        queue_burst();
+        hw.SingleProcess();
+      }
+    });
+    sgp_bench::DoNotOptimize(handled);
+    reporter.AddRate(name, NUM_BURSTS * events_per_burst, secs, "events/sec");
+  };
+
+  run("BaseEvent", BURST_SIZE, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) hw.QueueEvent(sgp::BaseEvent(base_id));
+  });
+  run("MessageEvent", BURST_SIZE, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) hw.QueueEvent(MessageEvent(msg_id, "message", tag));
+  });
+  // Each echo event queues one more event while the queue is being drained.
+  run("EchoEvent", 2 * BURST_SIZE, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) hw.QueueEvent(sgp::BaseEvent(echo_id));
+  });
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,130 @@
+// Benchmark: execution throughput of LinearProgramSignalGP and LinearFunctionsProgramSignalGP
+// on random programs (GenRandLinearProgram/GenRandLinearFunctionsProgram).
+// Each program is loaded, seeded with a few threads, and run for a fixed number of SingleProcess
+// steps (respawning threads whenever all of them die). Reports SingleProcess steps per second and
+// thread steps (i.e., SingleExecutionStep calls) per second.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "impls/SignalGPLinearFunctionsProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/linear_functions_program_instructions_impls.h"
+#include "utils/LinearFunctionsProgram.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t NUM_PROGRAMS = 100;
+constexpr size_t STEPS_PER_PROGRAM = 2000;
+constexpr size_t THREADS_PER_PROGRAM = 4;
+constexpr size_t MAX_ACTIVE_THREADS = 16;
+
+using mem_model_t = sgp::SimpleMemoryModel;
+using matchbin_t = emp::MatchBin< size_t,
+                                  emp::HammingMetric<TAG_WIDTH>,
+                                  emp::RankedSelector<>,
+                                  emp::AdditiveCountdownRegulator<>
+                                >;
+using lp_hw_t = sgp::LinearProgramSignalGP<mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+using lfp_hw_t = sgp::LinearFunctionsProgramSignalGP<mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+
+/// Instructions shared by both hardware types.
+template<typename HARDWARE_T>
+void AddCommonInstructions(typename HARDWARE_T::inst_lib_t & inst_lib) {
+  using inst_t = typename HARDWARE_T::inst_t;
+  using inst_prop_t = typename HARDWARE_T::InstProperty;
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Not", sgp::inst_impl::Inst_Not<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Sub", sgp::inst_impl::Inst_Sub<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Mult", sgp::inst_impl::Inst_Mult<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Div", sgp::inst_impl::Inst_Div<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("TestEqu", sgp::inst_impl::Inst_TestEqu<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("CopyMem", sgp::inst_impl::Inst_CopyMem<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<HARDWARE_T, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("Terminate", sgp::inst_impl::Inst_Terminate<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<HARDWARE_T, inst_t>, "");
+  inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<HARDWARE_T, inst_t>, "");
+}
+
+/// Run every program for STEPS_PER_PROGRAM steps on hw, record throughput under name.
+template<typename HARDWARE_T>
+void RunPrograms(sgp_bench::Reporter & reporter, const std::string & name, HARDWARE_T & hw,
+                 const emp::vector<typename HARDWARE_T::program_t> & programs) {
+  hw.SetActiveThreadLimit(MAX_ACTIVE_THREADS);
+  size_t steps = 0;
+  size_t thread_steps = 0;
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (const auto & program : programs) {
+      hw.SetProgram(program);
+      for (size_t i = 0; i < STEPS_PER_PROGRAM; ++i) {
+        if (!hw.GetNumActiveThreads() && !hw.GetNumPendingThreads()) {
+          for (size_t t = 0; t < THREADS_PER_PROGRAM; ++t) hw.SpawnThreadWithID(t % hw.GetNumModules());
+        }
+        // Every active thread (after pending threads are activated) executes one step.
+        thread_steps += std::min(hw.GetNumActiveThreads() + hw.GetNumPendingThreads(), hw.GetMaxActiveThreads());
+        hw.SingleProcess();
+        ++steps;
+      }
+    }
+  });
+  reporter.AddRate(name + "/SingleProcess", steps, secs, "steps/sec");
+  reporter.AddRate(name + "/SingleExecutionStep", thread_steps, secs, "thread-steps/sec");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("hardware_throughput", SEED);
+  emp::Random random(SEED);
+
+  // LinearProgramSignalGP
+  {
+    using inst_t = typename lp_hw_t::inst_t;
+    using inst_prop_t = typename lp_hw_t::InstProperty;
+    typename lp_hw_t::inst_lib_t inst_lib;
+    typename lp_hw_t::event_lib_t event_lib;
+    inst_lib.AddInst("ModuleDef", [](lp_hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+    inst_lib.AddInst("If", sgp::inst_impl::Inst_If<lp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("While", sgp::inst_impl::Inst_While<lp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<lp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    AddCommonInstructions<lp_hw_t>(inst_lib);
+    emp::vector<typename lp_hw_t::program_t> programs;
+    for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+      programs.emplace_back(sgp::GenRandLinearProgram<lp_hw_t, TAG_WIDTH>(random, inst_lib, {64, 256}, 1, 3, {0, 7}));
+    }
+    lp_hw_t hw(random, inst_lib, event_lib);
+    RunPrograms(reporter, "LinearProgramSignalGP", hw, programs);
+  }
+
+  // LinearFunctionsProgramSignalGP
+  {
+    using inst_t = typename lfp_hw_t::inst_t;
+    using inst_prop_t = typename lfp_hw_t::InstProperty;
+    typename lfp_hw_t::inst_lib_t inst_lib;
+    typename lfp_hw_t::event_lib_t event_lib;
+    inst_lib.AddInst("If", sgp::lfp_inst_impl::Inst_If<lfp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("While", sgp::lfp_inst_impl::Inst_While<lfp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Countdown", sgp::lfp_inst_impl::Inst_Countdown<lfp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    AddCommonInstructions<lfp_hw_t>(inst_lib);
+    emp::vector<typename lfp_hw_t::program_t> programs;
+    for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+      programs.emplace_back(sgp::GenRandLinearFunctionsProgram<lfp_hw_t, TAG_WIDTH>(random, inst_lib, {1, 8}, 1, {16, 64}, 1, 3, {0, 7}));
+    }
+    lfp_hw_t hw(random, inst_lib, event_lib);
+    RunPrograms(reporter, "LinearFunctionsProgramSignalGP", hw, programs);
+  }
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Benchmark: cost of instrumenting hardware.
+// Runs the same LinearProgramSignalGP workload (sixteen threads looping over a module that calls
+// another module) with the default instrumentation policy (NoInstrumentation) and with
+// ExecutionProfiler, and reports thread steps per second for each.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "Instrumentation.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t NUM_STEPS = 100000;
+constexpr size_t NUM_THREADS = 16;
+
+template<typename INSTRUMENTATION_T>
+using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel,
+                                              emp::BitSet<TAG_WIDTH>,
+                                              int,
+                                              emp::MatchBin< size_t,
+                                                             emp::HammingMetric<TAG_WIDTH>,
+                                                             emp::RankedSelector<>,
+                                                             emp::AdditiveCountdownRegulator<>
+                                                           >,
+                                              sgp::DefaultCustomComponent,
+                                              INSTRUMENTATION_T>;
+
+template<typename INSTRUMENTATION_T>
+void Run(sgp_bench::Reporter & reporter, const std::string & name) {
+  using hw_t = signalgp_t<INSTRUMENTATION_T>;
+  using inst_t = typename hw_t::inst_t;
+  using inst_prop_t = typename hw_t::InstProperty;
+  emp::Random random(SEED);
+  typename hw_t::inst_lib_t inst_lib;
+  typename hw_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<hw_t, inst_t>, "");
+  const emp::BitSet<TAG_WIDTH> main_tag(random);
+  const emp::BitSet<TAG_WIDTH> callee_tag(random);
+  typename hw_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {main_tag});
+  for (size_t i = 0; i < 8; ++i) program.PushInst(inst_lib, "Inc", {(int)i, 0, 0});
+  program.PushInst(inst_lib, "Call", {0, 0, 0}, {callee_tag});
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {callee_tag});
+  for (size_t i = 0; i < 4; ++i) program.PushInst(inst_lib, "Inc", {(int)i, 0, 0});
+  hw_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  for (size_t i = 0; i < NUM_THREADS; ++i) hw.SpawnThreadWithID(0);
+  // Threads run circular main modules so that they never finish.
+  hw.SingleProcess();
+  for (size_t thread_id : hw.GetActiveThreadIDs()) {
+    hw.GetThread(thread_id).GetExecState().call_stack[0].circular = true;
+  }
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_STEPS; ++i) hw.SingleProcess();
+  });
+  sgp_bench::DoNotOptimize(hw.GetInstrumentation());
+  reporter.AddRate(name, NUM_STEPS * NUM_THREADS, secs, "thread-steps/sec");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("instrumentation", SEED);
+  Run<sgp::NoInstrumentation>(reporter, "NoInstrumentation");
+  Run<sgp::ExecutionProfiler>(reporter, "ExecutionProfiler");
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Benchmark: end-of-block lookups on loop-heavy LinearProgramSignalGP programs.
+// Compares precomputed block table lookups (FindEndOfBlock) against scanning the
+// program for the end of each block (ScanEndOfBlock), and reports overall
+// instruction throughput on the same programs.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t NUM_PROGRAMS = 200;
+constexpr size_t STEPS_PER_PROGRAM = 5000;
+constexpr size_t LOOKUP_REPS = 200;
+
+using mem_model_t = sgp::SimpleMemoryModel;
+using signalgp_t = sgp::LinearProgramSignalGP<mem_model_t,
+                                              emp::BitSet<TAG_WIDTH>,
+                                              int,
+                                              emp::MatchBin< size_t,
+                                                             emp::HammingMetric<TAG_WIDTH>,
+                                                             emp::RankedSelector<>,
+                                                             emp::AdditiveCountdownRegulator<>
+                                                            >>;
+using inst_lib_t = typename signalgp_t::inst_lib_t;
+using inst_t = typename signalgp_t::inst_t;
+using inst_prop_t = typename signalgp_t::InstProperty;
+using event_lib_t = typename signalgp_t::event_lib_t;
+using program_t = typename signalgp_t::program_t;
+
+constexpr int SEED = 1;
+
+int main() {
+  sgp_bench::Reporter reporter("linear_program_blocks", SEED);
+  emp::Random random(SEED);
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+
+  // A loop-heavy instruction set: a large fraction of instructions open or close blocks.
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<signalgp_t, inst_t>, "");
+
+  emp::vector<program_t> programs;
+  for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+    programs.emplace_back(sgp::GenRandLinearProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {64, 256}, 1, 3, {0, 3}));
+  }
+
+  signalgp_t hardware(random, inst_lib, event_lib);
+
+  // (1) End-of-block lookups: table vs. scan.
+  double table_secs = 0.0;
+  double scan_secs = 0.0;
+  size_t lookups = 0;
+  size_t checksum = 0;
+  for (const program_t & program : programs) {
+    hardware.SetProgram(program);
+    emp::vector<std::pair<size_t, size_t>> starts; // (mp, ip) immediately following each block-opening instruction.
+    for (size_t pos = 0; pos < program.GetSize(); ++pos) {
+      if (!inst_lib.HasProperty(program[pos].GetID(), inst_prop_t::BLOCK_DEF)) continue;
+      starts.emplace_back(hardware.GetModuleAt(pos), (pos + 1) % program.GetSize());
+    }
+    table_secs += sgp_bench::TimeIt([&]() {
+      for (size_t r = 0; r < LOOKUP_REPS; ++r) {
+        for (const auto & start : starts) checksum += hardware.FindEndOfBlock(start.first, start.second);
+      }
+    });
+    scan_secs += sgp_bench::TimeIt([&]() {
+      for (size_t r = 0; r < LOOKUP_REPS; ++r) {
+        for (const auto & start : starts) checksum -= hardware.ScanEndOfBlock(start.first, start.second);
+      }
+    });
+    lookups += LOOKUP_REPS * starts.size();
+  }
+
+  // (2) Execution throughput on the same programs.
+  size_t steps = 0;
+  const double exec_secs = sgp_bench::TimeIt([&]() {
+    for (const program_t & program : programs) {
+      hardware.SetProgram(program);
+      for (size_t i = 0; i < STEPS_PER_PROGRAM; ++i) {
+        if (!hardware.GetNumActiveThreads() && !hardware.GetNumPendingThreads()) hardware.SpawnThreadWithID(0);
+        hardware.SingleProcess();
+        ++steps;
+      }
+    }
+  });
+
+  sgp_bench::DoNotOptimize(checksum);
+  reporter.AddCost("FindEndOfBlock/table", lookups, table_secs, "ns/lookup");
+  reporter.AddCost("FindEndOfBlock/scan", lookups, scan_secs, "ns/lookup");
+  reporter.AddValue("FindEndOfBlock/speedup", scan_secs / table_secs, "x");
+  reporter.AddRate("LinearProgramSignalGP/SingleProcess", steps, exec_secs, "steps/sec");
+  reporter.Print();
+  return 0;
+}
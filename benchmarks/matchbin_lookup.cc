@@ -0,0 +1,79 @@
+// Benchmark: tag-based module lookup cost.
+// Measures FindModuleMatch (i.e., matchbin lookups) on LinearFunctionsProgramSignalGP hardware
+// with programs of increasing numbers of modules. Queries come from a small pool of tags, as
+// evolved programs tend to reuse the same few call/event tags. Lookups are measured with and
+// without the hardware's match cache, and with emp::MatchBin versus sgp::HammingMatchBin (which
+// is specialized for BitSet tags) on wide tags.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearFunctionsProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/LinearFunctionsProgram.h"
+#include "utils/MemoryModel.h"
+#include "utils/HammingMatchBin.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t NUM_QUERIES = 50000;
+constexpr size_t NUM_QUERY_TAGS = 32;
+
+template<size_t W>
+using emp_matchbin_t = emp::MatchBin< size_t,
+                                      emp::HammingMetric<W>,
+                                      emp::RankedSelector<>,
+                                      emp::AdditiveCountdownRegulator<>
+                                    >;
+
+template<size_t W, typename MATCHBIN_T>
+using signalgp_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<W>, int, MATCHBIN_T>;
+
+/// Time NUM_QUERIES FindModuleMatch calls on programs with each of the given numbers of modules.
+template<size_t W, typename MATCHBIN_T>
+void Run(sgp_bench::Reporter & reporter, const std::string & name, emp::Random & random,
+         const emp::vector<size_t> & module_counts, const emp::vector<bool> & cache_settings) {
+  using hw_t = signalgp_t<W, MATCHBIN_T>;
+  using tag_t = emp::BitSet<W>;
+  typename hw_t::inst_lib_t inst_lib;
+  typename hw_t::event_lib_t event_lib;
+  inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<hw_t, typename hw_t::inst_t>, "");
+
+  emp::vector<tag_t> query_tags;
+  for (size_t i = 0; i < NUM_QUERY_TAGS; ++i) query_tags.emplace_back(random);
+  emp::vector<size_t> queries(NUM_QUERIES);
+  for (size_t & query : queries) query = random.GetUInt(NUM_QUERY_TAGS);
+
+  hw_t hw(random, inst_lib, event_lib);
+  for (size_t num_modules : module_counts) {
+    hw.SetProgram(sgp::GenRandLinearFunctionsProgram<hw_t, W>(random, inst_lib, {num_modules, num_modules}, 1, {1, 1}, 1, 3, {0, 7}));
+    for (bool cached : cache_settings) {
+      hw.SetMatchCaching(cached);
+      for (size_t n : {1, 4}) {
+        size_t checksum = 0;
+        const double secs = sgp_bench::TimeIt([&]() {
+          for (size_t query : queries) checksum += hw.FindModuleMatch(query_tags[query], n).size();
+        });
+        sgp_bench::DoNotOptimize(checksum);
+        reporter.AddCost(name + "/" + (cached ? "cached" : "uncached") + "/tag" + std::to_string(W)
+                           + "/modules" + std::to_string(num_modules) + "/n" + std::to_string(n),
+                         NUM_QUERIES, secs, "ns/lookup");
+      }
+    }
+  }
+}
+
+int main() {
+  sgp_bench::Reporter reporter("matchbin_lookup", SEED);
+  emp::Random random(SEED);
+  Run<64, emp_matchbin_t<64>>(reporter, "MatchBin", random, {8, 32, 128}, {false, true});
+  // Wide tags, many modules: emp::MatchBin vs. HammingMatchBin (uncached).
+  Run<128, emp_matchbin_t<128>>(reporter, "MatchBin", random, {64, 256}, {false});
+  Run<128, sgp::HammingMatchBin<128>>(reporter, "HammingMatchBin", random, {64, 256}, {false});
+  Run<256, emp_matchbin_t<256>>(reporter, "MatchBin", random, {64, 256}, {false});
+  Run<256, sgp::HammingMatchBin<256>>(reporter, "HammingMatchBin", random, {64, 256}, {false});
+  reporter.Print();
+  return 0;
+}
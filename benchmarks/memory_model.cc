@@ -0,0 +1,76 @@
+// Benchmark: cost of module calls/returns under different memory models.
+// Runs a recursive LinearProgramSignalGP program: the module fills a number of working memory
+// registers, writes one output, and calls itself until the hardware's max call depth is reached,
+// after which the whole call stack unwinds. Measures thread steps per second for
+// SimpleMemoryModel, RegisterMemoryModel, and CowMemoryModel with increasingly full working memory.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t NUM_RUNS = 200;
+constexpr size_t NUM_REGISTERS = 32;
+
+template<typename MEM_MODEL_T>
+using signalgp_t = sgp::LinearProgramSignalGP<MEM_MODEL_T,
+                                              emp::BitSet<TAG_WIDTH>,
+                                              int,
+                                              emp::MatchBin< size_t,
+                                                             emp::HammingMetric<TAG_WIDTH>,
+                                                             emp::RankedSelector<>,
+                                                             emp::AdditiveCountdownRegulator<>
+                                                           >>;
+
+template<typename MEM_MODEL_T>
+void Run(sgp_bench::Reporter & reporter, const std::string & name, size_t num_working) {
+  using hw_t = signalgp_t<MEM_MODEL_T>;
+  using inst_t = typename hw_t::inst_t;
+  using inst_prop_t = typename hw_t::InstProperty;
+  emp::Random random(SEED);
+  typename hw_t::inst_lib_t inst_lib;
+  typename hw_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+  inst_lib.AddInst("WorkingToOutput", sgp::inst_impl::Inst_WorkingToOutput<hw_t, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<hw_t, inst_t>, "");
+
+  const emp::BitSet<TAG_WIDTH> tag(random);
+  typename hw_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tag});
+  for (size_t i = 0; i < num_working; ++i) program.PushInst(inst_lib, "Inc", {(int)i, 0, 0});
+  program.PushInst(inst_lib, "WorkingToOutput", {0, 0, 0});
+  program.PushInst(inst_lib, "Call", {0, 0, 0}, {tag});
+
+  hw_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  size_t steps = 0;
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t run = 0; run < NUM_RUNS; ++run) {
+      hw.SpawnThreadWithID(0);
+      while (hw.GetNumActiveThreads() || hw.GetNumPendingThreads()) {
+        hw.SingleProcess();
+        ++steps;
+      }
+    }
+  });
+  reporter.AddRate(name + "/working" + std::to_string(num_working), steps, secs, "thread-steps/sec");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("memory_model", SEED);
+  for (size_t num_working : {1, 8, 32}) {
+    Run<sgp::SimpleMemoryModel>(reporter, "SimpleMemoryModel", num_working);
+    Run<sgp::RegisterMemoryModel<NUM_REGISTERS>>(reporter, "RegisterMemoryModel", num_working);
+    Run<sgp::CowMemoryModel>(reporter, "CowMemoryModel", num_working);
+  }
+  reporter.Print();
+  return 0;
+}
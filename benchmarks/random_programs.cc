@@ -0,0 +1,67 @@
+// Benchmark: random tag and population generation.
+// Times BitSet<W>::Randomize against emp::RandomizeBitSet, unique tag generation (RandomBitSets
+// with guarantee_unique), and initializing a population of random LinearFunctionsPrograms one
+// program at a time (GenRandLinearFunctionsProgram) and in one pass (GenRandLinearFunctionsPrograms).
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearFunctionsProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/LinearFunctionsProgram.h"
+#include "utils/MemoryModel.h"
+
+#include "../source/random_utils.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 64;
+constexpr size_t NUM_TAGS = 1000000;
+constexpr size_t NUM_PROGRAMS = 20000;
+
+using hw_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel,
+                                                 emp::BitSet<TAG_WIDTH>,
+                                                 int,
+                                                 emp::MatchBin< size_t,
+                                                                emp::HammingMetric<TAG_WIDTH>,
+                                                                emp::RankedSelector<>,
+                                                                emp::AdditiveCountdownRegulator<>
+                                                              >>;
+using program_t = typename hw_t::program_t;
+
+int main() {
+  sgp_bench::Reporter reporter("random_programs", SEED);
+  emp::Random random(SEED);
+
+  emp::vector<emp::BitSet<TAG_WIDTH>> tags(NUM_TAGS);
+  double secs = sgp_bench::TimeIt([&]() { for (auto & tag : tags) tag.Randomize(random); });
+  reporter.AddRate("BitSet::Randomize", NUM_TAGS, secs, "tags/sec");
+  secs = sgp_bench::TimeIt([&]() { for (auto & tag : tags) emp::RandomizeBitSet(random, tag); });
+  reporter.AddRate("RandomizeBitSet", NUM_TAGS, secs, "tags/sec");
+  secs = sgp_bench::TimeIt([&]() { tags = emp::RandomBitSets<TAG_WIDTH>(random, NUM_TAGS, true); });
+  reporter.AddRate("RandomBitSets/unique", NUM_TAGS, secs, "tags/sec");
+  sgp_bench::DoNotOptimize(tags);
+
+  typename hw_t::inst_lib_t inst_lib;
+  for (const std::string name : {"Nop", "Inc", "Dec", "Add", "Sub", "Call", "Return", "If", "While", "Close"}) {
+    inst_lib.AddInst(name, sgp::inst_impl::Inst_Nop<hw_t, typename hw_t::inst_t>, "");
+  }
+  emp::vector<program_t> programs;
+  secs = sgp_bench::TimeIt([&]() {
+    programs.clear();
+    for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+      programs.emplace_back(sgp::GenRandLinearFunctionsProgram<hw_t, TAG_WIDTH>(random, inst_lib, {1, 8}, 1, {1, 16}, 1, 3, {0, 15}));
+    }
+  });
+  reporter.AddRate("GenRandLinearFunctionsProgram", NUM_PROGRAMS, secs, "programs/sec");
+  secs = sgp_bench::TimeIt([&]() {
+    programs = sgp::GenRandLinearFunctionsPrograms<hw_t, TAG_WIDTH>(random, inst_lib, NUM_PROGRAMS, {1, 8}, 1, {1, 16}, 1, 3, {0, 15});
+  });
+  reporter.AddRate("GenRandLinearFunctionsPrograms", NUM_PROGRAMS, secs, "programs/sec");
+  sgp_bench::DoNotOptimize(programs);
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,99 @@
+// Benchmark: binary program serialization.
+// Writes a population of random LinearFunctionsPrograms with ProgramWriter, then reads it back
+// with ProgramReader (full deserialization), and with MappedProgramFile both decoding every
+// program and just visiting every instruction. Also reports file size per program next to the
+// size of the same programs printed as text (LinearFunctionsProgram::Print).
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearFunctionsProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/LinearFunctionsProgram.h"
+#include "utils/MemoryModel.h"
+#include "utils/ProgramSerialization.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 64;
+constexpr size_t NUM_PROGRAMS = 20000;
+
+using hw_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel,
+                                                 emp::BitSet<TAG_WIDTH>,
+                                                 int,
+                                                 emp::MatchBin< size_t,
+                                                                emp::HammingMetric<TAG_WIDTH>,
+                                                                emp::RankedSelector<>,
+                                                                emp::AdditiveCountdownRegulator<>
+                                                              >>;
+using program_t = typename hw_t::program_t;
+
+int main() {
+  namespace ser = sgp::serialization;
+  sgp_bench::Reporter reporter("serialization", SEED);
+  emp::Random random(SEED);
+  typename hw_t::inst_lib_t inst_lib;
+  for (const std::string name : {"Nop", "Inc", "Dec", "Add", "Sub", "Call", "Return", "If", "While", "Close"}) {
+    inst_lib.AddInst(name, sgp::inst_impl::Inst_Nop<hw_t, typename hw_t::inst_t>, "");
+  }
+  emp::vector<program_t> programs;
+  size_t num_insts = 0;
+  for (size_t i = 0; i < NUM_PROGRAMS; ++i) {
+    programs.emplace_back(sgp::GenRandLinearFunctionsProgram<hw_t, TAG_WIDTH>(random, inst_lib, {1, 8}, 1, {1, 16}, 1, 3, {0, 15}));
+    num_insts += programs.back().GetInstCount();
+  }
+
+  const std::string path = "bench_serialization.sgpb";
+  double secs = sgp_bench::TimeIt([&]() {
+    std::ofstream out(path, std::ios::binary);
+    ser::ProgramWriter<program_t> writer(out, inst_lib);
+    for (const program_t & program : programs) writer.Write(program);
+  });
+  reporter.AddRate("ProgramWriter/write", NUM_PROGRAMS, secs, "programs/sec");
+
+  size_t checksum = 0;
+  secs = sgp_bench::TimeIt([&]() {
+    std::ifstream in(path, std::ios::binary);
+    ser::ProgramReader<program_t> reader(in, inst_lib);
+    program_t program;
+    while (reader.Read(program)) checksum += program.GetSize();
+  });
+  reporter.AddRate("ProgramReader/read", NUM_PROGRAMS, secs, "programs/sec");
+
+  ser::MappedProgramFile<program_t> file;
+  secs = sgp_bench::TimeIt([&]() { file.Open(path, inst_lib); });
+  reporter.AddRate("MappedProgramFile/open", file.GetSize(), secs, "programs/sec");
+  secs = sgp_bench::TimeIt([&]() {
+    program_t program;
+    for (size_t i = 0; i < file.GetSize(); ++i) {
+      file.Decode(i, program);
+      checksum += program.GetSize();
+    }
+  });
+  reporter.AddRate("MappedProgramFile/decode", file.GetSize(), secs, "programs/sec");
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < file.GetSize(); ++i) {
+      file[i].ForEachInst([&checksum](const auto & inst) { checksum += inst.GetID() + inst.GetArg(0); });
+    }
+  });
+  reporter.AddRate("MappedProgramFile/visit", num_insts, secs, "insts/sec");
+  sgp_bench::DoNotOptimize(checksum);
+
+  size_t num_bytes = 0;
+  for (size_t i = 0; i < file.GetSize(); ++i) num_bytes += file[i].GetByteSize();
+  std::ostringstream text;
+  for (const program_t & program : programs) program.Print(text, inst_lib);
+  reporter.AddValue("binary/bytes-per-program", (double)num_bytes / NUM_PROGRAMS, "bytes");
+  reporter.AddValue("text/bytes-per-program", (double)text.str().size() / NUM_PROGRAMS, "bytes");
+  file.Close();
+  std::remove(path.c_str());
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Benchmark: forking evaluations from a shared warmed-up prefix.
+// Runs a random LinearProgramSignalGP program for a common development phase, then evaluates a
+// number of environment variations (each queues a different signal and runs for a while). Compares
+// re-running the development phase for every variation against restoring a snapshot taken at the
+// end of it (Snapshot/Restore), and reports the cost of Snapshot and Restore themselves.
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t PREFIX_STEPS = 10000;
+constexpr size_t VARIATION_STEPS = 1000;
+constexpr size_t NUM_VARIATIONS = 20;
+
+using hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel,
+                                        emp::BitSet<TAG_WIDTH>,
+                                        int,
+                                        emp::MatchBin< size_t,
+                                                       emp::HammingMetric<TAG_WIDTH>,
+                                                       emp::RankedSelector<>,
+                                                       emp::AdditiveCountdownRegulator<>
+                                                     >>;
+using inst_t = typename hw_t::inst_t;
+using inst_prop_t = typename hw_t::InstProperty;
+using event_t = typename hw_t::event_t;
+
+struct SignalEvent : public sgp::BaseEvent {
+  emp::BitSet<TAG_WIDTH> tag;
+  SignalEvent(size_t id, const emp::BitSet<TAG_WIDTH> & _tag) : BaseEvent(id), tag(_tag) { ; }
+};
+
+int main() {
+  sgp_bench::Reporter reporter("snapshot", SEED);
+  emp::Random random(SEED);
+  typename hw_t::inst_lib_t inst_lib;
+  typename hw_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<hw_t, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<hw_t, inst_t>, "");
+  inst_lib.AddInst("If", sgp::inst_impl::Inst_If<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("While", sgp::inst_impl::Inst_While<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<hw_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<hw_t, inst_t>, "");
+  inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<hw_t, inst_t>, "");
+  inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<hw_t, inst_t>, "");
+  inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<hw_t, inst_t>, "");
+  inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<hw_t, inst_t>, "");
+  const size_t signal_id = event_lib.AddEvent("Signal", [](hw_t & hw, const event_t & e) {
+    hw.SpawnThreadWithTag(static_cast<const SignalEvent &>(e).tag);
+  });
+
+  const auto program = sgp::GenRandLinearProgram<hw_t, TAG_WIDTH>(random, inst_lib, {64, 64}, 1, 3, {0, 7});
+  emp::vector<emp::BitSet<TAG_WIDTH>> variations;
+  for (size_t i = 0; i < NUM_VARIATIONS; ++i) variations.emplace_back(random);
+  hw_t hw(random, inst_lib, event_lib);
+
+  // Development phase: periodic signals from the environment.
+  auto develop = [&]() {
+    hw.SetProgram(program);
+    for (size_t step = 0; step < PREFIX_STEPS; ++step) {
+      if (step % 100 == 0) hw.QueueEvent(SignalEvent(signal_id, variations[0]));
+      hw.SingleProcess();
+    }
+  };
+  size_t checksum = 0;
+  auto evaluate = [&](size_t variation) {
+    hw.QueueEvent(SignalEvent(signal_id, variations[variation]));
+    hw.Process(VARIATION_STEPS);
+    checksum += hw.GetNumActiveThreads();
+  };
+
+  double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_VARIATIONS; ++i) {
+      develop();
+      evaluate(i);
+    }
+  });
+  reporter.AddCost("rerun-prefix/per-variation", NUM_VARIATIONS, secs, "ns/variation");
+
+  develop();
+  typename hw_t::snapshot_t snapshot = hw.Snapshot();
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_VARIATIONS; ++i) {
+      hw.Restore(snapshot);
+      evaluate(i);
+    }
+  });
+  reporter.AddCost("restore-snapshot/per-variation", NUM_VARIATIONS, secs, "ns/variation");
+
+  secs = sgp_bench::TimeIt([&]() { for (size_t i = 0; i < NUM_VARIATIONS; ++i) hw.Snapshot(snapshot); });
+  reporter.AddCost("Snapshot", NUM_VARIATIONS, secs, "ns/snapshot");
+  secs = sgp_bench::TimeIt([&]() { for (size_t i = 0; i < NUM_VARIATIONS; ++i) hw.Restore(snapshot); });
+  reporter.AddCost("Restore", NUM_VARIATIONS, secs, "ns/restore");
+  sgp_bench::DoNotOptimize(checksum);
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,112 @@
+// Benchmark: EventLibrary vs StaticEventLibrary.
+// Queues bursts of events onto ToySignalGP hardware (one with a runtime EventLibrary, one with a
+// StaticEventLibrary over the same event types) and measures how quickly SingleProcess hands them
+// to their handlers. Covers a small event, an event with a (non-trivially destructible) payload,
+// and a mix of three event types.
+
+#include <string>
+
+#include "impls/SignalGPToy.h"
+#include "StaticEventLibrary.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t BURST_SIZE = 256;
+constexpr size_t NUM_BURSTS = 20000;
+
+// Events for the runtime library (derived from BaseEvent, id set at runtime).
+struct ValueEvent : public sgp::BaseEvent {
+  size_t value;
+  ValueEvent(size_t id, size_t _value) : BaseEvent(id), value(_value) { ; }
+};
+struct MessageEvent : public sgp::BaseEvent {
+  std::string msg;
+  MessageEvent(size_t id, const std::string & _msg) : BaseEvent(id), msg(_msg) { ; }
+};
+struct FlagEvent : public sgp::BaseEvent {
+  bool flag;
+  FlagEvent(size_t id, bool _flag) : BaseEvent(id), flag(_flag) { ; }
+};
+
+// The same events for the static library.
+struct StaticValueEvent { size_t value; };
+struct StaticMessageEvent { std::string msg; };
+struct StaticFlagEvent { bool flag; };
+
+struct Handlers {
+  size_t * handled;
+  template<typename HW_T> void Handle(HW_T &, const StaticValueEvent & e) const { *handled += e.value; }
+  template<typename HW_T> void Handle(HW_T &, const StaticMessageEvent & e) const { *handled += e.msg.size(); }
+  template<typename HW_T> void Handle(HW_T &, const StaticFlagEvent & e) const { *handled += e.flag; }
+};
+
+using dynamic_hw_t = ToySignalGP<>;
+using static_lib_t = sgp::StaticEventLibrary<Handlers, StaticValueEvent, StaticMessageEvent, StaticFlagEvent>;
+using static_hw_t = ToySignalGP<sgp::DefaultCustomComponent, static_lib_t>;
+
+int main() {
+  sgp_bench::Reporter reporter("static_events", SEED);
+  size_t handled = 0;
+
+  using event_t = typename dynamic_hw_t::event_t;
+  typename dynamic_hw_t::event_lib_t dynamic_lib;
+  const size_t value_id = dynamic_lib.AddEvent("Value", [&handled](dynamic_hw_t &, const event_t & e) {
+    handled += static_cast<const ValueEvent &>(e).value;
+  });
+  const size_t msg_id = dynamic_lib.AddEvent("Message", [&handled](dynamic_hw_t &, const event_t & e) {
+    handled += static_cast<const MessageEvent &>(e).msg.size();
+  });
+  const size_t flag_id = dynamic_lib.AddEvent("Flag", [&handled](dynamic_hw_t &, const event_t & e) {
+    handled += static_cast<const FlagEvent &>(e).flag;
+  });
+  dynamic_hw_t dynamic_hw(dynamic_lib);
+  static_lib_t static_lib(Handlers{&handled});
+  static_hw_t static_hw(static_lib);
+
+  auto run = [&](const std::string & name, auto & hw, auto && queue_burst) {
+    handled = 0;
+    const double secs = sgp_bench::TimeIt([&]() {
+      for (size_t b = 0; b < NUM_BURSTS; ++b) {
+        queue_burst();
+        hw.SingleProcess();
+      }
+    });
+    sgp_bench::DoNotOptimize(handled);
+    reporter.AddRate(name, NUM_BURSTS * BURST_SIZE, secs, "events/sec");
+  };
+
+  run("EventLibrary/value", dynamic_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) dynamic_hw.QueueEvent(ValueEvent(value_id, i));
+  });
+  run("StaticEventLibrary/value", static_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) static_hw.QueueEvent(StaticValueEvent{i});
+  });
+  run("EventLibrary/message", dynamic_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) dynamic_hw.QueueEvent(MessageEvent(msg_id, "message"));
+  });
+  run("StaticEventLibrary/message", static_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) static_hw.QueueEvent(StaticMessageEvent{"message"});
+  });
+  run("EventLibrary/mixed", dynamic_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) {
+      switch (i % 3) {
+        case 0: dynamic_hw.QueueEvent(ValueEvent(value_id, i)); break;
+        case 1: dynamic_hw.QueueEvent(MessageEvent(msg_id, "message")); break;
+        default: dynamic_hw.QueueEvent(FlagEvent(flag_id, true)); break;
+      }
+    }
+  });
+  run("StaticEventLibrary/mixed", static_hw, [&]() {
+    for (size_t i = 0; i < BURST_SIZE; ++i) {
+      switch (i % 3) {
+        case 0: static_hw.QueueEvent(StaticValueEvent{i}); break;
+        case 1: static_hw.QueueEvent(StaticMessageEvent{"message"}); break;
+        default: static_hw.QueueEvent(StaticFlagEvent{true}); break;
+      }
+    }
+  });
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,173 @@
+// Benchmark: InstructionLibrary vs StaticInstructionLibrary.
+// Runs the same program on two LinearProgramSignalGPs: one whose instructions are dispatched
+// through InstructionLibrary's std::functions, and one that takes a StaticInstructionLibrary as its
+// library type (INST_LIB_T), so SingleExecutionStep switches on instruction IDs directly. Programs
+// are circular modules of Nops or of cheap memory/arithmetic instructions. Also times each library's
+// ProcessInst alone (on Nops), outside of the hardware's execution loop. Each timing is the best of
+// NUM_REPS runs.
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+
+#include "impls/SignalGPLinearProgram.h"
+#include "utils/InstructionLibrary.h"
+#include "utils/linear_program_instructions_impls.h"
+#include "utils/MemoryModel.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t TAG_WIDTH = 16;
+constexpr size_t PROGRAM_SIZE = 64;
+constexpr size_t NUM_STEPS = 200000;
+constexpr size_t NUM_REPS = 5;
+
+using matchbin_t = emp::MatchBin< size_t,
+                                  emp::HammingMetric<TAG_WIDTH>,
+                                  emp::RankedSelector<>,
+                                  emp::AdditiveCountdownRegulator<>
+                                >;
+
+template<typename HW, typename INST, typename PROP>
+using static_inst_lib_t =
+  sgp::StaticInstructionLibrary<HW, INST, PROP,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Nop<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Inc<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Dec<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Not<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Add<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Sub<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Mult<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_TestEqu<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_TestLess<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_SetMem<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_CopyMem<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_SwapMem<HW, INST>>
+                                >;
+
+using dynamic_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+using static_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t,
+                                               sgp::DefaultCustomComponent, sgp::NoInstrumentation, void,
+                                               static_inst_lib_t>;
+
+const emp::vector<std::string> INST_NAMES = {"Nop", "Inc", "Dec", "Not", "Add", "Sub", "Mult",
+                                             "TestEqu", "TestLess", "SetMem", "CopyMem", "SwapMem"};
+
+void AddDynamicInsts(typename dynamic_hw_t::inst_lib_t & inst_lib) {
+  using hw_t = dynamic_hw_t;
+  using inst_t = typename hw_t::inst_t;
+  inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<hw_t, inst_t>, "");
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<hw_t, inst_t>, "");
+  inst_lib.AddInst("Not", sgp::inst_impl::Inst_Not<hw_t, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<hw_t, inst_t>, "");
+  inst_lib.AddInst("Sub", sgp::inst_impl::Inst_Sub<hw_t, inst_t>, "");
+  inst_lib.AddInst("Mult", sgp::inst_impl::Inst_Mult<hw_t, inst_t>, "");
+  inst_lib.AddInst("TestEqu", sgp::inst_impl::Inst_TestEqu<hw_t, inst_t>, "");
+  inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<hw_t, inst_t>, "");
+  inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<hw_t, inst_t>, "");
+  inst_lib.AddInst("CopyMem", sgp::inst_impl::Inst_CopyMem<hw_t, inst_t>, "");
+  inst_lib.AddInst("SwapMem", sgp::inst_impl::Inst_SwapMem<hw_t, inst_t>, "");
+}
+
+/// Run the given program on hw with num_threads threads; returns seconds taken for NUM_STEPS steps.
+template<typename HW_T>
+double RunOnce(HW_T & hw, const typename HW_T::program_t & program, size_t num_threads) {
+  hw.Reset();
+  hw.SetProgram(program);
+  for (size_t i = 0; i < num_threads; ++i) hw.SpawnThreadWithID(0, 1.0);
+  // Threads run circular modules so that they never finish.
+  hw.SingleProcess();
+  for (size_t thread_id : hw.GetActiveThreadIDs()) {
+    hw.GetThread(thread_id).GetExecState().GetTopCallState().circular = true;
+  }
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_STEPS; ++i) hw.SingleProcess();
+  });
+  sgp_bench::DoNotOptimize(hw.GetMemoryModel());
+  return secs;
+}
+
+/// Best of NUM_REPS runs of each hardware (alternating, so both see the same machine conditions).
+template<typename DYNAMIC_HW_T, typename STATIC_HW_T>
+std::pair<double, double> Run(DYNAMIC_HW_T & dynamic_hw, STATIC_HW_T & static_hw,
+                              const typename DYNAMIC_HW_T::program_t & program, size_t num_threads) {
+  double dynamic_secs = RunOnce(dynamic_hw, program, num_threads);
+  double static_secs = RunOnce(static_hw, program, num_threads);
+  for (size_t rep = 1; rep < NUM_REPS; ++rep) {
+    dynamic_secs = std::min(dynamic_secs, RunOnce(dynamic_hw, program, num_threads));
+    static_secs = std::min(static_secs, RunOnce(static_hw, program, num_threads));
+  }
+  return {dynamic_secs, static_secs};
+}
+
+int main() {
+  sgp_bench::Reporter reporter("static_instructions", SEED);
+  emp::Random random(SEED);
+
+  using dynamic_inst_t = typename dynamic_hw_t::inst_t;
+  using static_inst_t = typename static_hw_t::inst_t;
+  typename dynamic_hw_t::inst_lib_t dynamic_lib;
+  AddDynamicInsts(dynamic_lib);
+  dynamic_lib.AddInst("ModuleDef", [](dynamic_hw_t &, const dynamic_inst_t &) { ; }, "",
+                      {dynamic_hw_t::InstProperty::MODULE});
+  typename static_hw_t::inst_lib_t static_lib({
+    {"Nop"}, {"Inc"}, {"Dec"}, {"Not"}, {"Add"}, {"Sub"}, {"Mult"},
+    {"TestEqu"}, {"TestLess"}, {"SetMem"}, {"CopyMem"}, {"SwapMem"}
+  });
+  static_lib.AddInst("ModuleDef", [](static_hw_t &, const static_inst_t &) { ; }, "",
+                     {static_hw_t::InstProperty::MODULE});
+  typename dynamic_hw_t::event_lib_t dynamic_event_lib;
+  typename static_hw_t::event_lib_t static_event_lib;
+
+  // Both libraries use the same IDs, so they can run the same programs.
+  typename dynamic_hw_t::program_t nop_program;
+  typename dynamic_hw_t::program_t mixed_program;
+  nop_program.PushInst(dynamic_lib, "ModuleDef", {0, 0, 0}, {emp::BitSet<TAG_WIDTH>(random)});
+  mixed_program.PushInst(dynamic_lib, "ModuleDef", {0, 0, 0}, {emp::BitSet<TAG_WIDTH>(random)});
+  for (size_t i = 0; i < PROGRAM_SIZE; ++i) {
+    nop_program.PushInst(dynamic_lib, "Nop", {0, 0, 0});
+    mixed_program.PushInst(dynamic_lib, INST_NAMES[random.GetUInt(INST_NAMES.size())],
+                           {random.GetInt(0, 8), random.GetInt(0, 8), random.GetInt(0, 8)});
+  }
+
+  dynamic_hw_t dynamic_hw(random, dynamic_lib, dynamic_event_lib);
+  static_hw_t static_hw(random, static_lib, static_event_lib);
+  for (const auto & [name, program] : {std::make_pair(std::string("nop"), nop_program),
+                                       std::make_pair(std::string("mixed"), mixed_program)}) {
+    for (size_t num_threads : {1, 16}) {
+      const std::string suffix = "/" + name + "/threads" + std::to_string(num_threads);
+      const auto [dynamic_secs, static_secs] = Run(dynamic_hw, static_hw, program, num_threads);
+      reporter.AddRate("InstructionLibrary" + suffix, NUM_STEPS * num_threads, dynamic_secs, "insts/sec");
+      reporter.AddRate("StaticInstructionLibrary" + suffix, NUM_STEPS * num_threads, static_secs, "insts/sec");
+      reporter.AddValue("speedup" + suffix, dynamic_secs / static_secs, "x");
+    }
+  }
+
+  // Dispatch alone: call each library's ProcessInst on the packed Nop program directly.
+  dynamic_hw.SetProgram(nop_program);
+  static_hw.SetProgram(nop_program);
+  auto time_dispatch = [](auto & hw, const auto & inst_lib) {
+    const auto & packed = hw.GetPackedProgram();
+    double best = 0.0;
+    for (size_t rep = 0; rep < NUM_REPS; ++rep) {
+      const double secs = sgp_bench::TimeIt([&]() {
+        for (size_t i = 0; i < NUM_STEPS; ++i) inst_lib.ProcessInst(hw, packed[1 + i % PROGRAM_SIZE]);
+      });
+      best = rep ? std::min(best, secs) : secs;
+    }
+    return best;
+  };
+  const double dynamic_secs = time_dispatch(dynamic_hw, dynamic_lib);
+  const double static_secs = time_dispatch(static_hw, static_lib);
+  reporter.AddCost("InstructionLibrary/ProcessInst", NUM_STEPS, dynamic_secs, "ns/inst");
+  reporter.AddCost("StaticInstructionLibrary/ProcessInst", NUM_STEPS, static_secs, "ns/inst");
+  reporter.AddValue("speedup/ProcessInst", dynamic_secs / static_secs, "x");
+
+  reporter.Print();
+  return 0;
+}
@@ -0,0 +1,82 @@
+// Benchmark: thread spawning and activation under thread-cap pressure.
+// Uses the toy SignalGP implementation (whose threads just count down) so that timings are
+// dominated by SignalGPBase's thread management. Every step, more threads are requested (via
+// SpawnThreadWithID) than there is room to run, so SpawnThreadWithID has to commandeer pending
+// threads and ActivatePendingThreads has to decide which pending threads replace active ones.
+// Also measures per-step scheduling overhead for a few long-running threads under different
+// thread quanta (execution steps per thread per SingleProcess).
+
+#include "tools/Random.h"
+
+#include "impls/SignalGPToy.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t NUM_STEPS = 20000;
+constexpr size_t MAX_ACTIVE_THREADS = 32;
+constexpr size_t THREAD_CAPACITY = 128;
+
+using signalgp_t = ToySignalGP<>;
+
+/// Spawn spawns_per_step threads (with random priorities) per step for NUM_STEPS steps.
+void Run(sgp_bench::Reporter & reporter, const std::string & name, emp::Random & random,
+         bool use_priority, size_t spawns_per_step) {
+  typename signalgp_t::event_lib_t event_lib;
+  signalgp_t hw(event_lib);
+  hw.SetThreadPriorityUse(use_priority);
+  hw.SetActiveThreadLimit(MAX_ACTIVE_THREADS);
+  hw.SetThreadCapacity(THREAD_CAPACITY);
+  // Modules are countdowns of varying length, so threads die at different times.
+  emp::vector<size_t> program;
+  for (size_t i = 0; i < 16; ++i) program.emplace_back(random.GetUInt(8, 64));
+  hw.SetProgram(program);
+  // Pre-generate spawn requests so random number generation isn't timed.
+  emp::vector<std::pair<size_t, double>> requests(NUM_STEPS * spawns_per_step);
+  for (auto & request : requests) request = {random.GetUInt(program.size()), random.GetDouble(0.0, 10.0)};
+
+  size_t spawned = 0;
+  double spawn_secs = 0.0;
+  double process_secs = 0.0;
+  for (size_t step = 0; step < NUM_STEPS; ++step) {
+    spawn_secs += sgp_bench::TimeIt([&]() {
+      for (size_t i = 0; i < spawns_per_step; ++i) {
+        const auto & request = requests[step * spawns_per_step + i];
+        spawned += (size_t)hw.SpawnThreadWithID(request.first, request.second).has_value();
+      }
+    });
+    process_secs += sgp_bench::TimeIt([&]() { hw.SingleProcess(); });
+  }
+  reporter.AddCost(name + "/SpawnThreadWithID", NUM_STEPS * spawns_per_step, spawn_secs, "ns/spawn");
+  reporter.AddCost(name + "/SingleProcess", NUM_STEPS, process_secs, "ns/step");
+  reporter.AddValue(name + "/spawn_success_rate", (double)spawned / (double)(NUM_STEPS * spawns_per_step), "fraction");
+}
+
+/// Run num_threads long-lived threads for NUM_STEPS total execution steps each with the given quantum.
+void RunQuantum(sgp_bench::Reporter & reporter, size_t num_threads, size_t quantum) {
+  typename signalgp_t::event_lib_t event_lib;
+  signalgp_t hw(event_lib);
+  hw.SetThreadQuantum(quantum);
+  hw.SetProgram({NUM_STEPS});
+  for (size_t i = 0; i < num_threads; ++i) hw.SpawnThreadWithID(0);
+  const double secs = sgp_bench::TimeIt([&]() {
+    for (size_t step = 0; step < NUM_STEPS; step += quantum) hw.SingleProcess();
+  });
+  reporter.AddCost("quantum" + std::to_string(quantum) + "/threads" + std::to_string(num_threads),
+                   NUM_STEPS * num_threads, secs, "ns/thread-step");
+}
+
+int main() {
+  sgp_bench::Reporter reporter("thread_management", SEED);
+  emp::Random random(SEED);
+  // Some pressure (pending threads compete for open slots) and heavy pressure (thread space is full).
+  Run(reporter, "priority/spawn8", random, true, 8);
+  Run(reporter, "priority/spawn160", random, true, 160);
+  Run(reporter, "no_priority/spawn8", random, false, 8);
+  Run(reporter, "no_priority/spawn160", random, false, 160);
+  for (size_t num_threads : {1, 4}) {
+    for (size_t quantum : {1, 16, 256}) RunQuantum(reporter, num_threads, quantum);
+  }
+  reporter.Print();
+  return 0;
+}
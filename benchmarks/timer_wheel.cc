@@ -0,0 +1,100 @@
+// Benchmark: delayed event scheduling.
+// Schedules NUM_EVENTS events with random delays on one ToySignalGP and runs it until every event
+// has been handled, comparing the hardware's timer wheel (ScheduleEvent) with scheduling from an
+// outer loop using a std::priority_queue of due steps (QueueEvent when due). Also measures
+// repeating events, and the cost of a SingleProcess step with nothing scheduled.
+
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "tools/Random.h"
+
+#include "impls/SignalGPToy.h"
+
+#include "bench_utils.h"
+
+constexpr int SEED = 1;
+constexpr size_t NUM_EVENTS = 1000000;
+constexpr size_t MAX_DELAY = 100000;
+constexpr size_t NUM_REPEATING = 10000;
+constexpr size_t NUM_STEPS = 1000000;
+
+using hw_t = ToySignalGP<>;
+
+struct TimedEvent : public sgp::BaseEvent {
+  size_t value;
+  TimedEvent(size_t id, size_t _value) : BaseEvent(id), value(_value) { ; }
+};
+
+int main() {
+  sgp_bench::Reporter reporter("timer_wheel", SEED);
+  emp::Random random(SEED);
+  typename hw_t::event_lib_t event_lib;
+  size_t handled = 0;
+  const size_t event_id = event_lib.AddEvent("Timed", [&handled](hw_t & hw, const sgp::BaseEvent & e) {
+    handled += static_cast<const TimedEvent &>(e).value;
+  });
+  emp::vector<size_t> delays(NUM_EVENTS);
+  for (size_t & delay : delays) delay = random.GetUInt(MAX_DELAY);
+
+  // Timer wheel.
+  hw_t hw(event_lib);
+  double secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_EVENTS; ++i) hw.ScheduleEvent(TimedEvent(event_id, 1), delays[i]);
+  });
+  reporter.AddCost("ScheduleEvent/schedule", NUM_EVENTS, secs, "ns/event");
+  handled = 0;
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t step = 0; step < MAX_DELAY; ++step) hw.SingleProcess();
+  });
+  sgp_bench::DoNotOptimize(handled);
+  reporter.AddCost("ScheduleEvent/deliver", NUM_EVENTS, secs, "ns/event");
+
+  // Outer-loop scheduling with a priority queue.
+  hw_t hw_pq(event_lib);
+  using due_t = std::pair<size_t, size_t>; // (due step, event index)
+  std::priority_queue<due_t, std::vector<due_t>, std::greater<due_t>> pq;
+  emp::vector<TimedEvent> pending;
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t i = 0; i < NUM_EVENTS; ++i) {
+      pending.emplace_back(event_id, 1);
+      pq.emplace(delays[i], i);
+    }
+  });
+  reporter.AddCost("priority_queue/schedule", NUM_EVENTS, secs, "ns/event");
+  handled = 0;
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t step = 0; step < MAX_DELAY; ++step) {
+      while (pq.size() && pq.top().first == step) {
+        hw_pq.QueueEvent(pending[pq.top().second]);
+        pq.pop();
+      }
+      hw_pq.SingleProcess();
+    }
+  });
+  sgp_bench::DoNotOptimize(handled);
+  reporter.AddCost("priority_queue/deliver", NUM_EVENTS, secs, "ns/event");
+
+  // Repeating events.
+  hw_t hw_rep(event_lib);
+  for (size_t i = 0; i < NUM_REPEATING; ++i) {
+    hw_rep.ScheduleRepeatingEvent(TimedEvent(event_id, 1), 1 + random.GetUInt(1000), random.GetUInt(1000));
+  }
+  handled = 0;
+  secs = sgp_bench::TimeIt([&]() {
+    for (size_t step = 0; step < MAX_DELAY; ++step) hw_rep.SingleProcess();
+  });
+  sgp_bench::DoNotOptimize(handled);
+  reporter.AddCost("ScheduleRepeatingEvent/deliver", handled, secs, "ns/event");
+
+  // Idle steps, with and without a (now empty) timer wheel.
+  hw_t hw_idle(event_lib);
+  secs = sgp_bench::TimeIt([&]() { for (size_t step = 0; step < NUM_STEPS; ++step) hw_idle.SingleProcess(); });
+  reporter.AddCost("idle/no-wheel", NUM_STEPS, secs, "ns/step");
+  secs = sgp_bench::TimeIt([&]() { for (size_t step = 0; step < NUM_STEPS; ++step) hw.SingleProcess(); });
+  reporter.AddCost("idle/empty-wheel", NUM_STEPS, secs, "ns/step");
+
+  reporter.Print();
+  return 0;
+}
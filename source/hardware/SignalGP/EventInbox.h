@@ -0,0 +1,256 @@
+#ifndef EMP_SIGNALGP_EVENT_INBOX_H
+#define EMP_SIGNALGP_EVENT_INBOX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "base/assert.h"
+
+#include "EventLibrary.h"
+#include "EventQueue.h"
+
+namespace sgp {
+
+  /// Bounded, lock-free, multi-producer/single-consumer inbox of (polymorphic) events, for
+  /// delivering events to hardware from other threads.
+  /// - Any number of threads may Push/TryPush concurrently. Producers never take a lock; a producer
+  ///   only waits if the inbox is full and the inbox's FullPolicy is WAIT.
+  /// - One thread (the thread running the hardware) drains the inbox into an EventQueue (DrainInto).
+  ///   Draining never waits: events that are still being written by a producer are left for the
+  ///   next drain (as is everything pushed after them, so events drain in the order they were
+  ///   pushed).
+  /// - Events are copied into fixed-size slots (SLOT_SIZE bytes), so pushing never allocates.
+  ///   Events may be any type derived from EVENT_BASE_T that fits in a slot.
+  /// - Events drain into an EVENT_QUEUE_T (by default, EventQueue<EVENT_BASE_T>).
+  /// - Counters (pushed, dropped, waits, drained) can be read from any thread.
+  /// - Copying an inbox makes an empty inbox with the same capacity and policy. Copying, moving, and
+  ///   destroying an inbox are not thread-safe (producers must be done with it).
+  template<typename EVENT_BASE_T=BaseEvent, size_t SLOT_SIZE=128, typename EVENT_QUEUE_T=EventQueue<EVENT_BASE_T>>
+  class EventInbox {
+  public:
+    using event_t = EVENT_BASE_T;
+    using event_queue_t = EVENT_QUEUE_T;
+
+    /// What should Push do if the inbox is full?
+    enum class FullPolicy {
+      DROP,   ///< Drop the event (counted by GetNumDropped).
+      WAIT    ///< Wait (yielding) until the consumer makes room (counted by GetNumWaits).
+    };
+
+  protected:
+    /// Per-event-type operations.
+    struct EventOps {
+      void (*destroy)(event_t *);                        ///< nullptr if trivially destructible.
+      void (*push_copy)(event_queue_t &, const event_t &); ///< Push a copy of event onto given queue.
+    };
+
+    template<typename EVENT_T>
+    struct TypedOps {
+      static void Destroy(event_t * event) { static_cast<EVENT_T *>(event)->~EVENT_T(); }
+      static void PushCopy(event_queue_t & queue, const event_t & event) {
+        queue.Push(static_cast<const EVENT_T &>(event));
+      }
+      static constexpr EventOps ops = {std::is_trivially_destructible<EVENT_T>::value ? nullptr : &Destroy,
+                                       &PushCopy};
+    };
+
+    /// A slot is free for the producer claiming position pos when sequence == pos, and holds a
+    /// published event for the consumer at position pos when sequence == pos + 1.
+    struct Slot {
+      std::atomic<size_t> sequence;
+      const EventOps * ops;
+      event_t * event;
+      alignas(std::max_align_t) unsigned char data[SLOT_SIZE];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity;
+    size_t mask;
+    FullPolicy policy;
+
+    alignas(64) std::atomic<size_t> tail;   ///< Next position for producers to claim.
+    alignas(64) size_t head=0;              ///< Next position to drain (consumer only).
+    std::atomic<size_t> num_drained;
+    alignas(64) std::atomic<size_t> num_pushed;
+    std::atomic<size_t> num_dropped;
+    std::atomic<size_t> num_waits;
+
+    static size_t RoundCapacity(size_t n) {
+      size_t cap = 2;
+      while (cap < n) cap <<= 1;
+      return cap;
+    }
+
+    void InitSlots() {
+      slots.reset(new Slot[capacity]);
+      for (size_t i = 0; i < capacity; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /// Destroy all published, undrained events (no producers may be active).
+    void DestroyLive() {
+      if (!slots) return;
+      for (size_t pos = head; ; ++pos) {
+        Slot & slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+        if (slot.ops->destroy) slot.ops->destroy(slot.event);
+        slot.sequence.store(pos + capacity, std::memory_order_relaxed);
+      }
+    }
+
+  public:
+    /// Make an inbox that holds up to capacity events (rounded up to a power of two).
+    EventInbox(size_t _capacity=1024, FullPolicy _policy=FullPolicy::DROP)
+      : slots(), capacity(RoundCapacity(_capacity)), mask(capacity - 1), policy(_policy),
+        tail(0), num_drained(0), num_pushed(0), num_dropped(0), num_waits(0)
+    {
+      InitSlots();
+    }
+
+    EventInbox(const EventInbox & other) : EventInbox(other.capacity, other.policy) { ; }
+
+    EventInbox(EventInbox && other)
+      : slots(std::move(other.slots)), capacity(other.capacity), mask(other.mask), policy(other.policy),
+        tail(other.tail.load()), head(other.head), num_drained(other.num_drained.load()),
+        num_pushed(other.num_pushed.load()), num_dropped(other.num_dropped.load()),
+        num_waits(other.num_waits.load())
+    {
+      other.InitSlots();
+      other.tail.store(0);
+      other.head = 0;
+    }
+
+    ~EventInbox() { DestroyLive(); }
+
+    EventInbox & operator=(const EventInbox & other) {
+      if (this == &other) return *this;
+      DestroyLive();
+      capacity = other.capacity;
+      mask = other.mask;
+      policy = other.policy;
+      InitSlots();
+      tail.store(0);
+      head = 0;
+      ResetCounters();
+      return *this;
+    }
+
+    EventInbox & operator=(EventInbox && other) {
+      if (this == &other) return *this;
+      DestroyLive();
+      slots = std::move(other.slots);
+      capacity = other.capacity;
+      mask = other.mask;
+      policy = other.policy;
+      tail.store(other.tail.load());
+      head = other.head;
+      num_drained.store(other.num_drained.load());
+      num_pushed.store(other.num_pushed.load());
+      num_dropped.store(other.num_dropped.load());
+      num_waits.store(other.num_waits.load());
+      other.InitSlots();
+      other.tail.store(0);
+      other.head = 0;
+      return *this;
+    }
+
+    /// Maximum number of events the inbox can hold.
+    size_t GetCapacity() const { return capacity; }
+
+    FullPolicy GetFullPolicy() const { return policy; }
+
+    /// Number of events pushed into the inbox.
+    size_t GetNumPushed() const { return num_pushed.load(std::memory_order_relaxed); }
+
+    /// Number of events dropped because the inbox was full (FullPolicy::DROP).
+    size_t GetNumDropped() const { return num_dropped.load(std::memory_order_relaxed); }
+
+    /// Number of pushes that had to wait for room (FullPolicy::WAIT).
+    size_t GetNumWaits() const { return num_waits.load(std::memory_order_relaxed); }
+
+    /// Number of events drained out of the inbox.
+    size_t GetNumDrained() const { return num_drained.load(std::memory_order_relaxed); }
+
+    /// Approximate number of events in the inbox (exact if no producers are active).
+    size_t GetSize() const { return GetNumPushed() - GetNumDrained(); }
+
+    /// Zero the counters.
+    void ResetCounters() {
+      num_drained.store(0);
+      num_pushed.store(0);
+      num_dropped.store(0);
+      num_waits.store(0);
+    }
+
+    /// Push a copy of the given event if there's room; never waits.
+    /// @return Whether the event was pushed. (Failed pushes are not counted as dropped.)
+    template<typename EVENT_T>
+    bool TryPush(const EVENT_T & event) {
+      static_assert(std::is_base_of<event_t, EVENT_T>::value, "Events must be derived from the inbox's event type.");
+      static_assert(sizeof(EVENT_T) <= SLOT_SIZE, "Event is too large for the inbox's slots (see SLOT_SIZE).");
+      static_assert(alignof(EVENT_T) <= alignof(std::max_align_t), "Over-aligned events are not supported.");
+      size_t pos = tail.load(std::memory_order_relaxed);
+      while (true) {
+        Slot & slot = slots[pos & mask];
+        const size_t seq = slot.sequence.load(std::memory_order_acquire);
+        const std::intptr_t diff = (std::intptr_t)seq - (std::intptr_t)pos;
+        if (diff == 0) {
+          // Slot is free; try to claim it.
+          if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            slot.event = static_cast<event_t *>(new (slot.data) EVENT_T(event));
+            slot.ops = &TypedOps<EVENT_T>::ops;
+            slot.sequence.store(pos + 1, std::memory_order_release);
+            num_pushed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+          }
+          // (compare_exchange_weak updated pos.)
+        } else if (diff < 0) {
+          return false; // Full: slot still holds an event from the previous lap.
+        } else {
+          pos = tail.load(std::memory_order_relaxed); // Another producer claimed pos.
+        }
+      }
+    }
+
+    /// Push a copy of the given event. If the inbox is full, either drop the event or wait for room
+    /// (according to the inbox's FullPolicy).
+    /// @return Whether the event was pushed.
+    template<typename EVENT_T>
+    bool Push(const EVENT_T & event) {
+      if (TryPush(event)) return true;
+      if (policy == FullPolicy::DROP) {
+        num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      num_waits.fetch_add(1, std::memory_order_relaxed);
+      while (!TryPush(event)) std::this_thread::yield();
+      return true;
+    }
+
+    /// Move up to max_events published events (in order) from the inbox onto the back of the given
+    /// queue. Consumer only; never waits.
+    /// @return Number of events moved.
+    size_t DrainInto(event_queue_t & queue, size_t max_events=(size_t)-1) {
+      size_t count = 0;
+      while (count < max_events) {
+        Slot & slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;
+        slot.ops->push_copy(queue, *slot.event);
+        if (slot.ops->destroy) slot.ops->destroy(slot.event);
+        slot.sequence.store(head + capacity, std::memory_order_release); // Free slot for next lap.
+        ++head;
+        ++count;
+      }
+      if (count) num_drained.fetch_add(count, std::memory_order_relaxed);
+      return count;
+    }
+  };
+
+}
+
+#endif
@@ -37,11 +37,15 @@ namespace sgp {
     }
   };
 
+  template<typename EVENT_BASE_T=BaseEvent, size_t BLOCK_SIZE=4096> class EventQueue; // (EventQueue.h)
+  template<typename EVENT_T> class SharedEvent; // (EventQueue.h)
+
   template<typename HARDWARE_T>
   class EventLibrary {
   public:
     using hardware_t = HARDWARE_T;
     using event_t = BaseEvent;
+    using event_queue_t = EventQueue<event_t>;   ///< Queue hardware uses for these events.
     using event_handler_fun_t = std::function<void(hardware_t &, const event_t &)>;     ///< Type alias for event-handler functions.
     using event_dispatcher_fun_t = std::function<void(hardware_t &, const event_t &)>;  ///< Type alias for event-dispatcher functions.
     using event_dispatcher_set_t = emp::FunctionSet<void(hardware_t &, const event_t &)>;    ///< Type alias for dispatcher function set type.
@@ -79,6 +83,13 @@ namespace sgp {
     /// Get the string name of the specified event definition.
     const std::string & GetName(size_t id) const { return event_lib[id].name; }
 
+    /// Get the event ID of the given event.
+    template<typename EVENT_T>
+    static size_t GetEventID(const EVENT_T & event) { return event.GetID(); }
+
+    /// Print the given event (default event printing for hardware).
+    static void PrintEvent(const event_t & event, std::ostream & os) { event.Print(os); }
+
     /// Get the event ID of the event given by string name.
     size_t GetID(const std::string & name) const {
       emp_assert(emp::Has(name_map, name), name);
@@ -124,6 +135,16 @@ namespace sgp {
       event_lib[event.GetID()].dispatch_funs.Run(hw, event);
     }
 
+    /// Queue one event on many hardware units: recipients is any range of pointers to hardware
+    /// (e.g., emp::vector<hardware_t*>). The event is copied once and every recipient queues a
+    /// reference to that copy (see SharedEvent), so the cost per recipient is a queue entry and a
+    /// (non-atomic) reference count increment. All recipients must be run from the same thread.
+    template<typename HW_PTR_RANGE_T, typename EVENT_T>
+    void BroadcastEvent(const HW_PTR_RANGE_T & recipients, const EVENT_T & event) const {
+      const SharedEvent<EVENT_T> shared_event(event);
+      for (auto && hw : recipients) hw->QueueEvent(shared_event);
+    }
+
     /// Handle an event.
     template<typename EVENT_T>
     void HandleEvent(hardware_t & hw, const EVENT_T & event) const {
@@ -0,0 +1,283 @@
+#ifndef EMP_SIGNALGP_EVENT_QUEUE_H
+#define EMP_SIGNALGP_EVENT_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+#include "EventLibrary.h"
+
+namespace sgp {
+
+  /// Handle to one immutable event shared by any number of event queues (e.g., an event broadcast
+  /// to many hardware units; see EventLibrary::BroadcastEvent).
+  /// - The event is copied once (into a single heap allocation) when the handle is made. Queueing
+  ///   a SharedEvent (EventQueue::Push / QueueEvent) queues a reference to it rather than a copy,
+  ///   and the event is freed once no handles or queues refer to it.
+  /// - Reference counts are intrusive and NOT atomic: handles and every queue holding the event must
+  ///   all be used from one thread at a time.
+  template<typename EVENT_T>
+  class SharedEvent {
+  protected:
+    template<typename, size_t> friend class EventQueue;
+
+    /// Shared event + its reference count.
+    struct Node final : public EVENT_T {
+      size_t ref_count;
+      Node(const EVENT_T & event) : EVENT_T(event), ref_count(0) { ; }
+    };
+
+    Node * node;
+
+    static void AddRef(Node * n) { ++n->ref_count; }
+    static void Release(Node * n) {
+      emp_assert(n->ref_count);
+      if (--n->ref_count == 0) delete n;
+    }
+
+  public:
+    SharedEvent(const EVENT_T & event) : node(new Node(event)) { AddRef(node); }
+    SharedEvent(const SharedEvent & other) : node(other.node) { AddRef(node); }
+    SharedEvent & operator=(const SharedEvent & other) {
+      AddRef(other.node);
+      Release(node);
+      node = other.node;
+      return *this;
+    }
+    ~SharedEvent() { Release(node); }
+
+    const EVENT_T & Get() const { return *node; }
+    const EVENT_T & operator*() const { return *node; }
+    const EVENT_T * operator->() const { return node; }
+
+    /// How many handles and queued references refer to this event?
+    size_t GetRefCount() const { return node->ref_count; }
+  };
+
+  /// FIFO queue of (polymorphic) events that stores events inline in an arena owned by the queue.
+  /// - Queued events are copied into blocks of memory (doubling in size up to BLOCK_SIZE bytes);
+  ///   blocks are kept and reused, so once the arena has grown to fit the largest burst of events,
+  ///   queueing never allocates.
+  /// - Whenever the queue empties, the arena is rewound in O(1).
+  /// - Events may be any type derived from EVENT_BASE_T (e.g., BaseEvent); each queued event
+  ///   remembers how to destroy/copy itself as its own type (BaseEvent has no virtual destructor).
+  /// - Queued events never move, so references returned by Front remain valid until popped, even
+  ///   if more events are pushed in the meantime.
+  /// - A SharedEvent is queued by reference (no copy), so the same event can be queued on many
+  ///   queues cheaply.
+  /// (Declared in EventLibrary.h with defaults EVENT_BASE_T=BaseEvent, BLOCK_SIZE=4096.)
+  template<typename EVENT_BASE_T, size_t BLOCK_SIZE>
+  class EventQueue {
+  public:
+    using event_t = EVENT_BASE_T;
+    static constexpr size_t FIRST_BLOCK_SIZE = 256;  ///< Size (bytes) of the arena's first block.
+
+  protected:
+    /// Per-event-type operations.
+    struct EventOps {
+      void (*destroy)(event_t *);                          ///< nullptr if trivially destructible.
+      void (*push_copy)(EventQueue &, const event_t &);    ///< Push a copy of event onto given queue.
+    };
+
+    template<typename EVENT_T>
+    struct TypedOps {
+      static void Destroy(event_t * event) { static_cast<EVENT_T *>(event)->~EVENT_T(); }
+      static void PushCopy(EventQueue & queue, const event_t & event) {
+        queue.Push(static_cast<const EVENT_T &>(event));
+      }
+      static constexpr EventOps ops = {std::is_trivially_destructible<EVENT_T>::value ? nullptr : &Destroy,
+                                       &PushCopy};
+    };
+
+    struct Entry {
+      event_t * event;
+      const EventOps * ops;
+    };
+
+    /// Operations for queued references to a SharedEvent<EVENT_T>.
+    template<typename EVENT_T>
+    struct SharedOps {
+      using node_t = typename SharedEvent<EVENT_T>::Node;
+      static node_t * GetNode(const event_t & event) {
+        return static_cast<node_t *>(const_cast<EVENT_T *>(static_cast<const EVENT_T *>(&event)));
+      }
+      static void Release(event_t * event) { SharedEvent<EVENT_T>::Release(GetNode(*event)); }
+      static void PushCopy(EventQueue & queue, const event_t & event) { queue.PushNode<EVENT_T>(GetNode(event)); }
+      static constexpr EventOps ops = {&Release, &PushCopy};
+    };
+
+    /// Queue a reference to a shared event.
+    template<typename EVENT_T>
+    void PushNode(typename SharedEvent<EVENT_T>::Node * node) {
+      SharedEvent<EVENT_T>::AddRef(node);
+      entries.emplace_back(Entry{static_cast<event_t *>(static_cast<EVENT_T *>(node)), &SharedOps<EVENT_T>::ops});
+    }
+
+    struct Block {
+      std::unique_ptr<unsigned char[]> data;
+      size_t size;
+    };
+
+    emp::vector<Block> blocks;    ///< Arena memory. Never shrinks.
+    size_t cur_block=0;           ///< Block we're currently allocating from.
+    size_t cur_offset=0;          ///< Next free byte in current block.
+    emp::vector<Entry> entries;   ///< Queued events (in order); [head, entries.size()) are live.
+    size_t head=0;                ///< Position of front of the queue in entries.
+
+    /// Get (aligned) memory for an object of the given size.
+    void * Allocate(size_t size, size_t align) {
+      while (true) {
+        if (cur_block < blocks.size()) {
+          const size_t offset = (cur_offset + align - 1) & ~(align - 1);
+          if (offset + size <= blocks[cur_block].size) {
+            cur_offset = offset + size;
+            return blocks[cur_block].data.get() + offset;
+          }
+          // Doesn't fit. Try the next block (or make one).
+          ++cur_block;
+          cur_offset = 0;
+          if (cur_block < blocks.size() && blocks[cur_block].size < size) {
+            // Next block is too small for this event; replace it with one that fits.
+            blocks[cur_block].data.reset(new unsigned char[size]);
+            blocks[cur_block].size = size;
+          }
+        } else {
+          // Block sizes double (from FIRST_BLOCK_SIZE) up to BLOCK_SIZE, so queues that only ever
+          // hold a few events stay small.
+          const size_t next_size = blocks.size() ? 2 * blocks.back().size : FIRST_BLOCK_SIZE;
+          const size_t block_size = std::max(size, std::min(next_size, BLOCK_SIZE));
+          blocks.emplace_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[block_size]), block_size});
+          cur_block = blocks.size() - 1;
+          cur_offset = 0;
+        }
+      }
+    }
+
+    /// Destroy all events in [head, entries.size()).
+    void DestroyLive() {
+      for (size_t i = head; i < entries.size(); ++i) {
+        if (entries[i].ops->destroy) entries[i].ops->destroy(entries[i].event);
+      }
+    }
+
+    /// Rewind the arena. All events must already be destroyed.
+    void Rewind() {
+      entries.clear();
+      head = 0;
+      cur_block = 0;
+      cur_offset = 0;
+    }
+
+  public:
+    EventQueue() : blocks(), entries() { ; }
+    EventQueue(const EventQueue & other) : blocks(), entries() {
+      for (size_t i = other.head; i < other.entries.size(); ++i) {
+        other.entries[i].ops->push_copy(*this, *other.entries[i].event);
+      }
+    }
+    EventQueue(EventQueue && other)
+      : blocks(std::move(other.blocks)), cur_block(other.cur_block), cur_offset(other.cur_offset),
+        entries(std::move(other.entries)), head(other.head)
+    {
+      other.blocks.clear();
+      other.entries.clear();
+      other.Rewind();
+    }
+    ~EventQueue() { DestroyLive(); }
+
+    EventQueue & operator=(const EventQueue & other) {
+      if (this == &other) return *this;
+      Clear();
+      for (size_t i = other.head; i < other.entries.size(); ++i) {
+        other.entries[i].ops->push_copy(*this, *other.entries[i].event);
+      }
+      return *this;
+    }
+
+    EventQueue & operator=(EventQueue && other) {
+      if (this == &other) return *this;
+      DestroyLive();
+      blocks = std::move(other.blocks);
+      entries = std::move(other.entries);
+      cur_block = other.cur_block;
+      cur_offset = other.cur_offset;
+      head = other.head;
+      other.blocks.clear();
+      other.entries.clear();
+      other.Rewind();
+      return *this;
+    }
+
+    /// How many events are queued?
+    size_t size() const { return entries.size() - head; }
+
+    /// Is the queue empty?
+    bool empty() const { return head == entries.size(); }
+
+    /// How many arena blocks have been allocated? (Useful to check memory reuse.)
+    size_t GetNumBlocks() const { return blocks.size(); }
+
+    /// Add a copy of the given event to the back of the queue.
+    template<typename EVENT_T>
+    void Push(const EVENT_T & event) {
+      static_assert(std::is_base_of<event_t, EVENT_T>::value, "Queued events must be derived from the queue's event type.");
+      static_assert(alignof(EVENT_T) <= alignof(std::max_align_t), "Over-aligned events are not supported.");
+      void * mem = Allocate(sizeof(EVENT_T), alignof(EVENT_T));
+      EVENT_T * queued = new (mem) EVENT_T(event);
+      entries.emplace_back(Entry{static_cast<event_t *>(queued), &TypedOps<EVENT_T>::ops});
+    }
+
+    /// Add a reference to the given shared event to the back of the queue (the event isn't copied).
+    template<typename EVENT_T>
+    void Push(const SharedEvent<EVENT_T> & event) {
+      static_assert(std::is_base_of<event_t, EVENT_T>::value, "Queued events must be derived from the queue's event type.");
+      PushNode<EVENT_T>(event.node);
+    }
+
+    /// Add a copy of other[i] (as its own type) to the back of the queue. (Shared events stay shared.)
+    void PushFrom(const EventQueue & other, size_t i) {
+      emp_assert(i < other.size(), i, other.size());
+      const Entry & entry = other.entries[other.head + i];
+      entry.ops->push_copy(*this, *entry.event);
+    }
+
+    /// Get the event at the front of the queue.
+    const event_t & Front() const {
+      emp_assert(!empty(), "Event queue is empty.");
+      return *entries[head].event;
+    }
+
+    /// Get the i'th event (from the front) of the queue.
+    const event_t & operator[](size_t i) const {
+      emp_assert(i < size(), i, size());
+      return *entries[head + i].event;
+    }
+
+    /// Remove the event at the front of the queue (rewinding the arena if the queue is now empty).
+    void PopFront() {
+      emp_assert(!empty(), "Event queue is empty.");
+      Entry & entry = entries[head];
+      if (entry.ops->destroy) entry.ops->destroy(entry.event);
+      ++head;
+      if (head == entries.size()) Rewind();
+    }
+
+    /// Remove all events from the queue.
+    void Clear() {
+      DestroyLive();
+      Rewind();
+    }
+
+    /// (std-container-style alias for Clear)
+    void clear() { Clear(); }
+  };
+
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef EMP_SIGNALGP_EVENT_TIMER_WHEEL_H
+#define EMP_SIGNALGP_EVENT_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+namespace sgp {
+
+  /// Hierarchical timer wheel of events scheduled for future time steps (see SignalGPBase's
+  /// ScheduleEvent and ScheduleRepeatingEvent).
+  /// - Time advances one step per Advance, which moves events that are due onto the back of a given
+  ///   event queue. Scheduling and advancing take O(1) amortized time per event (an event is
+  ///   re-bucketed at most once per wheel level on its way down), no matter how many events are
+  ///   scheduled, and Advance is O(1) when nothing is scheduled.
+  /// - The wheel has NUM_LEVELS levels of 2^SLOT_BITS buckets; level L buckets span 2^(L*SLOT_BITS)
+  ///   steps each. Events due further out than the wheel spans wait in an overflow bucket.
+  /// - Events are stored in EVENT_QUEUE_Ts (EventQueue or StaticEventQueue), so they are copied in
+  ///   as their own type and bucket memory is reused.
+  /// - Events due on the same step are delivered in a deterministic (but unspecified) order.
+  template<typename EVENT_QUEUE_T, size_t SLOT_BITS=6, size_t NUM_LEVELS=4>
+  class EventTimerWheel {
+  public:
+    using event_queue_t = EVENT_QUEUE_T;
+    using event_t = typename event_queue_t::event_t;
+
+    static constexpr size_t NUM_SLOTS = (size_t)1 << SLOT_BITS;   ///< Buckets per level.
+
+  protected:
+    static_assert(SLOT_BITS * NUM_LEVELS < std::numeric_limits<size_t>::digits, "Timer wheel spans too many steps.");
+    static constexpr size_t SLOT_MASK = NUM_SLOTS - 1;
+    static constexpr size_t OVERFLOW_BUCKET = NUM_LEVELS * NUM_SLOTS;
+
+    struct Timer {
+      size_t due;      ///< Step the event is due on.
+      size_t period;   ///< Steps between repeats (0 if the event doesn't repeat).
+      size_t id;       ///< ID of a repeating event.
+    };
+
+    /// Scheduled events (with their timers, in the same order).
+    struct Bucket {
+      event_queue_t events;
+      emp::vector<Timer> timers;
+    };
+
+    emp::vector<Bucket> buckets;          ///< Level-major, then the overflow bucket.
+    Bucket scratch;                       ///< Bucket being emptied (swapped out of buckets).
+    std::unordered_set<size_t> repeating; ///< IDs of (uncanceled) repeating events.
+    size_t now=0;                         ///< Current step.
+    size_t num_scheduled=0;               ///< Events in buckets.
+    size_t next_id=0;                     ///< Next repeating event ID.
+
+    /// Which bucket does an event due at the given step go in?
+    size_t GetBucketID(size_t due) const {
+      emp_assert(due >= now, due, now);
+      for (size_t level = 0; level < NUM_LEVELS; ++level) {
+        // Use the lowest level whose buckets above the due step's bucket haven't come up yet.
+        const size_t shift = (level + 1) * SLOT_BITS;
+        if ((due >> shift) == (now >> shift)) return level * NUM_SLOTS + ((due >> (level * SLOT_BITS)) & SLOT_MASK);
+      }
+      return OVERFLOW_BUCKET;
+    }
+
+    template<typename EVENT_T>
+    void Insert(const EVENT_T & event, const Timer & timer) {
+      Bucket & bucket = buckets[GetBucketID(timer.due)];
+      bucket.events.Push(event);
+      bucket.timers.emplace_back(timer);
+    }
+
+    /// Insert a copy of from.events[i].
+    void InsertFrom(const Bucket & from, size_t i, const Timer & timer) {
+      Bucket & bucket = buckets[GetBucketID(timer.due)];
+      bucket.events.PushFrom(from.events, i);
+      bucket.timers.emplace_back(timer);
+    }
+
+    /// Empty the given bucket into scratch (scratch must be empty).
+    void TakeBucket(size_t bucket_id) {
+      std::swap(scratch, buckets[bucket_id]);
+    }
+
+    void ClearScratch() {
+      scratch.events.Clear();
+      scratch.timers.clear();
+    }
+
+    /// Move every event in the given bucket to the bucket it's due in now (a lower level, unless
+    /// it's an overflow event that is still out of range).
+    void Cascade(size_t bucket_id) {
+      TakeBucket(bucket_id);
+      for (size_t i = 0; i < scratch.timers.size(); ++i) InsertFrom(scratch, i, scratch.timers[i]);
+      ClearScratch();
+    }
+
+  public:
+    EventTimerWheel() : buckets(OVERFLOW_BUCKET + 1), scratch(), repeating() { ; }
+
+    /// Current step (number of calls to Advance since the wheel was made or cleared).
+    size_t GetTime() const { return now; }
+
+    /// Number of scheduled events. (A canceled repeating event is counted until its next due step.)
+    size_t GetSize() const { return num_scheduled; }
+
+    /// Number of scheduled, uncanceled repeating events.
+    size_t GetNumRepeating() const { return repeating.size(); }
+
+    /// Schedule a copy of the given event to be delivered by the (delay + 1)'th Advance from now
+    /// (i.e., with delay 0, the next Advance delivers it).
+    template<typename EVENT_T>
+    void Schedule(const EVENT_T & event, size_t delay=0) {
+      Insert(event, Timer{now + delay + 1, 0, 0});
+      ++num_scheduled;
+    }
+
+    /// Schedule a copy of the given event to be delivered by the (delay + 1)'th Advance from now,
+    /// and then every period steps after that (until canceled).
+    /// @return ID of the repeating event (see CancelRepeating).
+    template<typename EVENT_T>
+    size_t ScheduleRepeating(const EVENT_T & event, size_t period, size_t delay=0) {
+      emp_assert(period > 0, "Repeating events must have a period of at least one step.");
+      const size_t id = next_id++;
+      repeating.emplace(id);
+      Insert(event, Timer{now + delay + 1, period, id});
+      ++num_scheduled;
+      return id;
+    }
+
+    /// Stop delivering the given repeating event.
+    /// @return Whether the event was repeating (false if it was already canceled or cleared).
+    bool CancelRepeating(size_t id) { return repeating.erase(id); }
+
+    /// Remove all scheduled events and rewind time to 0 (keeping memory for reuse).
+    void Clear() {
+      for (Bucket & bucket : buckets) {
+        bucket.events.Clear();
+        bucket.timers.clear();
+      }
+      repeating.clear();
+      now = 0;
+      num_scheduled = 0;
+    }
+
+    /// Advance time one step, pushing events that are due onto the back of the given queue.
+    /// @return Number of events delivered.
+    size_t Advance(event_queue_t & queue) {
+      ++now;
+      if (!num_scheduled) return 0;
+
+      // When lower levels wrap around, bring the next bucket of each higher level down (from the
+      // top, so events can fall through several levels).
+      if ((now & SLOT_MASK) == 0) {
+        size_t level = 1;
+        while (level < NUM_LEVELS && ((now >> (level * SLOT_BITS)) & SLOT_MASK) == 0) ++level;
+        if (level == NUM_LEVELS) {
+          Cascade(OVERFLOW_BUCKET);
+          --level;
+        }
+        for (; level > 0; --level) Cascade(level * NUM_SLOTS + ((now >> (level * SLOT_BITS)) & SLOT_MASK));
+      }
+
+      // Deliver everything in the current level 0 bucket.
+      TakeBucket(now & SLOT_MASK);
+      size_t num_delivered = 0;
+      for (size_t i = 0; i < scratch.timers.size(); ++i) {
+        const Timer & timer = scratch.timers[i];
+        emp_assert(timer.due == now, timer.due, now);
+        if (timer.period) {
+          if (!repeating.count(timer.id)) {
+            --num_scheduled; // Canceled.
+            continue;
+          }
+          InsertFrom(scratch, i, Timer{timer.due + timer.period, timer.period, timer.id});
+        } else {
+          --num_scheduled;
+        }
+        queue.PushFrom(scratch.events, i);
+        ++num_delivered;
+      }
+      ClearScratch();
+      return num_delivered;
+    }
+  };
+
+}
+
+#endif
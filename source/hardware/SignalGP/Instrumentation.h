@@ -0,0 +1,185 @@
+#ifndef EMP_SIGNALGP_INSTRUMENTATION_H
+#define EMP_SIGNALGP_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "base/vector.h"
+
+namespace sgp {
+
+  /// Default instrumentation policy: every hook is an empty inline function, so instrumented call
+  /// sites compile away entirely.
+  ///
+  /// An instrumentation policy is given to SignalGP hardware as a template parameter (see
+  /// SignalGPBase's INSTRUMENTATION_T); hardware owns one instance (GetInstrumentation) and calls:
+  ///   * OnInstruction(inst_id) - before executing an instruction.
+  ///   * OnModuleEntry(module_id, call_depth) - after a module is called (or a thread is initialized
+  ///     with a module); call_depth is the size of the call stack including the new call.
+  ///   * OnThreadSpawn(module_id) - after a thread is spawned (and marked pending).
+  ///   * OnThreadKill() - after a thread is removed from the active or pending threads (because it
+  ///     finished, was killed, or was displaced by a higher-priority thread).
+  ///   * OnEvent(event_id) - before an event is handled.
+  /// Hardware resets do not reset instrumentation (so counts can accumulate across programs), and
+  /// threads cleared by a reset are not reported as killed.
+  struct NoInstrumentation {
+    static constexpr bool ENABLED = false;
+
+    void OnInstruction(size_t inst_id) { ; }
+    void OnModuleEntry(size_t module_id, size_t call_depth) { ; }
+    void OnThreadSpawn(size_t module_id) { ; }
+    void OnThreadKill() { ; }
+    void OnEvent(size_t event_id) { ; }
+    void Reset() { ; }
+  };
+
+  /// Instrumentation policy that counts what hardware does: executions per instruction id, entries
+  /// per module, a histogram of call depths (at module entry), thread spawns/kills, and handled
+  /// events per event id. Counts can be printed as a JSON report (PrintReport).
+  class ExecutionProfiler {
+  public:
+    static constexpr bool ENABLED = true;
+
+    /// Function that names an instruction/event id (or returns "" to leave it unnamed).
+    using name_fun_t = std::function<std::string(size_t)>;
+
+  protected:
+    emp::vector<size_t> inst_counts;      ///< Executions, indexed by instruction id.
+    emp::vector<size_t> module_entries;   ///< Entries, indexed by module id.
+    emp::vector<size_t> call_depths;      ///< Module entries, indexed by call depth.
+    emp::vector<size_t> module_spawns;    ///< Thread spawns, indexed by module id.
+    emp::vector<size_t> event_counts;     ///< Events handled, indexed by event id.
+    size_t threads_spawned=0;
+    size_t threads_killed=0;
+
+    static void Count(emp::vector<size_t> & counts, size_t i) {
+      if (i >= counts.size()) counts.resize(i + 1, 0);
+      ++counts[i];
+    }
+
+    static size_t Total(const emp::vector<size_t> & counts) {
+      size_t total = 0;
+      for (size_t count : counts) total += count;
+      return total;
+    }
+
+    static void PrintString(std::ostream & os, const std::string & str) {
+      os << '"';
+      for (char c : str) {
+        if (c == '"' || c == '\\') os << '\\';
+        os << c;
+      }
+      os << '"';
+    }
+
+    /// Print non-zero counts as a JSON array of {"id", ["name",] "count"} objects, most frequent
+    /// first. name_fun(id) gives the name of id (or "" to omit it).
+    template<typename NAME_FUN>
+    static void PrintCounts(std::ostream & os, const emp::vector<size_t> & counts, NAME_FUN && name_fun) {
+      emp::vector<size_t> ids;
+      for (size_t i = 0; i < counts.size(); ++i) if (counts[i]) ids.emplace_back(i);
+      std::stable_sort(ids.begin(), ids.end(), [&counts](size_t a, size_t b) { return counts[a] > counts[b]; });
+      os << "[";
+      for (size_t i = 0; i < ids.size(); ++i) {
+        os << (i ? ", " : "") << "{\"id\": " << ids[i];
+        const std::string name = name_fun(ids[i]);
+        if (name.size()) {
+          os << ", \"name\": ";
+          PrintString(os, name);
+        }
+        os << ", \"count\": " << counts[ids[i]] << "}";
+      }
+      os << "]";
+    }
+
+  public:
+    void OnInstruction(size_t inst_id) { Count(inst_counts, inst_id); }
+    void OnModuleEntry(size_t module_id, size_t call_depth) {
+      Count(module_entries, module_id);
+      Count(call_depths, call_depth);
+    }
+    void OnThreadSpawn(size_t module_id) {
+      ++threads_spawned;
+      Count(module_spawns, module_id);
+    }
+    void OnThreadKill() { ++threads_killed; }
+    void OnEvent(size_t event_id) { Count(event_counts, event_id); }
+
+    /// Zero all counts.
+    void Reset() {
+      inst_counts.clear();
+      module_entries.clear();
+      call_depths.clear();
+      module_spawns.clear();
+      event_counts.clear();
+      threads_spawned = 0;
+      threads_killed = 0;
+    }
+
+    /// Executions, indexed by instruction id (ids past the end were never executed).
+    const emp::vector<size_t> & GetInstCounts() const { return inst_counts; }
+    size_t GetInstCount(size_t inst_id) const { return inst_id < inst_counts.size() ? inst_counts[inst_id] : 0; }
+    size_t GetTotalInstCount() const { return Total(inst_counts); }
+
+    /// Module entries (calls and thread initializations), indexed by module id.
+    const emp::vector<size_t> & GetModuleEntries() const { return module_entries; }
+    size_t GetModuleEntryCount(size_t module_id) const {
+      return module_id < module_entries.size() ? module_entries[module_id] : 0;
+    }
+
+    /// Number of module entries at each call depth (1 = thread's initial module).
+    const emp::vector<size_t> & GetCallDepthHistogram() const { return call_depths; }
+
+    /// Thread spawns, indexed by the spawned thread's module id.
+    const emp::vector<size_t> & GetModuleSpawns() const { return module_spawns; }
+    size_t GetThreadsSpawned() const { return threads_spawned; }
+    size_t GetThreadsKilled() const { return threads_killed; }
+
+    /// Events handled, indexed by event id.
+    const emp::vector<size_t> & GetEventCounts() const { return event_counts; }
+    size_t GetEventCount(size_t event_id) const { return event_id < event_counts.size() ? event_counts[event_id] : 0; }
+
+    /// Print counts as a JSON object:
+    ///   {"total_instructions", "instructions": [{"id", "name", "count"}, ...], "modules": [...],
+    ///    "spawns": [...], "call_depths": [...], "threads": {"spawned", "killed"}, "events": [...]}
+    /// Instructions, modules (entries), spawns (per module), and events are listed most frequent
+    /// first; call_depths[i] is the number of module entries at call depth i.
+    /// Instruction and event names are taken from the given libraries.
+    template<typename INST_LIB_T, typename EVENT_LIB_T>
+    void PrintReport(std::ostream & os, const INST_LIB_T & inst_lib, const EVENT_LIB_T & event_lib) const {
+      PrintReport(os,
+                  name_fun_t([&inst_lib](size_t id) { return id < inst_lib.GetSize() ? inst_lib.GetName(id) : std::string(); }),
+                  name_fun_t([&event_lib](size_t id) { return id < event_lib.GetSize() ? event_lib.GetName(id) : std::string(); }));
+    }
+
+    /// Print counts as a JSON object (without instruction/event names).
+    void PrintReport(std::ostream & os) const {
+      const name_fun_t no_name = [](size_t) { return std::string(); };
+      PrintReport(os, no_name, no_name);
+    }
+
+    /// Print counts as a JSON object, naming instructions with inst_name(id) and events with
+    /// event_name(id).
+    void PrintReport(std::ostream & os, const name_fun_t & inst_name, const name_fun_t & event_name) const {
+      auto no_name = [](size_t) { return std::string(); };
+      os << "{\"total_instructions\": " << GetTotalInstCount() << ",\n";
+      os << " \"instructions\": ";
+      PrintCounts(os, inst_counts, inst_name);
+      os << ",\n \"modules\": ";
+      PrintCounts(os, module_entries, no_name);
+      os << ",\n \"spawns\": ";
+      PrintCounts(os, module_spawns, no_name);
+      os << ",\n \"call_depths\": [";
+      for (size_t i = 0; i < call_depths.size(); ++i) os << (i ? ", " : "") << call_depths[i];
+      os << "],\n \"threads\": {\"spawned\": " << threads_spawned << ", \"killed\": " << threads_killed << "},\n";
+      os << " \"events\": ";
+      PrintCounts(os, event_counts, event_name);
+      os << "}\n";
+    }
+  };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef EMP_SIGNALGP_BASE_H
 #define EMP_SIGNALGP_BASE_H
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include <limits>
@@ -8,6 +9,7 @@
 #include <queue>
 #include <tuple>
 #include <memory>
+#include <type_traits>
 
 #include "base/Ptr.h"
 #include "base/vector.h"
@@ -15,7 +17,13 @@
 #include "tools/set_utils.h"
 #include "tools/vector_utils.h"
 
+#include "EventInbox.h"
 #include "EventLibrary.h"
+#include "EventQueue.h"
+#include "EventTimerWheel.h"
+#include "Instrumentation.h"
+#include "ThreadIDSet.h"
+#include "ThreadPriorityHeap.h"
 
 // @discussion - where should I put configurable lambdas?
 // todo - move function implementations outside of class
@@ -25,6 +33,47 @@ namespace sgp {
   /// Placeholder additional component type.
   struct DefaultCustomComponent { };
 
+  namespace internal {
+    // Detectors for the interface that SignalGPBase requires of derived hardware (see SignalGPBase).
+
+    template<typename HW_T, typename=void>
+    struct HasResetImpl : std::false_type { };
+    template<typename HW_T>
+    struct HasResetImpl<HW_T, std::void_t<decltype(std::declval<HW_T&>().ResetImpl())>>
+      : std::true_type { };
+
+    template<typename HW_T, typename THREAD_T, typename=void>
+    struct HasSingleExecutionStep : std::false_type { };
+    template<typename HW_T, typename THREAD_T>
+    struct HasSingleExecutionStep<HW_T, THREAD_T,
+                                  std::void_t<decltype(std::declval<HW_T&>().SingleExecutionStep(std::declval<HW_T&>(),
+                                                                                                 std::declval<THREAD_T&>()))>>
+      : std::true_type { };
+
+    template<typename HW_T, typename TAG_T, typename MODULE_ID_T, typename=void>
+    struct HasFindModuleMatch : std::false_type { };
+    template<typename HW_T, typename TAG_T, typename MODULE_ID_T>
+    struct HasFindModuleMatch<HW_T, TAG_T, MODULE_ID_T,
+                              std::enable_if_t<std::is_convertible<decltype(std::declval<HW_T&>().FindModuleMatch(std::declval<const TAG_T&>(),
+                                                                                                                  std::declval<size_t>())),
+                                                                   emp::vector<MODULE_ID_T>>::value>>
+      : std::true_type { };
+
+    template<typename HW_T, typename THREAD_T, typename MODULE_ID_T, typename=void>
+    struct HasInitThread : std::false_type { };
+    template<typename HW_T, typename THREAD_T, typename MODULE_ID_T>
+    struct HasInitThread<HW_T, THREAD_T, MODULE_ID_T,
+                         std::void_t<decltype(std::declval<HW_T&>().InitThread(std::declval<THREAD_T&>(),
+                                                                               std::declval<MODULE_ID_T>()))>>
+      : std::true_type { };
+
+    template<typename EXEC_STATE_T, typename=void>
+    struct HasExecStateReset : std::false_type { };
+    template<typename EXEC_STATE_T>
+    struct HasExecStateReset<EXEC_STATE_T, std::void_t<decltype(std::declval<EXEC_STATE_T&>().Reset())>>
+      : std::true_type { };
+  }
+
   /// @brief Base SignalGP class from which all SignalGP implementations should be derived.
   ///
   /// This version of SignalGP makes use of the curiously recursive template pattern (see: https://en.wikipedia.org/wiki/Curiously_recurring_template_pattern).
@@ -38,6 +87,16 @@ namespace sgp {
   ///   * TAG_T - Specifies the type that is used to search for modules when spawning a new thread.
   ///   * CUSTOM_COMPONENT_T - Optional template parameter. Specifies type of custom hardware component
   ///     to be added on to the SignalGP virtual hardware.
+  ///   * INSTRUMENTATION_T - Optional template parameter. Specifies an instrumentation policy that
+  ///     hardware reports execution to (see Instrumentation.h). The default, NoInstrumentation,
+  ///     compiles to nothing; ExecutionProfiler counts instructions, module entries, call depths,
+  ///     thread spawns/kills, and events.
+  ///   * EVENT_LIB_T - Optional template parameter. Specifies the type of event library hardware uses.
+  ///     The default (void) is EventLibrary<DERIVED_T>: events are derived from BaseEvent and handlers
+  ///     are registered at runtime. StaticEventLibrary handles a fixed set of event types with handlers
+  ///     resolved at compile time. An event library type must provide event_t and event_queue_t
+  ///     types, static GetEventID(event) and PrintEvent(event, os), and HandleEvent(hw, event) and
+  ///     TriggerEvent(hw, event).
   ///
   /// SignalGP implementations that inherit from SignalGPBase add functionality to SignalGPBase's.
   /// At a high level, while SignalGPBase manages events and threads, derived implementations of SignalGP
@@ -45,7 +104,9 @@ namespace sgp {
   /// information is required to specify the state of a thread? et cetera).
   ///
   /// REQUIREMENTS
-  ///   * Derived implementations MUST minimally specify the following methods:
+  ///   * Derived implementations MUST minimally specify the following (public) methods. SignalGPBase
+  ///     calls them statically (i.e., they are not virtual, so they can be inlined into SignalGPBase's
+  ///     scheduling loop); a missing method is reported by a static_assert when DERIVED_T is constructed.
   ///     * ResetImpl()
   ///       - Return type: void
   ///       - Reset state information in DERIVED_T virtual hardware.
@@ -66,7 +127,9 @@ namespace sgp {
   template<typename DERIVED_T,
            typename EXEC_STATE_T,
            typename TAG_T,
-           typename CUSTOM_COMPONENT_T=DefaultCustomComponent>
+           typename CUSTOM_COMPONENT_T=DefaultCustomComponent,
+           typename INSTRUMENTATION_T=NoInstrumentation,
+           typename EVENT_LIB_T=void>
   class SignalGPBase {
   public:
     // Forward declarations
@@ -77,9 +140,13 @@ namespace sgp {
     using exec_state_t = EXEC_STATE_T;
     using tag_t = TAG_T;
     using custom_comp_t = CUSTOM_COMPONENT_T;
+    using instrumentation_t = INSTRUMENTATION_T;
 
-    using event_t = BaseEvent;
-    using event_lib_t = EventLibrary<hardware_t>;
+    using event_lib_t = std::conditional_t<std::is_void<EVENT_LIB_T>::value, EventLibrary<hardware_t>, EVENT_LIB_T>;
+    using event_t = typename event_lib_t::event_t;
+    using event_queue_t = typename event_lib_t::event_queue_t;
+    using event_inbox_t = EventInbox<event_t, std::max<size_t>(128, sizeof(event_t)), event_queue_t>;
+    using timer_wheel_t = EventTimerWheel<event_queue_t>;
 
     using module_id_t = size_t;
 
@@ -137,6 +204,29 @@ namespace sgp {
       void SetPriority(double p) { priority = p; }
     };
 
+    /// Copy of the base hardware's execution state: queued and scheduled events, threads, thread
+    /// bookkeeping, thread management settings, and the custom component (see
+    /// SaveBaseState/RestoreBaseState). Events waiting in the event inbox are not part of the state.
+    struct BaseState {
+      event_queue_t event_queue;
+      std::optional<timer_wheel_t> timer_wheel;
+      size_t max_active_threads=0;
+      size_t max_thread_space=0;
+      bool use_thread_priority=true;
+      size_t thread_quantum=1;
+      emp::vector<thread_t> threads;
+      emp::vector<size_t> thread_exec_order;
+      ThreadIDSet active_threads;
+      emp::vector<size_t> unused_threads;
+      std::deque<size_t> pending_threads;
+      ThreadMaxPriorityHeap pending_max_heap;
+      ThreadMinPriorityHeap pending_min_heap;
+      ThreadMinPriorityHeap active_min_heap;
+      size_t num_pended=0;
+      bool thread_priorities_dirty=false;
+      custom_comp_t custom_component;
+    };
+
   private:
     struct {
       bool valid=false;
@@ -153,7 +243,9 @@ namespace sgp {
   protected:
     // -- Event management --
     event_lib_t & event_lib;                           ///< Library of events that hardware can handle.
-    std::deque<std::shared_ptr<event_t>> event_queue;  ///< Queue of events to be processed every time step.
+    event_queue_t event_queue;                         ///< Queue of events to be processed every time step.
+    std::optional<event_inbox_t> event_inbox;         ///< Optional inbox for events posted from other threads.
+    std::optional<timer_wheel_t> timer_wheel;         ///< Events scheduled for later steps (made on first use).
 
     // -- Thread management --
     // WARNING: Derived classes can modify these member variables AT THEIR OWN RISK!
@@ -161,6 +253,8 @@ namespace sgp {
     size_t max_active_threads=64;         ///< Maximum number of concurrently running (active) threads.
     size_t max_thread_space=512;          ///< Maximum total active + pending threads.
     bool use_thread_priority=true;        ///< Should SignalGP use thread priority when spawning/killing threads?
+    size_t thread_quantum=1;              ///< Maximum number of execution steps each active thread takes per
+                                          ///<   SingleProcess.
     emp::vector<thread_t> threads;        /**< All threads (each could be active/inactive/pending).
                                            *   Initially threads.size = MIN(2*max_active_threads, max_thread_space),
                                            *   but vector will grow as necessary up to max_thread_space.
@@ -169,10 +263,20 @@ namespace sgp {
                                            **/
     emp::vector<size_t> thread_exec_order;      ///< Thread execution order (not all guaranteed to be
                                                 ///<   in RUNNING state).
-    std::unordered_set<size_t> active_threads;  ///< Active thread ids, all currently running.
+    ThreadIDSet active_threads;                 ///< Active thread ids, all currently running.
     emp::vector<size_t> unused_threads;         ///< Pool of unused thread ids.
     std::deque<size_t> pending_threads;         ///< Pending (for consideration to be shifted to ACTIVE)
                                                 ///<   thread ids.
+    ThreadMaxPriorityHeap pending_max_heap;     ///< Pending thread ids, highest priority first.
+    ThreadMinPriorityHeap pending_min_heap;     ///< Pending thread ids, lowest priority first (ties go to
+                                                ///<   the thread that has been pending the longest).
+    ThreadMinPriorityHeap active_min_heap;      ///< Active thread ids, lowest priority first.
+    size_t num_pended=0;                        ///< Number of threads added to pending_threads (orders
+                                                ///<   pending_min_heap ties).
+    emp::vector<size_t> activation_victims;     ///< Scratch space for ActivatePendingThreads (indexed by
+                                                ///<   thread id): active thread each pending thread replaces.
+    bool thread_priorities_dirty=false;         ///< Might thread priorities have been changed without
+                                                ///<   updating the priority heaps?
     // -- Custom component --
     custom_comp_t custom_component;  /**< Custom hardware component. This is convenient for problem-,
                                           environment-, or experiment-specific hardware components that
@@ -182,6 +286,8 @@ namespace sgp {
                                           equal to a struct { with your bundle of components inside }.
                                       */
 
+    instrumentation_t instrumentation; ///< Instrumentation policy (receives execution callbacks).
+
     // -- Configurable print functions --
     /// Function to print given hardware state of DERIVED_T to given ostream.
     fun_print_hardware_state_t fun_print_hardware_state = [](const hardware_t& hw, std::ostream & os) { os << "Print hardware state not configured."; };
@@ -190,7 +296,7 @@ namespace sgp {
     fun_print_execution_state_t fun_print_execution_state = [](const exec_state_t & e, const hardware_t& hw, std::ostream & os) { os << "Print execution state not configured."; };
 
     /// Function to print given event to given ostream.
-    fun_print_event_t fun_print_event = [](const event_t & e, const hardware_t& hw, std::ostream & os) { e.Print(os); };
+    fun_print_event_t fun_print_event = [](const event_t & e, const hardware_t& hw, std::ostream & os) { event_lib_t::PrintEvent(e, os); };
 
     // -- Internally-used thread management functions --
     /// Activate thread:
@@ -201,6 +307,8 @@ namespace sgp {
       emp_assert(thread_id < threads.size(), "Cannot activate invalid thread_id", thread_id);
       emp_assert(!emp::Has(thread_exec_order, thread_id), "Duplicate thread ids in thread_exec_order", thread_id);
       active_threads.emplace(thread_id);
+      RemovePendingFromHeaps(thread_id);
+      active_min_heap.Push(thread_id, threads[thread_id].GetPriority());
       thread_exec_order.emplace_back(thread_id);
       threads[thread_id].SetRunning();
     }
@@ -214,12 +322,14 @@ namespace sgp {
     /// on an active thread, then calling ActivateThread on the same id will result in an error.
     void KillActiveThread_impl(size_t thread_id) {
       emp_assert(thread_id < threads.size());
-      emp_assert(emp::Has(active_threads, thread_id), "Thread ID not in active_threads", thread_id);
+      emp_assert(active_threads.Has(thread_id), "Thread ID not in active_threads", thread_id);
       emp_assert(!emp::Has(unused_threads, thread_id), "Thread ID already in unused_threads", thread_id);
       active_threads.erase(thread_id);
+      active_min_heap.Remove(thread_id);
       // NOTE: Don't want to reset thread here because this function could be called during this thread's execution.
       threads[thread_id].SetDead();
       unused_threads.emplace_back(thread_id);
+      instrumentation.OnThreadKill();
     }
 
     /// Kill the next pending thread:
@@ -232,8 +342,45 @@ namespace sgp {
       emp_assert(pending_id < threads.size());
       emp_assert(!emp::Has(unused_threads, pending_id), "Thread ID already in unused_threads", pending_id);
       pending_threads.pop_front();
+      RemovePendingFromHeaps(pending_id);
       threads[pending_id].SetDead();           // mark dead
       unused_threads.emplace_back(pending_id); // reclaim pending_id for future use
+      instrumentation.OnThreadKill();
+    }
+
+    /// Add pending thread to the pending thread priority heaps.
+    void AddPendingToHeaps(size_t thread_id) {
+      const double priority = threads[thread_id].GetPriority();
+      pending_max_heap.Push(thread_id, priority);
+      pending_min_heap.Push(thread_id, priority, num_pended++);
+    }
+
+    /// Remove thread from the pending thread priority heaps (if it's there).
+    void RemovePendingFromHeaps(size_t thread_id) {
+      pending_max_heap.Remove(thread_id);
+      pending_min_heap.Remove(thread_id);
+    }
+
+    /// Make sure the priority heaps agree with the given thread's current priority.
+    void SyncThreadPriority(size_t thread_id) {
+      const double priority = threads[thread_id].GetPriority();
+      if (active_min_heap.Has(thread_id)) {
+        if (active_min_heap.GetPriority(thread_id) != priority) active_min_heap.Update(thread_id, priority);
+      } else if (pending_max_heap.Has(thread_id)) {
+        if (pending_max_heap.GetPriority(thread_id) != priority) {
+          pending_max_heap.Update(thread_id, priority);
+          pending_min_heap.Update(thread_id, priority);
+        }
+      }
+    }
+
+    /// Thread priorities may have been changed directly (via GetThread/GetThreads), resync the
+    /// priority heaps with every active and pending thread.
+    void SyncThreadPriorities() {
+      if (!thread_priorities_dirty) return;
+      for (size_t thread_id : active_threads) SyncThreadPriority(thread_id);
+      for (size_t thread_id : pending_threads) SyncThreadPriority(thread_id);
+      thread_priorities_dirty = false;
     }
 
     /// Attempt to activate all pending threads.
@@ -251,17 +398,39 @@ namespace sgp {
     /// kill if necessary.
     void SetActiveThreadLimit_NoPriority_impl(size_t n);
 
+    /// Check (at compile time) that DERIVED_T implements everything SignalGPBase requires of it.
     /// REQUIRED - Must be implemented by DERIVED_T
-    /// ResetImpl should fully reset any hardware state information tracked by DERIVED_T.
-    /// ResetImpl is called by THIS_T::Reset before doing a ResetBaseHardwareState.
-    virtual void ResetImpl() = 0;
+    ///   * void ResetImpl(): fully reset any hardware state information tracked by DERIVED_T.
+    ///     ResetImpl is called by Reset before doing a ResetBaseHardwareState.
+    ///   * void SingleExecutionStep(DERIVED_T &, thread_t &): advance the given thread by a single step
+    ///     on the given DERIVED_T implementation of SignalGP.
+    ///   * emp::vector<module_id_t> FindModuleMatch(const tag_t &, size_t n): given a TAG_T (tag) and a
+    ///     maximum number of modules to search for (n), return a vector of valid module matches (valid as
+    ///     specified by DERIVED_T). It is valid for the return value to have a size from [0:n].
+    ///   * void InitThread(thread_t &, module_id_t): initialize the given thread using the specified
+    ///     module_id.
+    static constexpr bool CheckDerivedInterface() {
+      static_assert(internal::HasResetImpl<DERIVED_T>::value,
+                    "SignalGP hardware must implement a public void ResetImpl().");
+      static_assert(internal::HasSingleExecutionStep<DERIVED_T, thread_t>::value,
+                    "SignalGP hardware must implement a public void SingleExecutionStep(DERIVED_T &, thread_t &).");
+      static_assert(internal::HasFindModuleMatch<DERIVED_T, tag_t, module_id_t>::value,
+                    "SignalGP hardware must implement a public emp::vector<module_id_t> FindModuleMatch(const tag_t &, size_t).");
+      static_assert(internal::HasInitThread<DERIVED_T, thread_t, module_id_t>::value,
+                    "SignalGP hardware must implement a public void InitThread(thread_t &, module_id_t).");
+      static_assert(internal::HasExecStateReset<exec_state_t>::value,
+                    "SignalGP execution state (EXEC_STATE_T) must implement void Reset().");
+      return true;
+    }
 
   public:
     SignalGPBase(event_lib_t & elib)
       : event_lib(elib),
         threads(std::min(2*max_active_threads, max_thread_space)),
+        active_threads(max_thread_space),
         unused_threads(threads.size())
     {
+      static_assert(CheckDerivedInterface(), "SignalGP hardware does not implement the SignalGPBase interface.");
       // Set all threads to unused.
       for (size_t i = 0; i < unused_threads.size(); ++i) {
         unused_threads[i] = (unused_threads.size() - 1) - i;
@@ -275,27 +444,13 @@ namespace sgp {
     SignalGPBase(const SignalGPBase & in) = default;
 
     /// Destructor.
-    virtual ~SignalGPBase() {};
-
-    /// REQUIRED - Must be implemented by DERIVED_T
-    /// This function should advance the given thread by a single step on the given DERIVED_T implementation
-    /// of SignalGP.
-    virtual void SingleExecutionStep(DERIVED_T &, thread_t &) = 0;
-
-    /// REQUIRED - Must be implemented by DERIVED_T
-    /// Given a TAG_T (tag) and a maximum number of modules to search for (n), return a vector of valid
-    /// module matches (valid as specified by DERIVED_T).
-    /// It is valid for the return value to have a size from [0:n].
-    virtual emp::vector<module_id_t> FindModuleMatch(const tag_t &, size_t) = 0;
-
-    /// REQUIRED - Must be implemented by DERIVED_T
-    /// This function should take a thread_t & thread and size_t module_id as input and initialize
-    /// the given thread using the specified module_id.
-    virtual void InitThread(thread_t &, module_id_t) = 0;
+    /// (Not virtual: SignalGP hardware is used through DERIVED_T, never through a SignalGPBase pointer.)
+    ~SignalGPBase() = default;
 
     /// Reset the base hardware state:
     /// - Clear event queue.
     /// - Reset all threads, move all to unused; clear pending.
+    /// (Events waiting in the event inbox, if any, are kept and queued by the next SingleProcess.)
     void ResetBaseHardwareState();
 
     /// Reset thread states.
@@ -308,6 +463,11 @@ namespace sgp {
       thread_exec_order.clear(); // No threads to execute.
       active_threads.clear();    // No active threads.
       pending_threads.clear();   // No pending threads.
+      active_min_heap.clear();
+      pending_max_heap.clear();
+      pending_min_heap.clear();
+      num_pended = 0;
+      thread_priorities_dirty = false;
       unused_threads.resize(threads.size());
       // Add all available threads to unused.
       for (size_t i = 0; i < unused_threads.size(); ++i) {
@@ -321,9 +481,62 @@ namespace sgp {
     /// Safe to do while executing.
     void ClearEventQueue() { event_queue.clear(); }
 
+    /// Remove all scheduled events (see ScheduleEvent).
+    void ClearScheduledEvents() {
+      if (timer_wheel) timer_wheel->Clear();
+    }
+
+    /// Copy base hardware state into state (reusing state's storage).
+    /// Cannot call while hardware is executing.
+    void SaveBaseState(BaseState & state) const {
+      emp_assert(!is_executing, "Cannot save hardware state while executing.");
+      state.event_queue = event_queue;
+      state.timer_wheel = timer_wheel;
+      state.max_active_threads = max_active_threads;
+      state.max_thread_space = max_thread_space;
+      state.use_thread_priority = use_thread_priority;
+      state.thread_quantum = thread_quantum;
+      state.threads = threads;
+      state.thread_exec_order = thread_exec_order;
+      state.active_threads = active_threads;
+      state.unused_threads = unused_threads;
+      state.pending_threads = pending_threads;
+      state.pending_max_heap = pending_max_heap;
+      state.pending_min_heap = pending_min_heap;
+      state.active_min_heap = active_min_heap;
+      state.num_pended = num_pended;
+      state.thread_priorities_dirty = thread_priorities_dirty;
+      state.custom_component = custom_component;
+    }
+
+    /// Overwrite base hardware state with state (reusing this hardware's storage).
+    /// Cannot call while hardware is executing.
+    void RestoreBaseState(const BaseState & state) {
+      emp_assert(!is_executing, "Cannot restore hardware state while executing.");
+      event_queue = state.event_queue;
+      timer_wheel = state.timer_wheel;
+      max_active_threads = state.max_active_threads;
+      max_thread_space = state.max_thread_space;
+      use_thread_priority = state.use_thread_priority;
+      thread_quantum = state.thread_quantum;
+      threads = state.threads;
+      thread_exec_order = state.thread_exec_order;
+      active_threads = state.active_threads;
+      unused_threads = state.unused_threads;
+      pending_threads = state.pending_threads;
+      pending_max_heap = state.pending_max_heap;
+      pending_min_heap = state.pending_min_heap;
+      active_min_heap = state.active_min_heap;
+      num_pended = state.num_pended;
+      thread_priorities_dirty = state.thread_priorities_dirty;
+      custom_component = state.custom_component;
+      cur_thread.Invalidate();
+      cur_thread.id = max_thread_space;
+    }
+
     /// Full hardware reset.
     void Reset() {
-      ResetImpl();
+      GetHardware().ResetImpl();
       ResetBaseHardwareState();
     }
 
@@ -348,6 +561,12 @@ namespace sgp {
     /// Set the custom component.
     void SetCustomComponent(const custom_comp_t & val) { custom_component = val; }
 
+    /// Get a reference to this hardware's instrumentation (see INSTRUMENTATION_T).
+    instrumentation_t & GetInstrumentation() { return instrumentation; }
+
+    /// Get a const reference to this hardware's instrumentation.
+    const instrumentation_t & GetInstrumentation() const { return instrumentation; }
+
     /// Get the maximum number of threads allowed to run simultaneously on this hardware object.
     size_t GetMaxActiveThreads() const { return max_active_threads; }
 
@@ -378,14 +597,18 @@ namespace sgp {
     /// - mark a dead thread as running or pending
     /// TIP: you can use emp_assert(ValidateThreadState()) after doing whatever it is you want to do
     /// to assert that the thread management system is in a safe state.
-    emp::vector<thread_t> & GetThreads() { return threads; }
+    emp::vector<thread_t> & GetThreads() { thread_priorities_dirty = true; return threads; }
 
     /// Get a reference to a particular thread.
-    thread_t & GetThread(size_t i) { emp_assert(i < threads.size()); return threads[i]; }
+    thread_t & GetThread(size_t i) {
+      emp_assert(i < threads.size());
+      thread_priorities_dirty = true; // Caller might change the thread's priority.
+      return threads[i];
+    }
     const thread_t & GetThread(size_t i) const { emp_assert(i < threads.size()); return threads[i]; }
 
     /// Get const reference to vector of currently active threads active.
-    const std::unordered_set<size_t> & GetActiveThreadIDs() const { return active_threads; }
+    const ThreadIDSet & GetActiveThreadIDs() const { return active_threads; }
 
     /// Get const reference to threads that are not currently active.
     const emp::vector<size_t> & GetUnusedThreadIDs() const { return unused_threads; }
@@ -426,6 +649,30 @@ namespace sgp {
     /// Should this hardware use thread priority?
     void SetThreadPriorityUse(bool use_priority=true) { use_thread_priority = use_priority; }
 
+    /// Set the priority of the given thread.
+    /// (Cheaper than changing the priority through GetThread, which requires the hardware to double
+    /// check every active/pending thread's priority before activating pending threads.)
+    void SetThreadPriority(size_t thread_id, double priority) {
+      emp_assert(thread_id < threads.size(), "Thread ID is invalid.", thread_id);
+      threads[thread_id].SetPriority(priority);
+      SyncThreadPriority(thread_id);
+    }
+
+    /// Get the maximum number of execution steps each active thread takes per SingleProcess.
+    size_t GetThreadQuantum() const { return thread_quantum; }
+
+    /// Set the maximum number of execution steps each active thread takes per SingleProcess (default: 1).
+    /// Each thread runs for up to quantum steps (stopping early if it dies) before the next thread
+    /// gets to run. Events queued and threads spawned during a SingleProcess are still only handled
+    /// and activated at the start of the next SingleProcess, i.e., after every active thread has
+    /// used up its quantum.
+    /// Larger quanta amortize SingleProcess's per-thread bookkeeping over more execution steps, which
+    /// pays off for programs that run few threads for many steps.
+    void SetThreadQuantum(size_t quantum) {
+      emp_assert(quantum > 0, "Thread quantum must be at least 1.");
+      thread_quantum = quantum;
+    }
+
     /// TODO - TEST
     /// Set this hardware's active thread limit (i.e., the maximum number of threads that can be running
     /// simultaneously).
@@ -453,14 +700,14 @@ namespace sgp {
     /// if executing: mark as dead
     bool KillActiveThread(size_t thread_id) {
       emp_assert(thread_id < threads.size(), "Thread ID is invalid.");
-      auto & thread = GetThread(thread_id);
+      thread_t & thread = threads[thread_id];
       if (!thread.IsRunning()) return false;
       // If hardware is executing, mark thread as dead. Let SingleProcess actually kill the thread.
       // Otherwise, assert the thread is in active threads and actually kill the thread.
       if (is_executing) {
         thread.SetDead();
       } else {
-        emp_assert(emp::Has(active_threads, thread_id), "thread_id not found in active threads", thread_id);
+        emp_assert(active_threads.Has(thread_id), "thread_id not found in active threads", thread_id);
         KillActiveThread_impl(thread_id);
       }
       return true;
@@ -504,20 +751,91 @@ namespace sgp {
 
     /// Handle an event (on this hardware) now!
     template<typename EVENT_T>
-    void HandleEvent(const EVENT_T & event) { event_lib.HandleEvent(GetHardware(), event); }
+    void HandleEvent(const EVENT_T & event) {
+      instrumentation.OnEvent(event_lib_t::GetEventID(event));
+      event_lib.HandleEvent(GetHardware(), event);
+    }
 
     /// Trigger an event (from this hardware).
     template<typename EVENT_T>
     void TriggerEvent(const EVENT_T & event) { event_lib.TriggerEvent(GetHardware(), event); }
 
     /// Queue an event (to be handled by this hardware) next time this hardware
-    /// unit is executed.
+    /// unit is executed. A SharedEvent is queued by reference rather than copied (see
+    /// EventLibrary::BroadcastEvent).
     template<typename EVENT_T>
     void QueueEvent(const EVENT_T & event) {
-      event_queue.emplace_back(std::make_shared<EVENT_T>(event));
+      event_queue.Push(event);
     }
 
-    /// Advance the hardware by a single step.
+    /// Schedule an event to be handled by this hardware delay steps after the next time this
+    /// hardware is executed: delay 0 is the next SingleProcess (like QueueEvent), delay 1 the one
+    /// after that, and so on. Scheduled events are kept in a timer wheel (see EventTimerWheel), so
+    /// any number of events can be scheduled at O(1) amortized cost per event per step. Resets
+    /// clear scheduled events.
+    template<typename EVENT_T>
+    void ScheduleEvent(const EVENT_T & event, size_t delay) {
+      if (!timer_wheel) timer_wheel.emplace();
+      timer_wheel->Schedule(event, delay);
+    }
+
+    /// Schedule an event to be handled by this hardware delay steps after the next time this
+    /// hardware is executed (see ScheduleEvent), and then every period steps after that, until
+    /// canceled (CancelRepeatingEvent) or the hardware is reset.
+    /// @return ID of the repeating event.
+    template<typename EVENT_T>
+    size_t ScheduleRepeatingEvent(const EVENT_T & event, size_t period, size_t delay=0) {
+      if (!timer_wheel) timer_wheel.emplace();
+      return timer_wheel->ScheduleRepeating(event, period, delay);
+    }
+
+    /// Stop a repeating event (see ScheduleRepeatingEvent).
+    /// @return Whether the event was repeating.
+    bool CancelRepeatingEvent(size_t id) { return timer_wheel && timer_wheel->CancelRepeating(id); }
+
+    /// How many events are scheduled for later steps?
+    size_t GetNumScheduledEvents() const { return timer_wheel ? timer_wheel->GetSize() : 0; }
+
+    /// Give this hardware an inbox that other threads can post events to (see PostEvent), replacing
+    /// any existing inbox. The inbox holds up to capacity events (rounded up to a power of two);
+    /// policy says what posting to a full inbox does (drop the event or wait for room).
+    /// Not thread-safe: enable the inbox before any other thread posts to it.
+    void EnableEventInbox(size_t capacity=1024,
+                          typename event_inbox_t::FullPolicy policy=event_inbox_t::FullPolicy::DROP) {
+      event_inbox.emplace(capacity, policy);
+    }
+
+    /// Remove this hardware's event inbox (dropping any events in it).
+    /// Not thread-safe: no other threads may be posting to the inbox.
+    void DisableEventInbox() { event_inbox.reset(); }
+
+    /// Does this hardware have an event inbox?
+    bool HasEventInbox() const { return event_inbox.has_value(); }
+
+    /// Get this hardware's event inbox (e.g., to check its counters).
+    event_inbox_t & GetEventInbox() {
+      emp_assert(event_inbox, "Hardware has no event inbox (see EnableEventInbox).");
+      return *event_inbox;
+    }
+
+    /// Get this hardware's event inbox (e.g., to check its counters).
+    const event_inbox_t & GetEventInbox() const {
+      emp_assert(event_inbox, "Hardware has no event inbox (see EnableEventInbox).");
+      return *event_inbox;
+    }
+
+    /// Post an event (to be handled by this hardware) from any thread. Posted events are moved to the
+    /// event queue at the start of the next SingleProcess. Requires an event inbox (EnableEventInbox).
+    /// @return Whether the event was posted (false if the inbox was full and dropped it).
+    template<typename EVENT_T>
+    bool PostEvent(const EVENT_T & event) {
+      emp_assert(event_inbox, "Hardware has no event inbox (see EnableEventInbox).");
+      if constexpr (std::is_base_of<event_t, EVENT_T>::value) return event_inbox->Push(event);
+      else return event_inbox->Push(event_t(event)); // (e.g., a StaticEventLibrary event.)
+    }
+
+    /// Advance the hardware by a single step (in which every active thread executes up to
+    /// GetThreadQuantum() execution steps).
     void SingleProcess();
 
     /// Advance hardware by some arbitrary number of steps.
@@ -576,8 +894,8 @@ namespace sgp {
 
   // -------------------- SignalGPBase method implementations --------------------
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::ActivatePendingThreads()
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::ActivatePendingThreads()
   {
     emp_assert(!is_executing, "Cannot ActivatePendingThreads while hardware is executing.");
     // emp_assert(ValidateThreadState()); => Slow!
@@ -604,89 +922,41 @@ namespace sgp {
       }
 
     } else {
-      // std::cout << "Making use of thread priority for activating pending." << std::endl;
-      // Use Thread priority for deciding which threads to activate:
-      // - (1) Order pending threads by max priority.
-      // - (2) Order active threads by min priority (only those < max pending).
-      // - (3) For each pending thread (while pending.max > active.min), activate pending.
-
-      // (1) Order pending threads by max priority (MAX heap).
-      //     + find max pending priority, use to bound which active threads we consider killing.
-      std::priority_queue<std::tuple<double, size_t>,
-                          std::vector<std::tuple<double, size_t>>> pending_priorities_MAX; // MAX HEAP
-      double max_pending_priority = threads[pending_threads.front()].GetPriority();
-      for (size_t pending_id : pending_threads) {
-        emp_assert(pending_id < threads.size());
-        emp_assert(threads[pending_id].IsPending());
-        const double priority = threads[pending_id].GetPriority();
-        pending_priorities_MAX.emplace(std::make_tuple(priority, pending_id));
-        if (priority > max_pending_priority) max_pending_priority = priority;
-      }
-
-      // (2) Order active threads (priority < max pending) by min priority (MIN heap).
-      //     Only include threads with priority < max_pending_priority
-      std::priority_queue<std::tuple<double, size_t>,
-                          std::vector<std::tuple<double, size_t>>,
-                          std::greater<std::tuple<double, size_t>>> active_priorities_MIN; // MIN heap.
-      for (size_t active_id : active_threads) {
-        emp_assert(active_id < threads.size());
-        thread_t & thread = threads[active_id];
-        if (thread.GetPriority() < max_pending_priority) {
-          active_priorities_MIN.emplace(std::make_tuple(thread.GetPriority(), active_id));
-        }
-      }
-
-      // (3) For each pending thread (while pending.max > active.min), activate pending.
-      // - Because we can't efficiently remove elements from the pending queue, track which pending
-      //   ids we want to spawn and which we don't.
-
-      // Map from each pending thread we want to activate to the active thread it will replace.
-      std::unordered_map<size_t, std::pair<bool, size_t>> pending_to_active;
-
-      // First, mark as many pending threads (in max priority order) to be set to active as there is
-      // space.
-      while (((pending_to_active.size() + active_threads.size()) < max_active_threads) && pending_priorities_MAX.size()) {
-        const size_t pending_id_MAX = std::get<1>(pending_priorities_MAX.top());
-        pending_to_active.emplace(pending_id_MAX, std::make_pair(false, max_thread_space));
-        pending_priorities_MAX.pop();
-      }
-
-      // Are there any active thread_ids (+priorities) to consider killing?
-      // To activate any more pending threads, we will need to kill a currently active thread.
-      while (active_priorities_MIN.size() && pending_priorities_MAX.size()) {
-        const double pending_priority_MAX = std::get<0>(pending_priorities_MAX.top());
-        const double active_priority_MIN = std::get<0>(active_priorities_MIN.top());
-        if (pending_priority_MAX > active_priority_MIN) {
-          const size_t pending_id_MAX = std::get<1>(pending_priorities_MAX.top());
-          const size_t active_id_MIN = std::get<1>(active_priorities_MIN.top());
-          pending_to_active.emplace(pending_id_MAX, std::make_pair(true, active_id_MIN)); // Map current pending id to current active id.
-          pending_priorities_MAX.pop();
-          active_priorities_MIN.pop();
+      // Use thread priority for deciding which threads to activate. Pending and active threads are
+      // already ordered by priority (pending_max_heap, active_min_heap).
+      SyncThreadPriorities();
+      if (activation_victims.size() < threads.size()) activation_victims.resize(threads.size());
+
+      // (1) Choose which pending threads to activate, highest priority first: fill any open active
+      //     slots, then replace lowest-priority active threads while the pending thread has higher
+      //     priority. Chosen pending threads are popped off the pending heaps.
+      size_t num_active = active_threads.size();
+      while (pending_max_heap.size()) {
+        const size_t pending_id = pending_max_heap.Top();
+        if (num_active < max_active_threads) {
+          ++num_active;
+          activation_victims[pending_id] = max_thread_space; // No need to kill an active thread.
+        } else if (active_min_heap.size() && pending_max_heap.TopPriority() > active_min_heap.TopPriority()) {
+          activation_victims[pending_id] = active_min_heap.Top();
+          active_min_heap.Pop();
         } else {
-          break; // If we ever hit a pending priority that is <= the min active priority, break.
+          break; // Remaining pending threads don't get to run.
         }
+        pending_max_heap.Pop();
+        pending_min_heap.Remove(pending_id);
       }
 
-      // For each pending thread, if we marked it to transition to active,
-      // activate it and kill associated active; otherwise, deny it (mark it as dead, move to unused).
-      // std::cout << "  Processing pending threads" << std::endl;
+      // (2) For each pending thread (in order of arrival), if we chose to activate it, kill the
+      //     active thread it replaces (if any) and activate it; otherwise, deny it (mark it as dead,
+      //     move to unused).
       while (pending_threads.size()) {
         const size_t pending_id = pending_threads.front();
-        // std::cout << "  > pending id=" << pending_id << std::endl;
-        if (emp::Has(pending_to_active, pending_id)) {
-          // std::cout << "    Should activate this pthread (" << threads[pending_id].GetPriority() << ")" << std::endl;
-          if (pending_to_active[pending_id].first) {
-            // Need to kill associated active.
-            const size_t active_id = pending_to_active[pending_id].second;
-            // std::cout << "    Need to first kill an active thread (" << active_id << std::endl;
-            KillActiveThread_impl(active_id);
-            // std::cout << "    Killed active." << std::endl;
-          }
-          // std::cout << "    Activate this thread now." << std::endl;
+        if (!pending_max_heap.Has(pending_id)) {
+          const size_t active_id = activation_victims[pending_id];
+          if (active_id != max_thread_space) KillActiveThread_impl(active_id);
           ActivateThread(pending_id);
           pending_threads.pop_front();
         } else {
-          // Kill this pending thread.
           KillNextPendingThread();
         }
       }
@@ -699,16 +969,16 @@ namespace sgp {
   }
 
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SetActiveThreadLimit_impl(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SetActiveThreadLimit_impl(
     size_t n
   ) {
     if (use_thread_priority) SetActiveThreadLimit_UsePriority_impl(n);
     else SetActiveThreadLimit_NoPriority_impl(n);
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SetActiveThreadLimit_UsePriority_impl(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SetActiveThreadLimit_UsePriority_impl(
     size_t n
   ) {
     max_thread_space = std::max(n, max_thread_space);
@@ -725,11 +995,9 @@ namespace sgp {
       emp_assert(thread_exec_order.size() >= active_threads.size());
       const size_t num_kill = active_threads.size() - n;
       // Kill smallest-priority threads.
-      emp::vector<size_t> ids(active_threads.begin(), active_threads.end());
-      std::partial_sort(ids.begin(), ids.begin()+num_kill, ids.end(),
-                        [this](size_t id_a, size_t id_b){ return threads[id_a].GetPriority() < threads[id_b].GetPriority(); });
+      SyncThreadPriorities();
       for (size_t i = 0; i < num_kill; ++i) {
-        const size_t thread_id = ids[i];
+        const size_t thread_id = active_min_heap.Top();
         emp_assert(threads[thread_id].IsRunning());
         KillActiveThread_impl(thread_id);
       }
@@ -745,8 +1013,8 @@ namespace sgp {
     max_active_threads = n;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SetActiveThreadLimit_NoPriority_impl(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SetActiveThreadLimit_NoPriority_impl(
     size_t n
   ) {
     max_thread_space = std::max(n, max_thread_space);
@@ -778,17 +1046,18 @@ namespace sgp {
     max_active_threads = n;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::ResetBaseHardwareState()
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::ResetBaseHardwareState()
   {
     emp_assert(!is_executing, "Cannot reset hardware while executing.");
     ClearEventQueue();
+    ClearScheduledEvents();
     ResetThreads();
     is_executing = false;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SetActiveThreadLimit(size_t n) {
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SetActiveThreadLimit(size_t n) {
     emp_assert(n, "Max active thread limit must be > 0.", n);
     emp_assert(!is_executing, "Cannot adjust SignalGP hardware max thread count while executing.");
     // NOTE - this cannot DECREASE the capacity of the 'threads' member variable.
@@ -797,8 +1066,8 @@ namespace sgp {
     SetActiveThreadLimit_impl(n);
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SetThreadCapacity(size_t n)
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SetThreadCapacity(size_t n)
   {
     emp_assert(n, "Max thread count must be greater than 0.");
     emp_assert(!is_executing, "Cannot adjust SignalGP hardware max thread count while executing.");
@@ -819,11 +1088,17 @@ namespace sgp {
       for (size_t id : unused_threads) {
         if (id < n) new_unused_threads.emplace_back(id);
       }
-      for (size_t id : new_pending_threads) {
+      for (size_t id : pending_threads) {
         if (id < n) new_pending_threads.emplace_back(id);
+        else RemovePendingFromHeaps(id);
       }
-      for (size_t id : active_threads) {
-        if (id >= n) active_threads.erase(n);
+      // (erase swaps the last id into the erased slot, so walk backwards)
+      for (size_t i = active_threads.size(); i-- > 0;) {
+        const size_t id = active_threads[i];
+        if (id >= n) {
+          active_threads.erase(id);
+          active_min_heap.Remove(id);
+        }
       }
       thread_exec_order = new_thread_exec_order;
       unused_threads = new_unused_threads;
@@ -833,19 +1108,20 @@ namespace sgp {
     max_thread_space = n;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::RemoveAllPendingThreads()
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::RemoveAllPendingThreads()
   {
     while (pending_threads.size()) {
       const size_t thread_id = pending_threads.back();
       pending_threads.pop_back();
+      RemovePendingFromHeaps(thread_id);
       threads[thread_id].Reset(); // this should be safe
       unused_threads.emplace_back(thread_id);
     }
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  emp::vector<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SpawnThreads(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  emp::vector<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SpawnThreads(
     const tag_t & tag, size_t n, double priority
   ) {
     emp::vector<module_id_t> matches(GetHardware().FindModuleMatch(tag, n));
@@ -859,16 +1135,16 @@ namespace sgp {
     return thread_ids;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  std::optional<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SpawnThreadWithTag(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  std::optional<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SpawnThreadWithTag(
     const tag_t & tag, double priority
   ) {
     emp::vector<module_id_t> match(GetHardware().FindModuleMatch(tag, 1));
     return (match.size()) ? SpawnThreadWithID(match[0], priority) : std::nullopt;
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  std::optional<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SpawnThreadWithID(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  std::optional<size_t> SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SpawnThreadWithID(
     module_id_t module_id, double priority
   ) {
     size_t thread_id;
@@ -883,17 +1159,15 @@ namespace sgp {
       thread_id = threads.size();
       threads.emplace_back();
     } else if (use_thread_priority && pending_threads.size()) {
-      // Is there a pending thread w/lower priority?
-      size_t min_priority_pending_id = pending_threads.front();
-      for (size_t pending_id : pending_threads) {
-        if (threads[pending_id].GetPriority() < threads[min_priority_pending_id].GetPriority()) {
-          min_priority_pending_id = pending_id;
-        }
-      }
+      // Is there a pending thread w/lower priority? (Among equally low-priority pending threads,
+      // displace the one that has been pending the longest.)
+      SyncThreadPriorities();
+      const size_t min_priority_pending_id = pending_min_heap.Top();
       // If so, use it. Otherwise, return nullopt.
-      if (priority > threads[min_priority_pending_id].GetPriority()) {
+      if (priority > pending_min_heap.TopPriority()) {
         thread_id = min_priority_pending_id;
         already_pending = true;
+        instrumentation.OnThreadKill(); // Displaced pending thread.
       } else {
         return std::nullopt;
       }
@@ -915,18 +1189,33 @@ namespace sgp {
 
     // Mark thread as pending.
     thread.SetPending();
-    if (!already_pending) pending_threads.emplace_back(thread_id);
+    if (already_pending) {
+      pending_max_heap.Update(thread_id, thread.GetPriority());
+      pending_min_heap.Update(thread_id, thread.GetPriority());
+    } else {
+      pending_threads.emplace_back(thread_id);
+      AddPendingToHeaps(thread_id);
+    }
 
+    instrumentation.OnThreadSpawn(module_id);
     return std::optional<size_t>{thread_id}; // this could mess with thread priority level!
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::SingleProcess()
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::SingleProcess()
   {
+    // Queue scheduled events that are due this step.
+    if (timer_wheel) timer_wheel->Advance(event_queue);
+
+    // Collect events posted from other threads (at most one inbox's worth, so producers
+    // can't keep this step from finishing).
+    if (event_inbox) event_inbox->DrainInto(event_queue, event_inbox->GetCapacity());
+
     // Handle events (which may spawn threads)
+    // (Handlers may queue more events; those get handled now, too.)
     while (!event_queue.empty()) {
-      HandleEvent(*(event_queue.front()));
-      event_queue.pop_front();
+      HandleEvent(event_queue.Front());
+      event_queue.PopFront();
     }
 
     // Activate all pending threads. (which may kill currently active threads)
@@ -955,7 +1244,7 @@ namespace sgp {
       // Is this a valid thread id?
       if (cur_thread.id >= threads.size()) {
         // If this thread is active, kill it.
-        if (emp::Has(active_threads, cur_thread.ID())) KillActiveThread_impl(cur_thread.ID());
+        if (active_threads.Has(cur_thread.ID())) KillActiveThread_impl(cur_thread.ID());
         ++adjust;
         ++exec_order_id;
         continue;
@@ -963,14 +1252,20 @@ namespace sgp {
       // Is this thread dead?
       if (threads[cur_thread.ID()].IsDead()) {
         // If this thread is active, kill it.
-        if (emp::Has(active_threads, cur_thread.ID())) KillActiveThread_impl(cur_thread.ID());
+        if (active_threads.Has(cur_thread.ID())) KillActiveThread_impl(cur_thread.ID());
         ++adjust;
         ++exec_order_id;
         continue;
       }
 
-      // Execute the thread (defined by derived class)
+      // Execute the thread (defined by derived class) for up to thread_quantum steps.
+      // (Re-index threads every step: spawning threads may grow the threads vector.)
       GetHardware().SingleExecutionStep(GetHardware(), threads[cur_thread.ID()]);
+      for (size_t step = 1; step < thread_quantum && !threads[cur_thread.ID()].IsDead(); ++step) {
+        GetHardware().SingleExecutionStep(GetHardware(), threads[cur_thread.ID()]);
+      }
+      // Did the thread change its own priority?
+      SyncThreadPriority(cur_thread.ID());
 
       // Did the thread die?
       if (threads[cur_thread.ID()].IsDead()) {
@@ -990,8 +1285,8 @@ namespace sgp {
     cur_thread.Invalidate();
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::PrintThreadUsage(
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  void SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::PrintThreadUsage(
     std::ostream & os
   ) const {
     // All threads (and state)
@@ -1044,8 +1339,8 @@ namespace sgp {
     os << "]";
   }
 
-  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T>
-  bool SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T>::ValidateThreadState() {
+  template<typename DERIVED_T, typename EXEC_STATE_T, typename TAG_T, typename CUSTOM_COMPONENT_T, typename INSTRUMENTATION_T, typename EVENT_LIB_T>
+  bool SignalGPBase<DERIVED_T, EXEC_STATE_T, TAG_T, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>::ValidateThreadState() {
     emp_assert(!is_executing);
     // (1) Thread storage should not exceed max_thread_capacity
     if (threads.size() > max_thread_space) return false;
@@ -1082,6 +1377,19 @@ namespace sgp {
     for (size_t id : active_threads) {
       if (threads[id].IsPending()) return false;
     }
+    // (8) Priority heaps should track exactly the active/pending threads (at their current priorities
+    //     unless priorities might have been changed directly).
+    if (active_min_heap.size() != active_threads.size()) return false;
+    if (pending_max_heap.size() != pending_threads.size()) return false;
+    if (pending_min_heap.size() != pending_threads.size()) return false;
+    for (size_t id : active_threads) {
+      if (!active_min_heap.Has(id)) return false;
+      if (!thread_priorities_dirty && active_min_heap.GetPriority(id) != threads[id].GetPriority()) return false;
+    }
+    for (size_t id : pending_threads) {
+      if (!pending_max_heap.Has(id) || !pending_min_heap.Has(id)) return false;
+      if (!thread_priorities_dirty && pending_max_heap.GetPriority(id) != threads[id].GetPriority()) return false;
+    }
     // If all of that passed, return true (i.e., thread management is valid).
     return true;
   }
@@ -0,0 +1,228 @@
+#ifndef EMP_SIGNALGP_STATIC_EVENT_LIBRARY_H
+#define EMP_SIGNALGP_STATIC_EVENT_LIBRARY_H
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+namespace sgp {
+
+  namespace internal {
+    template<typename EVENT_T, typename=void>
+    struct HasPrint : std::false_type { };
+    template<typename EVENT_T>
+    struct HasPrint<EVENT_T, std::void_t<decltype(std::declval<const EVENT_T&>().Print(std::declval<std::ostream&>()))>>
+      : std::true_type { };
+  }
+
+  /// FIFO queue of events of a fixed set of types (EVENTS...), each stored by value as a
+  /// std::variant<EVENTS...>.
+  /// - Events are stored in fixed-size blocks that are kept and reused, so once the queue has grown
+  ///   to fit the largest burst of events, queueing never allocates; whenever the queue empties, it
+  ///   is rewound in O(1).
+  /// - Queued events never move, so references returned by Front remain valid until popped, even
+  ///   if more events are pushed in the meantime.
+  /// (Same interface as EventQueue.)
+  template<typename... EVENTS>
+  class StaticEventQueue {
+  public:
+    using event_t = std::variant<EVENTS...>;
+    static constexpr size_t BLOCK_EVENTS = 64;  ///< Events per block.
+
+  protected:
+    struct Slot {
+      alignas(event_t) unsigned char data[sizeof(event_t)];
+    };
+
+    emp::vector<std::unique_ptr<Slot[]>> blocks;  ///< Event storage. Never shrinks.
+    size_t head=0;                                ///< Position of front of the queue.
+    size_t tail=0;                                ///< Position past the back of the queue.
+
+    void * GetSlot(size_t pos) const { return blocks[pos / BLOCK_EVENTS][pos % BLOCK_EVENTS].data; }
+    event_t & Get(size_t pos) const { return *std::launder(reinterpret_cast<event_t *>(GetSlot(pos))); }
+
+    /// Get the slot for the next pushed event.
+    void * NextSlot() {
+      if (tail / BLOCK_EVENTS == blocks.size()) blocks.emplace_back(new Slot[BLOCK_EVENTS]);
+      return GetSlot(tail);
+    }
+
+    /// Destroy all events in [head, tail).
+    void DestroyLive() {
+      for (size_t pos = head; pos < tail; ++pos) Get(pos).~event_t();
+    }
+
+    void CopyLive(const StaticEventQueue & other) {
+      for (size_t pos = other.head; pos < other.tail; ++pos) Push(other.Get(pos));
+    }
+
+  public:
+    StaticEventQueue() : blocks() { ; }
+    StaticEventQueue(const StaticEventQueue & other) : blocks() { CopyLive(other); }
+    StaticEventQueue(StaticEventQueue && other)
+      : blocks(std::move(other.blocks)), head(other.head), tail(other.tail)
+    {
+      other.blocks.clear();
+      other.head = 0;
+      other.tail = 0;
+    }
+    ~StaticEventQueue() { DestroyLive(); }
+
+    StaticEventQueue & operator=(const StaticEventQueue & other) {
+      if (this == &other) return *this;
+      Clear();
+      CopyLive(other);
+      return *this;
+    }
+
+    StaticEventQueue & operator=(StaticEventQueue && other) {
+      if (this == &other) return *this;
+      DestroyLive();
+      blocks = std::move(other.blocks);
+      head = other.head;
+      tail = other.tail;
+      other.blocks.clear();
+      other.head = 0;
+      other.tail = 0;
+      return *this;
+    }
+
+    size_t size() const { return tail - head; }
+    bool empty() const { return head == tail; }
+
+    /// Add a copy of the given event to the back of the queue.
+    template<typename EVENT_T>
+    void Push(const EVENT_T & event) {
+      static_assert((std::is_same<EVENT_T, EVENTS>::value || ...), "Queued events must be one of the queue's event types.");
+      new (NextSlot()) event_t(std::in_place_type<EVENT_T>, event);
+      ++tail;
+    }
+
+    /// Add a copy of the given event to the back of the queue.
+    void Push(const event_t & event) {
+      new (NextSlot()) event_t(event);
+      ++tail;
+    }
+
+    /// Add a copy of other[i] to the back of the queue.
+    void PushFrom(const StaticEventQueue & other, size_t i) { Push(other[i]); }
+
+    /// Get the event at the front of the queue.
+    const event_t & Front() const {
+      emp_assert(!empty(), "Event queue is empty.");
+      return Get(head);
+    }
+
+    /// Get the i'th queued event (0 is the front).
+    const event_t & operator[](size_t i) const {
+      emp_assert(i < size(), i, size());
+      return Get(head + i);
+    }
+
+    /// Remove (and destroy) the event at the front of the queue.
+    void PopFront() {
+      emp_assert(!empty(), "Event queue is empty.");
+      Get(head).~event_t();
+      ++head;
+      if (head == tail) {
+        head = 0;
+        tail = 0;
+      }
+    }
+
+    /// Remove all events from the queue (keeping memory for reuse).
+    void Clear() {
+      DestroyLive();
+      head = 0;
+      tail = 0;
+    }
+
+    void clear() { Clear(); }
+  };
+
+  /// Event library for a fixed set of event types (EVENTS...), known at compile time.
+  /// An alternative to EventLibrary for hardware (see SignalGPBase's EVENT_LIB_T): events don't need
+  /// to derive from BaseEvent, hardware queues them by value (as std::variant<EVENTS...>, see
+  /// StaticEventQueue), and handlers are resolved at compile time (with std::visit), so handling an
+  /// event involves no virtual calls, std::functions, or heap allocation.
+  /// - An event's ID is the position of its type in EVENTS.
+  /// - HANDLERS_T must have a (const) Handle(hw, event) for every event type, and, to trigger events
+  ///   (TriggerEvent), a (const) Dispatch(hw, event) for every event type. Hardware types depend on
+  ///   their event library, so these are usually templates on the hardware type; e.g.,
+  ///     struct Handlers {
+  ///       template<typename HW> void Handle(HW & hw, const PingEvent & event) const { ... }
+  ///       template<typename HW> void Handle(HW & hw, const PongEvent & event) const { ... }
+  ///     };
+  ///     using event_lib_t = sgp::StaticEventLibrary<Handlers, PingEvent, PongEvent>;
+  /// - Events are printed with their Print(os) method, if they have one (otherwise as {id:ID}).
+  template<typename HANDLERS_T, typename... EVENTS>
+  class StaticEventLibrary {
+  public:
+    using handlers_t = HANDLERS_T;
+    using event_t = std::variant<EVENTS...>;
+    using event_queue_t = StaticEventQueue<EVENTS...>;   ///< Queue hardware uses for these events.
+
+  protected:
+    handlers_t handlers;
+
+  public:
+    StaticEventLibrary(const handlers_t & _handlers=handlers_t()) : handlers(_handlers) { ; }
+
+    handlers_t & GetHandlers() { return handlers; }
+    const handlers_t & GetHandlers() const { return handlers; }
+
+    /// Get the number of event types in this library.
+    static constexpr size_t GetSize() { return sizeof...(EVENTS); }
+
+    /// Get the event ID of the given event type.
+    template<typename EVENT_T>
+    static constexpr size_t GetID() {
+      static_assert((std::is_same<EVENT_T, EVENTS>::value || ...), "Event type is not in the event library.");
+      constexpr bool matches[] = {std::is_same<EVENT_T, EVENTS>::value...};
+      size_t id = 0;
+      while (!matches[id]) ++id;
+      return id;
+    }
+
+    /// Get the event ID of the given event.
+    template<typename EVENT_T>
+    static constexpr size_t GetEventID(const EVENT_T & event) { return GetID<EVENT_T>(); }
+    static size_t GetEventID(const event_t & event) { return event.index(); }
+
+    /// Print the given event (default event printing for hardware).
+    static void PrintEvent(const event_t & event, std::ostream & os) {
+      std::visit([&os, &event](const auto & e) {
+        if constexpr (internal::HasPrint<std::decay_t<decltype(e)>>::value) e.Print(os);
+        else os << "{id:" << event.index() << "}";
+      }, event);
+    }
+
+    /// Trigger an event.
+    template<typename HARDWARE_T, typename EVENT_T>
+    void TriggerEvent(HARDWARE_T & hw, const EVENT_T & event) const { handlers.Dispatch(hw, event); }
+
+    template<typename HARDWARE_T>
+    void TriggerEvent(HARDWARE_T & hw, const event_t & event) const {
+      std::visit([this, &hw](const auto & e) { handlers.Dispatch(hw, e); }, event);
+    }
+
+    /// Handle an event.
+    template<typename HARDWARE_T, typename EVENT_T>
+    void HandleEvent(HARDWARE_T & hw, const EVENT_T & event) const { handlers.Handle(hw, event); }
+
+    template<typename HARDWARE_T>
+    void HandleEvent(HARDWARE_T & hw, const event_t & event) const {
+      std::visit([this, &hw](const auto & e) { handlers.Handle(hw, e); }, event);
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef EMP_SIGNALGP_THREAD_ID_SET_H
+#define EMP_SIGNALGP_THREAD_ID_SET_H
+
+#include <cstddef>
+#include <limits>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+namespace sgp {
+
+  /// Set of (small, dense) thread ids, stored as a sparse set.
+  /// - ids is a packed list of the members (in no particular order); iteration walks it directly.
+  /// - positions maps every id seen so far to its index in ids (or NONE if not a member), so
+  ///   membership tests, inserts, and erases are all O(1) without hashing.
+  /// - Erase moves the last member into the erased member's slot; as with std::unordered_set,
+  ///   do not rely on iteration order, and erasing invalidates iterators.
+  /// Supports the subset of the std::unordered_set<size_t> interface used to track threads
+  /// (size, empty, count, insert/emplace, erase, clear, begin/end, ==).
+  class ThreadIDSet {
+  public:
+    using value_type = size_t;
+    using const_iterator = typename emp::vector<size_t>::const_iterator;
+    using iterator = const_iterator;
+
+  protected:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    emp::vector<size_t> ids;        ///< Members, packed.
+    emp::vector<size_t> positions;  ///< positions[id] = index of id in ids (NONE if id not a member).
+
+  public:
+    ThreadIDSet() : ids(), positions() { ; }
+
+    /// Create an empty set with room for ids in [0, capacity).
+    ThreadIDSet(size_t capacity) : ids(), positions(capacity, NONE) { ids.reserve(capacity); }
+
+    /// How many ids are in the set?
+    size_t size() const { return ids.size(); }
+
+    /// Is the set empty?
+    bool empty() const { return ids.empty(); }
+
+    /// Is id in the set?
+    bool Has(size_t id) const { return id < positions.size() && positions[id] != NONE; }
+
+    /// How many times is id in the set? (0 or 1)
+    size_t count(size_t id) const { return (size_t)Has(id); }
+
+    /// Make room for ids in [0, capacity) (inserting larger ids is still allowed).
+    void Reserve(size_t capacity) {
+      if (capacity > positions.size()) positions.resize(capacity, NONE);
+      ids.reserve(capacity);
+    }
+
+    /// Add id to the set. Returns false if id was already a member.
+    bool insert(size_t id) {
+      emp_assert(id != NONE);
+      if (id >= positions.size()) positions.resize(id + 1, NONE);
+      if (positions[id] != NONE) return false;
+      positions[id] = ids.size();
+      ids.emplace_back(id);
+      return true;
+    }
+
+    /// (alias for insert)
+    bool emplace(size_t id) { return insert(id); }
+
+    /// Remove id from the set. Returns the number of ids removed (0 or 1).
+    size_t erase(size_t id) {
+      if (!Has(id)) return 0;
+      const size_t pos = positions[id];
+      const size_t last = ids.back();
+      ids[pos] = last;
+      positions[last] = pos;
+      ids.pop_back();
+      positions[id] = NONE;
+      return 1;
+    }
+
+    /// Remove every id from the set. O(size()).
+    void clear() {
+      for (size_t id : ids) positions[id] = NONE;
+      ids.clear();
+    }
+
+    const_iterator begin() const { return ids.begin(); }
+    const_iterator end() const { return ids.end(); }
+
+    /// Get the i'th member (in iteration order).
+    size_t operator[](size_t i) const { emp_assert(i < ids.size(), i, ids.size()); return ids[i]; }
+
+    /// Sets are equal if they have the same members (regardless of order).
+    bool operator==(const ThreadIDSet & other) const {
+      if (size() != other.size()) return false;
+      for (size_t id : ids) {
+        if (!other.Has(id)) return false;
+      }
+      return true;
+    }
+
+    bool operator!=(const ThreadIDSet & other) const { return !(*this == other); }
+  };
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef EMP_SIGNALGP_THREAD_PRIORITY_HEAP_H
+#define EMP_SIGNALGP_THREAD_PRIORITY_HEAP_H
+
+#include <cstddef>
+#include <limits>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+namespace sgp {
+
+  /// Indexed binary heap of (small, dense) thread ids, ordered by thread priority.
+  /// - MAX_HEAP=true: Top is the highest-priority thread; otherwise, Top is the lowest-priority thread.
+  /// - Ties are broken by each thread's order key (larger keys first for max heaps, smaller keys first
+  ///   for min heaps). By default, a thread's order key is its id.
+  /// - Every id in the heap knows its position, so Has is O(1) and Remove/Update (i.e., priority
+  ///   changes) are O(log n) without searching the heap.
+  /// - The heap stores its own copy of each thread's priority; it must be told (via Update) when a
+  ///   thread's priority changes.
+  template<bool MAX_HEAP>
+  class ThreadPriorityHeap {
+  protected:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    struct Node {
+      double priority;
+      size_t order;   ///< Tie-breaking key.
+      size_t id;
+    };
+
+    emp::vector<Node> heap;         ///< Binary heap.
+    emp::vector<size_t> positions;  ///< positions[id] = index of id in heap (NONE if id not in heap).
+
+    /// Should a be closer to the top of the heap than b?
+    static bool Before(const Node & a, const Node & b) {
+      if (MAX_HEAP) return (a.priority > b.priority) || (a.priority == b.priority && a.order > b.order);
+      return (a.priority < b.priority) || (a.priority == b.priority && a.order < b.order);
+    }
+
+    void Place(size_t pos, const Node & node) {
+      heap[pos] = node;
+      positions[node.id] = pos;
+    }
+
+    void SiftUp(size_t pos) {
+      const Node node = heap[pos];
+      while (pos) {
+        const size_t parent = (pos - 1) / 2;
+        if (!Before(node, heap[parent])) break;
+        Place(pos, heap[parent]);
+        pos = parent;
+      }
+      Place(pos, node);
+    }
+
+    void SiftDown(size_t pos) {
+      const Node node = heap[pos];
+      const size_t n = heap.size();
+      while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= n) break;
+        if (child + 1 < n && Before(heap[child + 1], heap[child])) ++child;
+        if (!Before(heap[child], node)) break;
+        Place(pos, heap[child]);
+        pos = child;
+      }
+      Place(pos, node);
+    }
+
+  public:
+    ThreadPriorityHeap() : heap(), positions() { ; }
+
+    /// How many thread ids are in the heap?
+    size_t size() const { return heap.size(); }
+
+    /// Is the heap empty?
+    bool empty() const { return heap.empty(); }
+
+    /// Is thread id in the heap?
+    bool Has(size_t id) const { return id < positions.size() && positions[id] != NONE; }
+
+    /// Get id of thread at the top of the heap.
+    size_t Top() const { emp_assert(!empty()); return heap[0].id; }
+
+    /// Get priority of thread at the top of the heap.
+    double TopPriority() const { emp_assert(!empty()); return heap[0].priority; }
+
+    /// Get the priority the heap has on record for thread id.
+    double GetPriority(size_t id) const { emp_assert(Has(id), id); return heap[positions[id]].priority; }
+
+    /// Add thread id (with given priority and tie-breaking order key) to the heap. Thread id must not
+    /// already be in the heap.
+    void Push(size_t id, double priority, size_t order) {
+      emp_assert(id != NONE);
+      emp_assert(!Has(id), "Thread id already in heap.", id);
+      if (id >= positions.size()) positions.resize(id + 1, NONE);
+      heap.emplace_back(Node{priority, order, id});
+      positions[id] = heap.size() - 1;
+      SiftUp(heap.size() - 1);
+    }
+
+    /// Add thread id (with given priority) to the heap, using its id as its order key.
+    void Push(size_t id, double priority) { Push(id, priority, id); }
+
+    /// Remove thread at the top of the heap.
+    void Pop() { emp_assert(!empty()); Remove(heap[0].id); }
+
+    /// Remove thread id from the heap (if it's there).
+    void Remove(size_t id) {
+      if (!Has(id)) return;
+      const size_t pos = positions[id];
+      positions[id] = NONE;
+      const Node last = heap.back();
+      heap.pop_back();
+      if (pos == heap.size()) return; // Removed the last node.
+      Place(pos, last);
+      if (pos && Before(last, heap[(pos - 1) / 2])) SiftUp(pos);
+      else SiftDown(pos);
+    }
+
+    /// Change the priority of thread id (which must be in the heap).
+    void Update(size_t id, double priority) {
+      emp_assert(Has(id), id);
+      const size_t pos = positions[id];
+      const double prev = heap[pos].priority;
+      heap[pos].priority = priority;
+      if (MAX_HEAP == (priority > prev)) SiftUp(pos);
+      else SiftDown(pos);
+    }
+
+    /// Remove all thread ids from the heap. O(size()).
+    void clear() {
+      for (const Node & node : heap) positions[node.id] = NONE;
+      heap.clear();
+    }
+  };
+
+  using ThreadMaxPriorityHeap = ThreadPriorityHeap<true>;
+  using ThreadMinPriorityHeap = ThreadPriorityHeap<false>;
+
+}
+
+#endif
@@ -16,6 +16,7 @@
 
 #include "../SignalGPBase.h"
 #include "../utils/linear_signalgp_utils.h"
+#include "../utils/MatchCache.h"
 #include "../utils/LinearFunctionsProgram.h"
 
 namespace sgp {
@@ -28,40 +29,66 @@ namespace sgp {
                                               emp::RankedSelector<>,
                                               emp::AdditiveCountdownRegulator<>
                                             >,
-           typename CUSTOM_COMPONENT_T=sgp::DefaultCustomComponent>
-  class LinearFunctionsProgramSignalGP : public SignalGPBase<LinearFunctionsProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T>,
+           typename CUSTOM_COMPONENT_T=sgp::DefaultCustomComponent,
+           typename INSTRUMENTATION_T=sgp::NoInstrumentation,
+           typename EVENT_LIB_T=void,
+           template<typename, typename, typename> class INST_LIB_T=InstructionLibrary,
+           typename FLOW_POLICY_T=lsgp_utils::DefaultFlowPolicy>
+  class LinearFunctionsProgramSignalGP : public SignalGPBase<LinearFunctionsProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T,INSTRUMENTATION_T,EVENT_LIB_T,INST_LIB_T,FLOW_POLICY_T>,
                                                              lsgp_utils::ExecState<MEMORY_MODEL_T>,
                                                              TAG_T,
-                                                             CUSTOM_COMPONENT_T>
+                                                             CUSTOM_COMPONENT_T,
+                                                             INSTRUMENTATION_T,
+                                                             EVENT_LIB_T>
 
   {
   public:
     // Type aliases :scream:
-    using this_t = LinearFunctionsProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T>;
+    using this_t = LinearFunctionsProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T,INSTRUMENTATION_T,EVENT_LIB_T,INST_LIB_T,FLOW_POLICY_T>;
     using exec_state_t = lsgp_utils::ExecState<MEMORY_MODEL_T>;
     using call_state_t = typename exec_state_t::call_state_t;
     using flow_t = lsgp_utils::FlowType;
     using flow_info_t = lsgp_utils::FlowInfo;
-    using flow_handler_t = lsgp_utils::FlowHandler<this_t, exec_state_t>;
+    /// Default flow behavior (lsgp_utils::DefaultFlowPolicy unless FLOW_POLICY_T names another policy
+    /// class; see lsgp_utils::FlowHandler).
+    using flow_policy_t = FLOW_POLICY_T;
+    using flow_handler_t = lsgp_utils::FlowHandler<this_t, exec_state_t, flow_policy_t>;
     using tag_t = TAG_T;
     using arg_t = INST_ARGUMENT_T;
     using matchbin_t = MATCHBIN_T;
+    using match_cache_t = MatchCache<TAG_T>;
     using memory_model_t = MEMORY_MODEL_T;
     using memory_state_t = typename memory_model_t::memory_state_t;
     using program_t = sgp::LinearFunctionsProgram<tag_t, arg_t>;
-    using base_hw_t = SignalGPBase<this_t, exec_state_t, tag_t, CUSTOM_COMPONENT_T>;
+    using base_hw_t = SignalGPBase<this_t, exec_state_t, tag_t, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>;
     using thread_t = typename base_hw_t::Thread;
     using event_lib_t = typename base_hw_t::event_lib_t; // EventLibrary<this_t>
     using event_t = typename base_hw_t::event_t;
 
     enum class InstProperty { BLOCK_CLOSE, BLOCK_DEF }; /// Instruction-definition properties.
+
     using inst_t = typename program_t::inst_t;
-    using inst_lib_t = InstructionLibrary<this_t, inst_t, InstProperty>;
+    /// Instruction library (InstructionLibrary unless INST_LIB_T names another library template, e.g.,
+    /// an alias of StaticInstructionLibrary; instructions are executed through inst_lib_t::ProcessInst).
+    using inst_lib_t = INST_LIB_T<this_t, inst_t, InstProperty>;
     using inst_prop_t = InstProperty;
 
     using fun_end_flow_t = typename flow_handler_t::fun_end_flow_t;
     using fun_open_flow_t = typename flow_handler_t::fun_open_flow_t;
 
+    /// Everything needed to resume this hardware mid-execution (see Snapshot/Restore): base hardware
+    /// state (events, threads, and thread bookkeeping), the loaded program, global memory, and the
+    /// matchbin (including module regulators).
+    struct HardwareSnapshot {
+      typename base_hw_t::BaseState base;
+      program_t program;
+      memory_model_t memory_model;
+      matchbin_t matchbin;
+      bool is_matchbin_cache_dirty;
+      size_t max_call_depth;
+    };
+    using snapshot_t = HardwareSnapshot;
+
   protected:
     inst_lib_t & inst_lib;
     flow_handler_t flow_handler;
@@ -71,162 +98,29 @@ namespace sgp {
     matchbin_t matchbin;
     bool is_matchbin_cache_dirty;
     std::function<void()> fun_clear_matchbin_cache = [this](){ this->ResetMatchBin(); }; // todo - can we do a better job baking this in?
+    match_cache_t match_cache;      ///< Memoized FindModuleMatch results (cleared when modules/regulators change).
+    match_cache_t raw_match_cache;  ///< Memoized FindModuleMatchRaw results (cleared when modules change).
+    bool use_match_cache;           ///< Should module matches be memoized?
 
     size_t max_call_depth;
 
-    /// Setup default flow control functions for opening, closing, and breaking
-    /// each type of control flow: BASIC, WHILE_LOOP, CALL, ROUTINE.
-    // TODO
-    void SetupDefaultFlowControl() {
-      // --- BASIC Flow ---
-      // On open:
-      flow_handler[flow_t::BASIC].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open BASIC flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      // On close
-      // - Pop current flow from stack.
-      // - Set new top of flow stack (if any)'s IP and MP to returning IP and MP.
-      flow_handler[flow_t::BASIC].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to close BASIC flow. No flow to close.");
-          const size_t ip = call_state.GetTopFlow().ip;
-          const size_t mp = call_state.GetTopFlow().mp;
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            flow_info_t & top = call_state.GetTopFlow();
-            top.ip = ip;
-            top.mp = mp;
-          }
-        };
-
-      // On break!
-      flow_handler[flow_t::BASIC].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to break BASIC flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break BASIC flow. No flow to close.");
-          const size_t flow_end = call_state.GetTopFlow().GetEnd();
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(flow_end);
-            if (hw.IsValidProgramPosition(call_state.GetMP(), call_state.GetIP())) {
-              ++call_state.IP();
-            }
-          }
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open WHILE_LOOP flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close WHILE_LOOP flow. No calls on call stack.");
-          // Move IP to start of block
-          call_state_t & call_state = exec_state.call_stack.back();
-          const size_t loop_begin = call_state.GetTopFlow().begin;
-          const size_t mp = call_state.GetTopFlow().mp;
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(loop_begin);
-            call_state.SetMP(mp);
-          }
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to break WHILE_LOOP flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break WHILE_LOOP flow. No flow to close.");
-          const size_t flow_end = call_state.GetTopFlow().GetEnd();
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(flow_end);
-            if (hw.IsValidProgramPosition(call_state.GetMP(), call_state.GetIP())) {
-              ++call_state.IP();
-            }
-          }
-        };
-
-      flow_handler[flow_t::ROUTINE].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open ROUTINE flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.GetTopCallState();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::ROUTINE].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close ROUTINE flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break ROUTINE flow. No flow to close.");
-          // Closing a ROUTINE flow:
-          // - Pop flow from flow stack
-          // - No need to pass IP and MP down (we want to return to previous IP/MP)
-          call_state.flow_stack.pop_back();
-        };
-
-      // breaking from a routine is the same as closing a routine
-      flow_handler[flow_t::ROUTINE].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          hw.GetFlowHandler().CloseFlow(hw, flow_t::ROUTINE, exec_state);
-        };
-
-      flow_handler[flow_t::CALL].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open CALL flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::CALL].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close CALL flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to close CALL flow. No flow to close.");
-          // Closing a CALL flow:
-          // - Pop call flow from flow stack.
-          // - No need to pass IP and MP down (presumably, this was the bottom
-          //   of the flow stack).
-          if (call_state.IsCircular()) {
-            flow_info_t & top = call_state.GetTopFlow();
-            top.ip = top.begin;
-          } else {
-            call_state.GetFlowStack().pop_back();
-          }
-        };
-
-      flow_handler[flow_t::CALL].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          hw.GetFlowHandler().CloseFlow(hw, flow_t::CALL, exec_state);
-        };
-    }
-
-    /// Full hardware reset.
+  public:
+    /// Full hardware reset. (Required by SignalGPBase; called by Reset.)
     void ResetImpl() {
       ResetProgram(); // this will reset program + hardware
     }
 
-  public:
     LinearFunctionsProgramSignalGP(emp::Random & rnd, inst_lib_t & ilib, event_lib_t & elib)
       : base_hw_t(elib),
         inst_lib(ilib),
         random(rnd),
         matchbin(rnd),
         is_matchbin_cache_dirty(true),
+        match_cache(),
+        raw_match_cache(),
+        use_match_cache(IsDeterministicMatchBin<matchbin_t>::value),
         max_call_depth(256)
-    {
-      // Configure default flow control.
-      SetupDefaultFlowControl();
-    }
+    { ; }
 
     LinearFunctionsProgramSignalGP(LinearFunctionsProgramSignalGP &&) = default;
     LinearFunctionsProgramSignalGP(const LinearFunctionsProgramSignalGP &) = default;
@@ -250,6 +144,8 @@ namespace sgp {
     void ResetMatchBin() {
       matchbin.Clear();
       is_matchbin_cache_dirty = false;
+      match_cache.Clear();
+      raw_match_cache.Clear();
       for (size_t i = 0; i < program.GetSize(); ++i) {
         matchbin.Set(i, program[i].GetTag(), i);
       }
@@ -276,10 +172,29 @@ namespace sgp {
     memory_model_t & GetMemoryModel() { return memory_model; }
     const memory_model_t & GetMemoryModel() const { return memory_model; }
 
-    /// Get a reference to the hardware's matchbin
-    matchbin_t & GetMatchBin() { return matchbin; }
+    /// Get a reference to the hardware's matchbin.
+    /// The matchbin could be modified through this reference, so any memoized matches are
+    /// invalidated. To adjust regulators, use SetModuleRegulator/AdjModuleRegulator instead.
+    matchbin_t & GetMatchBin() { match_cache.Clear(); raw_match_cache.Clear(); return matchbin; }
     const matchbin_t & GetMatchBin() const { return matchbin; }
 
+    /// Get the cache of FindModuleMatch results (e.g., to check hit/miss counts).
+    const match_cache_t & GetMatchCache() const { return match_cache; }
+
+    /// Get the cache of FindModuleMatchRaw results.
+    const match_cache_t & GetRawMatchCache() const { return raw_match_cache; }
+
+    /// Should module matches be memoized? By default, matches are memoized if the matchbin's
+    /// selector is deterministic (see IsDeterministicMatchBin).
+    void SetMatchCaching(bool use_cache) {
+      use_match_cache = use_cache;
+      match_cache.Clear();
+      raw_match_cache.Clear();
+    }
+
+    /// Are module matches being memoized?
+    bool IsMatchCaching() const { return use_match_cache; }
+
     /// Set program for this hardware object.
     void SetProgram(const program_t & p) {
       this->Reset();   // Full hardware reset
@@ -287,21 +202,66 @@ namespace sgp {
       ResetMatchBin(); // Update matchbin with current program information.
     }
 
-    /// Set open flow handler for given flow type.
+    /// Capture this hardware's current state. Cannot call while hardware is executing.
+    snapshot_t Snapshot() const {
+      typename base_hw_t::BaseState base;
+      this->SaveBaseState(base);
+      return {std::move(base), program, memory_model, matchbin, is_matchbin_cache_dirty, max_call_depth};
+    }
+
+    /// Capture this hardware's current state into snapshot (reusing snapshot's storage).
+    void Snapshot(snapshot_t & snapshot) const {
+      this->SaveBaseState(snapshot.base);
+      snapshot.program = program;
+      snapshot.memory_model = memory_model;
+      snapshot.matchbin = matchbin;
+      snapshot.is_matchbin_cache_dirty = is_matchbin_cache_dirty;
+      snapshot.max_call_depth = max_call_depth;
+    }
+
+    /// Resume from snapshot (which may have been taken on other hardware that shares this
+    /// hardware's instruction and event libraries). Existing storage is reused, and the program is
+    /// only reloaded if it differs from the snapshot's. Memoized matches are discarded.
+    /// Cannot call while hardware is executing.
+    void Restore(const snapshot_t & snapshot) {
+      emp_assert(!this->IsExecuting(), "Cannot restore hardware state while executing.");
+      if (program != snapshot.program) {
+        program = snapshot.program;
+      }
+      this->RestoreBaseState(snapshot.base);
+      memory_model = snapshot.memory_model;
+      matchbin = snapshot.matchbin;
+      is_matchbin_cache_dirty = snapshot.is_matchbin_cache_dirty;
+      max_call_depth = snapshot.max_call_depth;
+      match_cache.Clear();
+      raw_match_cache.Clear();
+    }
+
+    /// Set open flow handler for given flow type (overrides the default; pass nullptr to restore it).
     void SetOpenFlowFun(flow_t type, const fun_open_flow_t & fun) {
       flow_handler[type].open_flow_fun = fun;
     }
 
-    // Set close flow handler for a given flow type.
+    // Set close flow handler for a given flow type (pass nullptr to restore the default).
     void SetCloseFlowFun(flow_t type, const fun_end_flow_t & fun) {
       flow_handler[type].close_flow_fun = fun;
     }
 
-    // Set break flow handler for a given flow type.
+    // Set break flow handler for a given flow type (pass nullptr to restore the default).
     void SetBreakFlowFun(flow_t type, const fun_end_flow_t & fun) {
       flow_handler[type].break_flow_fun = fun;
     }
 
+    /// Get the open flow handler for the given flow type: its override, if set; otherwise, the
+    /// default (flow_policy_t). E.g., to wrap the default in an override.
+    fun_open_flow_t GetOpenFlowFun(flow_t type) const { return flow_handler.GetOpenFlowFun(type); }
+
+    /// Get the close flow handler for the given flow type (its override, if set; otherwise, the default).
+    fun_end_flow_t GetCloseFlowFun(flow_t type) const { return flow_handler.GetCloseFlowFun(type); }
+
+    /// Get the break flow handler for the given flow type (its override, if set; otherwise, the default).
+    fun_end_flow_t GetBreakFlowFun(flow_t type) const { return flow_handler.GetBreakFlowFun(type); }
+
     void SingleExecutionStep(this_t & hardware, thread_t & thread) {
       exec_state_t & exec_state = thread.GetExecState();
       // If there's a call state on the call stack, execute an instruction.
@@ -322,6 +282,7 @@ namespace sgp {
             // even be invalid. Thus, we must increment the IP before processing
             // the current instruction.
             ++flow_info.ip; // Move IP forward (maybe to an invalid location)
+            this->instrumentation.OnInstruction(program[mp][ip].GetID());
             inst_lib.ProcessInst(hardware, program[mp][ip]);
           } else { // @discussion if we wanted option to have modules be circular, we could add a condition before this else!
             // The IP is off the edge of the module.
@@ -368,13 +329,67 @@ namespace sgp {
       return ip;
     }
 
-    /// Use matchbin to find the n matching modules to a given
+    /// Use the matchbin to find the n matching modules to a given tag.
+    /// Results are memoized (see SetMatchCaching).
     emp::vector<size_t> FindModuleMatch(const tag_t & tag, size_t n=1) {
-      // find n matches
+      // Find n matches.
+      if (is_matchbin_cache_dirty) {
+        ResetMatchBin();
+      }
+      // no need to transform to values because we're using
+      // matchbin uids equivalent to function uids
+      if (!use_match_cache) return matchbin.Match(tag, n);
+      return match_cache.Get(tag, n, [this, &tag, n]() { return matchbin.Match(tag, n); });
+    }
+
+    /// Use the matchbin to find the n matching modules to a given tag, ignoring regulation.
+    /// Results are memoized (see SetMatchCaching).
+    emp::vector<size_t> FindModuleMatchRaw(const tag_t & tag, size_t n=1) {
       if (is_matchbin_cache_dirty) {
         ResetMatchBin();
       }
-      return matchbin.Match(tag, n);
+      if (!use_match_cache) return matchbin.MatchRaw(tag, n);
+      return raw_match_cache.Get(tag, n, [this, &tag, n]() { return matchbin.MatchRaw(tag, n); });
+    }
+
+    /// Set the regulator value for the given module.
+    /// Cached matches are only invalidated if the regulator's value actually changes.
+    void SetModuleRegulator(size_t module_id, double value) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const double prev = matchbin.ViewRegulator(module_id);
+      matchbin.SetRegulator(module_id, value);
+      if (matchbin.ViewRegulator(module_id) != prev) match_cache.Clear();
+    }
+
+    /// Adjust the regulator value for the given module.
+    /// Cached matches are only invalidated if the regulator's value actually changes.
+    void AdjModuleRegulator(size_t module_id, double amount) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const double prev = matchbin.ViewRegulator(module_id);
+      matchbin.AdjRegulator(module_id, amount);
+      if (matchbin.ViewRegulator(module_id) != prev) match_cache.Clear();
+    }
+
+    /// Decay all module regulators by the given number of steps.
+    /// Cached matches are only invalidated if any regulator's value actually changes.
+    void DecayModuleRegulators(int steps=1) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const size_t num_modules = GetNumModules();
+      emp::vector<double> prev(num_modules);
+      for (size_t i = 0; i < num_modules; ++i) prev[i] = matchbin.ViewRegulator(i);
+      matchbin.DecayRegulators(steps);
+      for (size_t i = 0; i < num_modules; ++i) {
+        if (matchbin.ViewRegulator(i) != prev[i]) {
+          match_cache.Clear();
+          break;
+        }
+      }
+    }
+
+    /// Get the regulator value for the given module.
+    double ViewModuleRegulator(size_t module_id) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      return matchbin.ViewRegulator(module_id);
     }
 
     void CallModule(const tag_t & tag, exec_state_t & exec_state, bool circular=false) {
@@ -393,7 +408,8 @@ namespace sgp {
       if (exec_state.call_stack.size() >= max_call_depth) return;
       if (program[module_id].GetSize() < 1) return;
       // Push new state to call stack.
-      exec_state.call_stack.emplace_back(memory_model.CreateMemoryState(), circular);
+      exec_state.call_stack.emplace_back(memory_model, circular);
+      this->instrumentation.OnModuleEntry(module_id, exec_state.call_stack.size());
       // note - flow info is different?
       // todo - double check that this FlowInfo is fine
       flow_handler.OpenFlow(*this, {flow_t::CALL, module_id, 0, 0, program[module_id].GetSize()}, exec_state);
@@ -416,7 +432,7 @@ namespace sgp {
         memory_model.OnModuleReturn(returning_state.GetMemory(), caller_state.GetMemory());
       }
       // Pop the returning state from call stack.
-      exec_state.call_stack.pop_back();
+      exec_state.call_stack.pop_back(memory_model);
     }
 
   };
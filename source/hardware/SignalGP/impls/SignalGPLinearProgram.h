@@ -16,6 +16,7 @@
 
 #include "../SignalGPBase.h"
 #include "../utils/linear_signalgp_utils.h"
+#include "../utils/MatchCache.h"
 #include "../utils/LinearProgram.h"
 
 namespace sgp {
@@ -28,11 +29,17 @@ namespace sgp {
                                               emp::RankedSelector<>,
                                               emp::AdditiveCountdownRegulator<>
                                             >,
-           typename CUSTOM_COMPONENT_T=sgp::DefaultCustomComponent>
-  class LinearProgramSignalGP : public SignalGPBase<LinearProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T>,
+           typename CUSTOM_COMPONENT_T=sgp::DefaultCustomComponent,
+           typename INSTRUMENTATION_T=sgp::NoInstrumentation,
+           typename EVENT_LIB_T=void,
+           template<typename, typename, typename> class INST_LIB_T=InstructionLibrary,
+           typename FLOW_POLICY_T=lsgp_utils::DefaultFlowPolicy>
+  class LinearProgramSignalGP : public SignalGPBase<LinearProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T,INSTRUMENTATION_T,EVENT_LIB_T,INST_LIB_T,FLOW_POLICY_T>,
                                                     lsgp_utils::ExecState<MEMORY_MODEL_T>,
                                                     TAG_T,
-                                                    CUSTOM_COMPONENT_T>
+                                                    CUSTOM_COMPONENT_T,
+                                                    INSTRUMENTATION_T,
+                                                    EVENT_LIB_T>
   {
   public:
     // Forward declarations.
@@ -42,34 +49,45 @@ namespace sgp {
     enum class InstProperty;
 
     // Type aliases.
-    using this_t = LinearProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T>;
+    using this_t = LinearProgramSignalGP<MEMORY_MODEL_T,TAG_T,INST_ARGUMENT_T,MATCHBIN_T,CUSTOM_COMPONENT_T,INSTRUMENTATION_T,EVENT_LIB_T,INST_LIB_T,FLOW_POLICY_T>;
 
     using exec_state_t = lsgp_utils::ExecState<MEMORY_MODEL_T>;
     using call_state_t = typename exec_state_t::call_state_t;
     using flow_t = lsgp_utils::FlowType;
     using flow_info_t = lsgp_utils::FlowInfo;
-    using flow_handler_t = lsgp_utils::FlowHandler<this_t, exec_state_t>;
+    /// Default flow behavior (lsgp_utils::DefaultFlowPolicy unless FLOW_POLICY_T names another policy
+    /// class; see lsgp_utils::FlowHandler).
+    using flow_policy_t = FLOW_POLICY_T;
+    using flow_handler_t = lsgp_utils::FlowHandler<this_t, exec_state_t, flow_policy_t>;
 
     // using exec_state_t = ExecState;
     using tag_t = TAG_T;
     using arg_t = INST_ARGUMENT_T;
     using module_t = Module;
     using matchbin_t = MATCHBIN_T;
+    using match_cache_t = MatchCache<tag_t>;
 
     using memory_model_t = MEMORY_MODEL_T;
     using memory_state_t = typename memory_model_t::memory_state_t;
 
     using program_t = sgp::LinearProgram<tag_t, arg_t>;
+    using packed_program_t = sgp::PackedLinearProgram<tag_t, arg_t>;
 
-    using base_hw_t = SignalGPBase<this_t, exec_state_t, tag_t, CUSTOM_COMPONENT_T>;
+    using base_hw_t = SignalGPBase<this_t, exec_state_t, tag_t, CUSTOM_COMPONENT_T, INSTRUMENTATION_T, EVENT_LIB_T>;
     using thread_t = typename base_hw_t::Thread;
-    using event_lib_t = sgp::EventLibrary<this_t>;
+    using event_lib_t = typename base_hw_t::event_lib_t;
     using event_t = typename base_hw_t::event_t;
 
     /// Blocks are within-module flow control segments (e.g., while loops, if statements, etc)
     enum class InstProperty { MODULE, BLOCK_CLOSE, BLOCK_DEF };
-    using inst_t = typename program_t::inst_t;
-    using inst_lib_t = InstructionLibrary<this_t, inst_t, InstProperty>;
+    /// Instruction type of the library (instructions execute from the packed program).
+    /// Not program_t::inst_t: program_t instructions convert to it (copying their tags and any
+    /// arguments that don't fit inline), but references to program instructions can't be taken as
+    /// inst_t references.
+    using inst_t = typename packed_program_t::inst_t;
+    /// Instruction library (InstructionLibrary unless INST_LIB_T names another library template, e.g.,
+    /// an alias of StaticInstructionLibrary; instructions are executed through inst_lib_t::ProcessInst).
+    using inst_lib_t = INST_LIB_T<this_t, inst_t, InstProperty>;
     using inst_prop_t = InstProperty;
 
     // using fun_end_flow_t = std::function<void(this_t&, exec_state_t &)>;                   // note - pass hardware down?
@@ -78,19 +96,38 @@ namespace sgp {
     using fun_end_flow_t = typename flow_handler_t::fun_end_flow_t;
     using fun_open_flow_t = typename flow_handler_t::fun_open_flow_t;
 
+    /// Everything needed to resume this hardware mid-execution (see Snapshot/Restore): base hardware
+    /// state (events, threads, and thread bookkeeping), the loaded program, global memory, and the
+    /// matchbin (including module regulators).
+    struct HardwareSnapshot {
+      typename base_hw_t::BaseState base;
+      program_t program;
+      memory_model_t memory_model;
+      matchbin_t matchbin;
+      bool is_matchbin_cache_dirty;
+      size_t max_call_depth;
+    };
+    using snapshot_t = HardwareSnapshot;
+
     /// Module definition.
     struct Module {
       size_t id;      ///< Module ID. Used to call/reference module.
       size_t begin;   ///< First instruction in module (will be the module definition instruction).
       size_t end;     ///< The last instruction in the module.
       tag_t tag;      ///< Module tag. Used to call/reference module.
-      std::unordered_set<size_t> in_module; ///< instruction positions belonging to this module.
+      // Instruction positions belonging to this module: [range_begin, range_end) + [0, wrap_end).
+      // Modules are contiguous, but the last module in a program wraps around to claim any
+      // instructions that precede the first module definition.
+      size_t range_begin; ///< First instruction position in this module's (non-wrapping) range.
+      size_t range_end;   ///< One past the last instruction position in this module's (non-wrapping) range.
+      size_t wrap_end;    ///< One past the last wrapped-around instruction position (0 if module doesn't wrap).
 
       Module(size_t _id, size_t _begin=0, size_t _end=0, const tag_t & _tag=tag_t())
-        : id(_id), begin(_begin), end(_end), tag(_tag), in_module() { ; }
+        : id(_id), begin(_begin), end(_end), tag(_tag),
+          range_begin(0), range_end(0), wrap_end(0) { ; }
 
       /// How many instructions are in this module?
-      size_t GetSize() const { return in_module.size(); }
+      size_t GetSize() const { return (range_end - range_begin) + wrap_end; }
 
       /// What's our module id?
       size_t GetID() const { return id; }
@@ -108,7 +145,9 @@ namespace sgp {
       size_t GetEnd() const { return end; }
 
       /// Returns whether or not a given instruction position within this module.
-      bool InModule(size_t ip) const { return emp::Has(in_module, ip); }
+      bool InModule(size_t ip) const {
+        return (ip - range_begin < range_end - range_begin) || (ip < wrap_end);
+      }
     };
 
   protected:
@@ -116,7 +155,18 @@ namespace sgp {
     flow_handler_t flow_handler;       ///< The flow handler manages the behavior of different types of execution flow.
     memory_model_t memory_model;    ///< The memory model manages any global memory state and specifies call state memory.
     program_t program;              ///< Program loaded on this execution stepper.
+    packed_program_t packed_program; ///< Execution form of program. Rebuilt by UpdateModules and RepackProgram.
+    bool is_packed_program_dirty;   ///< Might program have been edited since packed_program was built?
     emp::vector<module_t> modules;  ///< List of modules in program.
+    emp::vector<size_t> position_modules; /**< Module ID that each program position belongs to
+                                           *   ((size_t)-1 for module definitions).
+                                           *   Rebuilt by UpdateModules.
+                                           **/
+    emp::vector<size_t> block_ends; /**< Precomputed end-of-block positions (see FindEndOfBlock), indexed
+                                     *   by the position immediately following each block-opening
+                                     *   instruction. Positions without a precomputed result hold
+                                     *   (size_t)-1. Rebuilt by UpdateModules and RepackProgram.
+                                     **/
     tag_t default_module_tag;       ///< What is the default tag to used for modules (in case the program doesn't specify)?
 
     emp::Random& random;            ///< Random number generator. (TODO - make this a smart pointer)
@@ -124,168 +174,39 @@ namespace sgp {
     matchbin_t matchbin;            ///< the match bin specifies how modules are referenced
     bool is_matchbin_cache_dirty;
     std::function<void()> fun_clear_matchbin_cache = [this](){ this->ResetMatchBin(); }; // todo - can we do a better job baking this in?
+    match_cache_t match_cache;      ///< Memoized FindModuleMatch results (cleared when modules/regulators change).
+    match_cache_t raw_match_cache;  ///< Memoized FindModuleMatchRaw results (cleared when modules change).
+    bool use_match_cache;           ///< Should module matches be memoized?
 
     size_t max_call_depth;          ///< Maximum size of a call stack.
 
-    /// Setup default flow control functions for opening, closing, and breaking
-    /// each type of control flow: BASIC, WHILE_LOOP, CALL, ROUTINE.
-    void SetupDefaultFlowControl() {
-      // --- BASIC Flow ---
-      // On open:
-      flow_handler[flow_t::BASIC].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open BASIC flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      // On close
-      // - Pop current flow from stack.
-      // - Set new top of flow stack (if any)'s IP and MP to returning IP and MP.
-      flow_handler[flow_t::BASIC].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close BASIC flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to close BASIC flow. No flow to close.");
-          const size_t ip = call_state.GetTopFlow().ip;
-          const size_t mp = call_state.GetTopFlow().mp;
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            flow_info_t & top = call_state.GetTopFlow();
-            top.ip = ip;
-            top.mp = mp;
-          }
-        };
-
-      // On break!
-      flow_handler[flow_t::BASIC].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to break BASIC flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break BASIC flow. No flow to close.");
-          const size_t flow_end = call_state.GetTopFlow().GetEnd();
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(flow_end);
-            if (hw.IsValidProgramPosition(call_state.GetMP(), call_state.GetIP())) {
-              ++call_state.IP();
-            }
-          }
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open WHILE_LOOP flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close WHILE_LOOP flow. No calls on call stack.");
-          // Move IP to start of block
-          call_state_t & call_state = exec_state.call_stack.back();
-          const size_t loop_begin = call_state.GetTopFlow().begin;
-          const size_t mp = call_state.GetTopFlow().mp;
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(loop_begin);
-            call_state.SetMP(mp);
-          }
-        };
-
-      flow_handler[flow_t::WHILE_LOOP].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to break WHILE_LOOP flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break WHILE_LOOP flow. No flow to close.");
-          const size_t flow_end = call_state.GetTopFlow().GetEnd();
-          call_state.flow_stack.pop_back();
-          if (call_state.IsFlow()) {
-            call_state.SetIP(flow_end);
-            if (hw.IsValidProgramPosition(call_state.GetMP(), call_state.GetIP())) {
-              ++call_state.IP();
-            }
-          }
-        };
-
-      flow_handler[flow_t::ROUTINE].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open ROUTINE flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.GetTopCallState();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::ROUTINE].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close ROUTINE flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to break ROUTINE flow. No flow to close.");
-          // Closing a ROUTINE flow:
-          // - Pop flow from flow stack
-          // - No need to pass IP and MP down (we want to return to previous IP/MP)
-          call_state.flow_stack.pop_back();
-        };
-
-      // breaking from a routine is the same as closing a routine
-      flow_handler[flow_t::ROUTINE].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          hw.GetFlowHandler().CloseFlow(hw, flow_t::ROUTINE, exec_state);
-        };
-
-      flow_handler[flow_t::CALL].open_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state, const flow_info_t & new_flow) {
-          emp_assert(exec_state.call_stack.size(), "Failed to open CALL flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          call_state.flow_stack.emplace_back(new_flow);
-        };
-
-      flow_handler[flow_t::CALL].close_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          emp_assert(exec_state.call_stack.size(), "Failed to close CALL flow. No calls on call stack.");
-          call_state_t & call_state = exec_state.call_stack.back();
-          emp_assert(call_state.IsFlow(), "Failed to close CALL flow. No flow to close.");
-          // Closing a CALL flow:
-          // - Pop call flow from flow stack.
-          // - No need to pass IP and MP down (presumably, this was the bottom
-          //   of the flow stack).
-          if (call_state.IsCircular()) {
-            flow_info_t & top = call_state.GetTopFlow();
-            top.ip = top.begin;
-          } else {
-            call_state.GetFlowStack().pop_back();
-          }
-        };
-
-      flow_handler[flow_t::CALL].break_flow_fun =
-        [](this_t & hw, exec_state_t & exec_state) {
-          hw.GetFlowHandler().CloseFlow(hw, flow_t::CALL, exec_state);
-        };
-    }
-
-    /// Full reset.
+  public:
+    /// Full reset. (Required by SignalGPBase; called by Reset.)
     void ResetImpl() {
       ResetHardwareState();
       ResetProgram();
     }
 
-  public:
     LinearProgramSignalGP(emp::Random & rnd, inst_lib_t & ilib, event_lib_t & elib)
       : base_hw_t(elib),
         inst_lib(ilib),
         flow_handler(),
         memory_model(),
         program(),
+        packed_program(),
+        is_packed_program_dirty(false),
         modules(),
+        position_modules(),
+        block_ends(),
         default_module_tag(),
         random(rnd),
         matchbin(rnd),
         is_matchbin_cache_dirty(true),
+        match_cache(),
+        raw_match_cache(),
+        use_match_cache(IsDeterministicMatchBin<matchbin_t>::value),
         max_call_depth(256)
-    {
-      // Configure default flow control
-      SetupDefaultFlowControl();
-    }
+    { ; }
 
     LinearProgramSignalGP(LinearProgramSignalGP &&) = default;
     LinearProgramSignalGP(const LinearProgramSignalGP &) = default;
@@ -299,7 +220,11 @@ namespace sgp {
     /// Reset loaded program.
     void ResetProgram() {
       modules.clear(); // Clear modules.
+      position_modules.clear(); // Clear module membership.
+      block_ends.clear(); // Clear block table.
       program.Clear(); // Clear program.
+      packed_program.Clear(); // Clear execution form of program.
+      is_packed_program_dirty = false;
       ResetMatchBin(); // Reset matchbin.
     }
 
@@ -307,6 +232,8 @@ namespace sgp {
     void ResetMatchBin() {
       matchbin.Clear();
       is_matchbin_cache_dirty = false;
+      match_cache.Clear();
+      raw_match_cache.Clear();
       for (size_t i = 0; i < modules.size(); ++i) {
         matchbin.Set(i, modules[i].GetTag(), i);
       }
@@ -316,15 +243,14 @@ namespace sgp {
     /// position in the program. I.e., mp is a valid module and ip is inside of
     /// module mp.
     bool IsValidProgramPosition(size_t mp, size_t ip) const {
-      if (mp < modules.size()) {
-        if (modules[mp].InModule(ip)) return true;
-      }
-      return false;
+      return mp < modules.size() && ip < position_modules.size() && position_modules[ip] == mp;
     }
 
     /// Advance given execution state on given hardware by a single step. I.e.,
     /// process a single instruction on this hardware.
     void SingleExecutionStep(this_t & hardware, thread_t & thread) {
+      // Pick up any in-place edits to the program (see EditProgram).
+      if (is_packed_program_dirty) RepackProgram();
       exec_state_t & exec_state = thread.GetExecState();
       // If there's a call state on the call stack, execute an instruction.
       while (exec_state.call_stack.size()) {
@@ -339,7 +265,7 @@ namespace sgp {
           // std::cout << ">> MP=" << mp << "; IP=" << ip << std::endl;
           emp_assert(mp < GetNumModules(), "Invalid module pointer: ", mp);
           // Process current instruction (if any)!
-          if (modules[mp].InModule(ip)) {
+          if (ip < position_modules.size() && position_modules[ip] == mp) {
             // NOTE - should we increment the IP before or after executing?
             // Only BEFORE executing an instruction do we have any guarantees about
             // the state of our flow info. After processing an instruction, this
@@ -347,7 +273,8 @@ namespace sgp {
             // even be invalid. Thus, we must increment the IP before processing
             // the current instruction.
             ++flow_info.ip; // Move instruction pointer forward (might be invalid location).
-            inst_lib.ProcessInst(hardware, program[ip]);
+            this->instrumentation.OnInstruction(packed_program[ip].GetID());
+            inst_lib.ProcessInst(hardware, packed_program[ip]);
           } else if (ip >= program.GetSize()
                     && modules[mp].InModule(0)
                     && modules[mp].end < modules[mp].begin) {
@@ -356,7 +283,8 @@ namespace sgp {
             // in which case, we need to move the IP.
             ip = 0;
             flow_info.ip = 1; // See comment above for why we do this before ProcessInst.
-            inst_lib.ProcessInst(hardware, program[ip]);
+            this->instrumentation.OnInstruction(packed_program[ip].GetID());
+            inst_lib.ProcessInst(hardware, packed_program[ip]);
           } else {
             // IP not valid for this module. Close flow.
             flow_handler.CloseFlow(hardware, flow_info.type, exec_state);
@@ -387,44 +315,68 @@ namespace sgp {
 
     flow_handler_t & GetFlowHandler() { return flow_handler; }
 
-    /// Set open flow handler for given flow type.
+    /// Set open flow handler for given flow type (overrides the default; pass nullptr to restore it).
     void SetOpenFlowFun(flow_t type, const fun_open_flow_t & fun) {
       flow_handler[type].open_flow_fun = fun;
     }
 
-    // Set close flow handler for a given flow type.
+    // Set close flow handler for a given flow type (pass nullptr to restore the default).
     void SetCloseFlowFun(flow_t type, const fun_end_flow_t & fun) {
       flow_handler[type].close_flow_fun = fun;
     }
 
-    // Set break flow handler for a given flow type.
+    // Set break flow handler for a given flow type (pass nullptr to restore the default).
     void SetBreakFlowFun(flow_t type, const fun_end_flow_t & fun) {
       flow_handler[type].break_flow_fun = fun;
     }
 
+    /// Get the open flow handler for the given flow type: its override, if set; otherwise, the
+    /// default (flow_policy_t). E.g., to wrap the default in an override.
+    fun_open_flow_t GetOpenFlowFun(flow_t type) const { return flow_handler.GetOpenFlowFun(type); }
+
+    /// Get the close flow handler for the given flow type (its override, if set; otherwise, the default).
+    fun_end_flow_t GetCloseFlowFun(flow_t type) const { return flow_handler.GetCloseFlowFun(type); }
+
+    /// Get the break flow handler for the given flow type (its override, if set; otherwise, the default).
+    fun_end_flow_t GetBreakFlowFun(flow_t type) const { return flow_handler.GetBreakFlowFun(type); }
+
     /// Find end of code block (i.e., internal flow control code segment).
-    // @todo - test explicitly!
+    /// Uses the block table when a block begins at the given position (and the program hasn't been
+    /// edited since the table was built); otherwise, falls back to scanning the program
+    /// (ScanEndOfBlock).
     size_t FindEndOfBlock(size_t mp, size_t ip) const {
+      emp_assert(mp < modules.size(), "Invalid module!");
+      if (!IsValidProgramPosition(mp, ip)) return ip;
+      if (!is_packed_program_dirty && block_ends[ip] != (size_t)-1) return block_ends[ip];
+      return ScanEndOfBlock(mp, ip);
+    }
+
+    /// Find end of code block by scanning forward (wrapping around the end of the program if
+    /// the module wraps) from the given position until the block is closed or we leave the module.
+    size_t ScanEndOfBlock(size_t mp, size_t ip) const {
       emp_assert(mp < modules.size(), "Invalid module!");
       int depth = 1;
-      std::unordered_set<size_t> seen;
+      // Modules are contiguous (wrapping around the end of the program), so the number of distinct
+      // positions we've seen is just the number of steps we've taken (capped at the module size).
+      size_t scanned = 0;
       while (true) {
         if (!IsValidProgramPosition(mp, ip)) break;
-        const inst_t & inst = program[ip];
+        const auto & inst = program[ip];  // Source program is never stale (see EditProgram).
         if (inst_lib.HasProperty(inst.GetID(), InstProperty::BLOCK_DEF)) {
           ++depth;
         } else if (inst_lib.HasProperty(inst.GetID(), InstProperty::BLOCK_CLOSE)) {
           --depth;
           if (depth == 0) break;
         }
-        seen.emplace(ip);
+        ++scanned;
         ++ip;
-        if (ip >= program.GetSize() && seen.size() < modules[mp].GetSize()) ip %= program.GetSize();
+        if (ip >= program.GetSize() && scanned < modules[mp].GetSize()) ip %= program.GetSize();
       }
       return ip;
     }
 
     /// Use the matchbin to find the n matching modules to a given tag.
+    /// Results are memoized (see SetMatchCaching).
     emp::vector<size_t> FindModuleMatch(const tag_t & tag, size_t n=1) {
       // Find n matches.
       if (is_matchbin_cache_dirty) {
@@ -432,7 +384,58 @@ namespace sgp {
       }
       // no need to transform to values because we're using
       // matchbin uids equivalent to function uids
-      return matchbin.Match(tag, n);
+      if (!use_match_cache) return matchbin.Match(tag, n);
+      return match_cache.Get(tag, n, [this, &tag, n]() { return matchbin.Match(tag, n); });
+    }
+
+    /// Use the matchbin to find the n matching modules to a given tag, ignoring regulation.
+    /// Results are memoized (see SetMatchCaching).
+    emp::vector<size_t> FindModuleMatchRaw(const tag_t & tag, size_t n=1) {
+      if (is_matchbin_cache_dirty) {
+        ResetMatchBin();
+      }
+      if (!use_match_cache) return matchbin.MatchRaw(tag, n);
+      return raw_match_cache.Get(tag, n, [this, &tag, n]() { return matchbin.MatchRaw(tag, n); });
+    }
+
+    /// Set the regulator value for the given module.
+    /// Cached matches are only invalidated if the regulator's value actually changes.
+    void SetModuleRegulator(size_t module_id, double value) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const double prev = matchbin.ViewRegulator(module_id);
+      matchbin.SetRegulator(module_id, value);
+      if (matchbin.ViewRegulator(module_id) != prev) match_cache.Clear();
+    }
+
+    /// Adjust the regulator value for the given module.
+    /// Cached matches are only invalidated if the regulator's value actually changes.
+    void AdjModuleRegulator(size_t module_id, double amount) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const double prev = matchbin.ViewRegulator(module_id);
+      matchbin.AdjRegulator(module_id, amount);
+      if (matchbin.ViewRegulator(module_id) != prev) match_cache.Clear();
+    }
+
+    /// Decay all module regulators by the given number of steps.
+    /// Cached matches are only invalidated if any regulator's value actually changes.
+    void DecayModuleRegulators(int steps=1) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      const size_t num_modules = GetNumModules();
+      emp::vector<double> prev(num_modules);
+      for (size_t i = 0; i < num_modules; ++i) prev[i] = matchbin.ViewRegulator(i);
+      matchbin.DecayRegulators(steps);
+      for (size_t i = 0; i < num_modules; ++i) {
+        if (matchbin.ViewRegulator(i) != prev[i]) {
+          match_cache.Clear();
+          break;
+        }
+      }
+    }
+
+    /// Get the regulator value for the given module.
+    double ViewModuleRegulator(size_t module_id) {
+      if (is_matchbin_cache_dirty) ResetMatchBin();
+      return matchbin.ViewRegulator(module_id);
     }
 
     /// Call a module (specified by given tag) on the given execution state.
@@ -448,7 +451,8 @@ namespace sgp {
       emp_assert(module_id < modules.size());
       if (exec_state.call_stack.size() >= max_call_depth) return;
       // Push new state onto stack.
-      exec_state.call_stack.emplace_back(memory_model.CreateMemoryState(), circular);
+      exec_state.call_stack.emplace_back(memory_model, circular);
+      this->instrumentation.OnModuleEntry(module_id, exec_state.call_stack.size());
       module_t & module_info = modules[module_id];
       flow_handler.OpenFlow(*this, {flow_t::CALL, module_id, module_info.begin, module_info.begin, module_info.end}, exec_state);
       if (exec_state.call_stack.size() > 1) {
@@ -471,7 +475,7 @@ namespace sgp {
         memory_model.OnModuleReturn(returning_state.GetMemory(), caller_state.GetMemory());
       }
       // Pop the returning state from call stack.
-      exec_state.call_stack.pop_back();
+      exec_state.call_stack.pop_back(memory_model);
     }
 
     /// Set program for this hardware object.
@@ -483,23 +487,75 @@ namespace sgp {
       UpdateModules();
     }
 
+    /// Capture this hardware's current state. Cannot call while hardware is executing.
+    snapshot_t Snapshot() const {
+      typename base_hw_t::BaseState base;
+      this->SaveBaseState(base);
+      return {std::move(base), program, memory_model, matchbin, is_matchbin_cache_dirty, max_call_depth};
+    }
+
+    /// Capture this hardware's current state into snapshot (reusing snapshot's storage).
+    void Snapshot(snapshot_t & snapshot) const {
+      this->SaveBaseState(snapshot.base);
+      snapshot.program = program;
+      snapshot.memory_model = memory_model;
+      snapshot.matchbin = matchbin;
+      snapshot.is_matchbin_cache_dirty = is_matchbin_cache_dirty;
+      snapshot.max_call_depth = max_call_depth;
+    }
+
+    /// Resume from snapshot (which may have been taken on other hardware that shares this
+    /// hardware's instruction and event libraries). Existing storage is reused, and the program is
+    /// only reloaded if it differs from the snapshot's. Memoized matches are discarded.
+    /// Cannot call while hardware is executing.
+    void Restore(const snapshot_t & snapshot) {
+      emp_assert(!this->IsExecuting(), "Cannot restore hardware state while executing.");
+      if (program != snapshot.program) {
+        program = snapshot.program;
+        UpdateModules();
+      }
+      this->RestoreBaseState(snapshot.base);
+      memory_model = snapshot.memory_model;
+      matchbin = snapshot.matchbin;
+      is_matchbin_cache_dirty = snapshot.is_matchbin_cache_dirty;
+      max_call_depth = snapshot.max_call_depth;
+      match_cache.Clear();
+      raw_match_cache.Clear();
+    }
+
     /// Configure the default module tag. Assigned to default module if a loaded
     /// program has no module definition in it.
     void SetDefaultTag(const tag_t & _tag) { default_module_tag = _tag; }
 
+    /// Rebuild the packed (execution) form of the program and the block table (e.g., after editing
+    /// instructions in place). Module information is left as is (see UpdateModules).
+    void RepackProgram() {
+      packed_program.Load(program);
+      is_packed_program_dirty = false;
+      UpdateBlockEnds();
+    }
+
     /// Analyze program and extract module information. Use to update modules
-    /// vector.
+    /// vector (e.g., after editing the program in place via EditProgram). Also
+    /// rebuilds the packed (execution) form of the program.
     /// @todo - check to see if this works
     void UpdateModules() {
       // std::cout << "Update modules!" << std::endl;
+      // Rebuild the form of the program that we execute. (The block table is rebuilt below, once
+      // module information is up to date.)
+      packed_program.Load(program);
+      is_packed_program_dirty = false;
       // Clear out the current modules.
       modules.clear();
+      position_modules.clear();
+      block_ends.clear();
       // Do nothing if there aren't any instructions to look at.
       if (!program.GetSize()) return;
       // Scan program for module definitions.
-      std::unordered_set<size_t> dangling_instructions;
+      // Instructions that come before the first module definition are dangling.
+      size_t num_dangling = 0;
       for (size_t pos = 0; pos < program.GetSize(); ++pos) {
-        inst_t & inst = program[pos];
+        const inst_t & inst = packed_program[pos];
         // Is this a module definition?
         if (inst_lib.HasProperty(inst.GetID(), InstProperty::MODULE)) {
           // If this isn't the first module we've found, mark this position as the
@@ -508,12 +564,14 @@ namespace sgp {
           emp_assert(inst.GetTags().size(), "MODULE-defining instructions must have tag arguments to be used with this execution stepper.");
           const size_t mod_id = modules.size(); // Module ID for new module.
           modules.emplace_back(mod_id, ( (pos+1) < program.GetSize() ) ? pos+1 : 0, -1, inst.GetTags()[0]);
+          modules.back().range_begin = pos + 1;
+          modules.back().range_end = pos + 1;
         } else {
           // We didn't find a new module. Track which module this instruction belongs to:
           // - If we've found a module, add it to the current module.
           // - If we haven't found a module, note that this instruction is dangling.
-          if (modules.size()) { modules.back().in_module.emplace(pos); }
-          else { dangling_instructions.emplace(pos); }
+          if (modules.size()) { modules.back().range_end = pos + 1; }
+          else { ++num_dangling; }
         }
       }
       // At this point, we know about all of the modules (if any).
@@ -533,11 +591,43 @@ namespace sgp {
       // Now, we need to take care of the dangling instructions.
       // - We're going to assume the program is circular, so dangling instructions
       //   belong to the last module we found.
-      for (size_t val : dangling_instructions) modules.back().in_module.emplace(val);
+      modules.back().wrap_end = num_dangling;
+      // Record which module each program position belongs to.
+      position_modules.assign(program.GetSize(), (size_t)-1);
+      for (const module_t & module : modules) {
+        for (size_t pos = module.range_begin; pos < module.range_end; ++pos) position_modules[pos] = module.GetID();
+        for (size_t pos = 0; pos < module.wrap_end; ++pos) position_modules[pos] = module.GetID();
+      }
+      // Precompute where each block ends.
+      UpdateBlockEnds();
       // Reset matchbin
       ResetMatchBin();
     }
 
+    /// Build the block table used by FindEndOfBlock: for every block-opening (BLOCK_DEF)
+    /// instruction, scan for the end of its block once (starting from the following position,
+    /// wrapping to 0 if the module wraps around the end of the program).
+    /// Called by UpdateModules and RepackProgram. If the program has changed size since module
+    /// information was last updated, the table is left empty (FindEndOfBlock scans instead).
+    void UpdateBlockEnds() {
+      block_ends.assign(position_modules.size(), (size_t)-1);
+      if (position_modules.size() != program.GetSize()) return;
+      for (size_t pos = 0; pos < program.GetSize(); ++pos) {
+        const size_t mp = position_modules[pos];
+        if (mp == (size_t)-1) continue; // Module definitions don't belong to any module.
+        if (!inst_lib.HasProperty(program[pos].GetID(), InstProperty::BLOCK_DEF)) continue;
+        const size_t start = (pos + 1) % program.GetSize();
+        if (position_modules[start] != mp) continue;
+        block_ends[start] = ScanEndOfBlock(mp, start);
+      }
+    }
+
+    /// Get the ID of the module that the given program position belongs to.
+    /// Returns (size_t)-1 if the position is a module definition or is not a valid position.
+    size_t GetModuleAt(size_t ip) const {
+      return (ip < position_modules.size()) ? position_modules[ip] : (size_t)-1;
+    }
+
     /// Get a reference to the set of known modules.
     emp::vector<module_t> & GetModules() { return modules;  }
 
@@ -548,15 +638,52 @@ namespace sgp {
     /// How many modules does the current program have?
     size_t GetNumModules() const { return modules.size(); }
 
-    /// Grab a reference to the current program.
-    program_t & GetProgram() { return program; }
-
     /// Get a const reference to the current program.
     const program_t & GetProgram() const { return program; }
 
+    /// Grab a reference to the current program to edit it in place.
+    /// Note: in-place edits to instructions take effect on the next execution step (the packed form
+    /// of the program is rebuilt then; call RepackProgram to rebuild it sooner). Run UpdateModules
+    /// after changing module structure. Every call marks the program for rebuilding, so use
+    /// GetProgram to read it.
+    program_t & EditProgram() {
+      is_packed_program_dirty = true;
+      return program;
+    }
+
+    /// Get a const reference to the packed (execution) form of the current program
+    /// (rebuilding it first if the program may have been edited in place).
+    const packed_program_t & GetPackedProgram() {
+      if (is_packed_program_dirty) RepackProgram();
+      return packed_program;
+    }
+
     /// Get a reference to the hardware's memory model.
     memory_model_t & GetMemoryModel() { return memory_model; }
 
+    /// Get a reference to the hardware's matchbin.
+    /// The matchbin could be modified through this reference, so any memoized matches are
+    /// invalidated. To adjust regulators, use SetModuleRegulator/AdjModuleRegulator instead.
+    matchbin_t & GetMatchBin() { match_cache.Clear(); raw_match_cache.Clear(); return matchbin; }
+    const matchbin_t & GetMatchBin() const { return matchbin; }
+
+    /// Get the cache of FindModuleMatch results (e.g., to check hit/miss counts).
+    const match_cache_t & GetMatchCache() const { return match_cache; }
+
+    /// Get the cache of FindModuleMatchRaw results.
+    const match_cache_t & GetRawMatchCache() const { return raw_match_cache; }
+
+    /// Should module matches be memoized? By default, matches are memoized if the matchbin's
+    /// selector is deterministic (see IsDeterministicMatchBin).
+    void SetMatchCaching(bool use_cache) {
+      use_match_cache = use_cache;
+      match_cache.Clear();
+      raw_match_cache.Clear();
+    }
+
+    /// Are module matches being memoized?
+    bool IsMatchCaching() const { return use_match_cache; }
+
     /// Print information on loaded modules.
     void PrintModules(std::ostream & os=std::cout) const {
       os << "Modules: [";
@@ -595,7 +722,7 @@ namespace sgp {
           os << "Instruction: ";
           if (IsValidProgramPosition(flow.mp, flow.ip)) {
             // Name[tags](args)
-            const inst_t & inst = program[flow.ip];
+            const typename program_t::inst_t & inst = program[flow.ip];
             os << inst_lib.GetName(inst.id);
             os << "[";
             for (size_t ti = 0; ti < inst.tags.size(); ++ti) {
@@ -14,18 +14,22 @@ namespace toy_signalgp_impl {
   };
 }
 
-template<typename CUSTOM_COMPONET_T=sgp::DefaultCustomComponent>
-class ToySignalGP : public sgp::SignalGPBase< ToySignalGP<CUSTOM_COMPONET_T>,
+template<typename CUSTOM_COMPONET_T=sgp::DefaultCustomComponent, typename EVENT_LIB_T=void>
+class ToySignalGP : public sgp::SignalGPBase< ToySignalGP<CUSTOM_COMPONET_T, EVENT_LIB_T>,
                                                         toy_signalgp_impl::ExecState,
                                                         size_t,
-                                                        CUSTOM_COMPONET_T> {
+                                                        CUSTOM_COMPONET_T,
+                                                        sgp::NoInstrumentation,
+                                                        EVENT_LIB_T> {
 public:
-  using this_t = ToySignalGP<CUSTOM_COMPONET_T>;
+  using this_t = ToySignalGP<CUSTOM_COMPONET_T, EVENT_LIB_T>;
   using exec_state_t = toy_signalgp_impl::ExecState;            ///< REQUIRED. Thread state information.
   using base_hw_t = sgp::SignalGPBase<this_t,
                                                 exec_state_t,
                                                 size_t,
-                                                CUSTOM_COMPONET_T>;
+                                                CUSTOM_COMPONET_T,
+                                                sgp::NoInstrumentation,
+                                                EVENT_LIB_T>;
   using program_t = emp::vector<size_t>;     ///< REQUIRED. What types of programs does this stepper execute?
   using tag_t = size_t;                      ///< REQUIRED. What does this stepper use to reference different modules?
   using event_lib_t = typename base_hw_t::event_lib_t;
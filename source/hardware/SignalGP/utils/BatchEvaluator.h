@@ -0,0 +1,221 @@
+#ifndef EMP_SIGNALGP_BATCH_EVALUATOR_H
+#define EMP_SIGNALGP_BATCH_EVALUATOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "base/assert.h"
+#include "base/Ptr.h"
+#include "base/vector.h"
+#include "tools/Random.h"
+
+namespace sgp {
+
+  /// Evaluate batches of programs across a pool of worker threads.
+  /// - Each worker owns its own random number generator and pre-constructed hardware
+  ///   (reused across programs), so nothing mutable is shared between threads.
+  /// - The instruction and event libraries ARE shared (hardware only holds references);
+  ///   they must not be modified while a batch is being evaluated, and any instruction/event
+  ///   handler that touches state outside of its hardware must be thread-safe.
+  /// - Before evaluating program i, the worker's random number generator is reseeded with
+  ///   (seed + i), so results do not depend on which worker evaluates which program.
+  /// - Programs are dealt out to per-worker queues in contiguous chunks; workers that run out
+  ///   of work steal from the back of other workers' queues to balance uneven runtimes.
+  ///
+  /// Usage:
+  ///   BatchEvaluator<hardware_t> evaluator(inst_lib, event_lib, 8);
+  ///   evaluator.Evaluate(programs, [&](hardware_t & hw, const program_t & program, size_t i) {
+  ///     hw.SetProgram(program); hw.QueueEvent(...); hw.Process(128); scores[i] = ...;
+  ///   });
+  template<typename HARDWARE_T>
+  class BatchEvaluator {
+  public:
+    using hardware_t = HARDWARE_T;
+    using program_t = typename hardware_t::program_t;
+    using inst_lib_t = typename hardware_t::inst_lib_t;
+    using event_lib_t = typename hardware_t::event_lib_t;
+
+    /// Evaluation callback: load program onto hardware, run it, and record results (at program_id).
+    using eval_fun_t = std::function<void(hardware_t & hw, const program_t & program, size_t program_id)>;
+    /// Hardware configuration callback: run once on each worker's hardware after construction.
+    using setup_fun_t = std::function<void(hardware_t & hw)>;
+
+  protected:
+    /// Everything that belongs to a single worker thread.
+    struct Worker {
+      emp::Random random;             ///< Worker-local random number generator (used by hardware).
+      hardware_t hardware;            ///< Worker-local hardware.
+      std::mutex queue_mutex;         ///< Protects queue (the owner pops the front, thieves the back).
+      std::deque<size_t> queue;       ///< Program IDs waiting to be evaluated.
+
+      Worker(int seed, inst_lib_t & ilib, event_lib_t & elib)
+        : random(seed), hardware(random, ilib, elib), queue_mutex(), queue() { ; }
+    };
+
+    emp::vector<emp::Ptr<Worker>> workers;
+    emp::vector<std::thread> threads;
+    int seed;
+
+    // Current batch.
+    const program_t * batch_programs=nullptr;
+    size_t batch_size=0;
+    const eval_fun_t * batch_eval=nullptr;
+    std::exception_ptr batch_error=nullptr;
+
+    // Coordination between the evaluating (calling) thread and workers.
+    std::mutex pool_mutex;
+    std::condition_variable start_cv;     ///< Signals workers that a batch is ready (or that we're stopping).
+    std::condition_variable done_cv;      ///< Signals the calling thread that a worker finished its batch.
+    size_t batch_count=0;                 ///< Incremented for every new batch.
+    size_t num_finished=0;                ///< Number of workers done with the current batch.
+    bool stop=false;
+
+    /// Grab the next program to evaluate: from the front of our own queue or, failing that,
+    /// from the back of someone else's.
+    bool NextTask(size_t worker_id, size_t & program_id) {
+      {
+        Worker & worker = *workers[worker_id];
+        std::lock_guard<std::mutex> lock(worker.queue_mutex);
+        if (worker.queue.size()) {
+          program_id = worker.queue.front();
+          worker.queue.pop_front();
+          return true;
+        }
+      }
+      for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker & victim = *workers[(worker_id + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.queue_mutex);
+        if (victim.queue.size()) {
+          program_id = victim.queue.back();
+          victim.queue.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void RunWorker(size_t worker_id) {
+      size_t seen_batch = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(pool_mutex);
+          start_cv.wait(lock, [this, seen_batch]() { return stop || batch_count != seen_batch; });
+          if (stop) return;
+          seen_batch = batch_count;
+        }
+        Worker & worker = *workers[worker_id];
+        size_t program_id = 0;
+        // No new work shows up mid-batch, so once every queue is empty we're done.
+        while (NextTask(worker_id, program_id)) {
+          try {
+            worker.random.ResetSeed(seed + (int)program_id);
+            (*batch_eval)(worker.hardware, batch_programs[program_id], program_id);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (!batch_error) batch_error = std::current_exception();
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(pool_mutex);
+          ++num_finished;
+        }
+        done_cv.notify_one();
+      }
+    }
+
+  public:
+    /// @param ilib shared instruction library (read-only during evaluation).
+    /// @param elib shared event library (read-only during evaluation).
+    /// @param num_workers number of worker threads (and hardware instances).
+    /// @param _seed base random seed (program i is evaluated with seed _seed + i); must be > 0.
+    /// @param setup optional configuration to apply to each worker's hardware.
+    BatchEvaluator(inst_lib_t & ilib, event_lib_t & elib,
+                   size_t num_workers=std::thread::hardware_concurrency(),
+                   int _seed=1,
+                   const setup_fun_t & setup=setup_fun_t())
+      : workers(), threads(), seed(_seed)
+    {
+      emp_assert(_seed > 0, "Seeds <= 0 are not reproducible.");
+      if (num_workers == 0) num_workers = 1;
+      for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(emp::NewPtr<Worker>(_seed, ilib, elib));
+        if (setup) setup(workers.back()->hardware);
+      }
+      for (size_t i = 0; i < num_workers; ++i) {
+        threads.emplace_back([this, i]() { RunWorker(i); });
+      }
+    }
+
+    BatchEvaluator(const BatchEvaluator &) = delete;
+    BatchEvaluator(BatchEvaluator &&) = delete;
+    BatchEvaluator & operator=(const BatchEvaluator &) = delete;
+    BatchEvaluator & operator=(BatchEvaluator &&) = delete;
+
+    ~BatchEvaluator() {
+      {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stop = true;
+      }
+      start_cv.notify_all();
+      for (std::thread & thread : threads) thread.join();
+      for (emp::Ptr<Worker> worker : workers) worker.Delete();
+    }
+
+    /// How many worker threads (and hardware instances) do we have?
+    size_t GetNumWorkers() const { return workers.size(); }
+
+    /// Get a worker's hardware (e.g., to reconfigure it between batches).
+    /// Do not use while a batch is being evaluated.
+    hardware_t & GetHardware(size_t worker_id) {
+      emp_assert(worker_id < workers.size());
+      return workers[worker_id]->hardware;
+    }
+
+    /// Evaluate num_programs programs (starting at programs) with eval. Blocks until every
+    /// program has been evaluated. If any evaluation throws, the first exception is rethrown here
+    /// (after the rest of the batch finishes).
+    void Evaluate(const program_t * programs, size_t num_programs, const eval_fun_t & eval) {
+      if (num_programs == 0) return;
+      // Deal out contiguous chunks of programs to each worker.
+      const size_t num_workers = workers.size();
+      for (size_t w = 0; w < num_workers; ++w) {
+        const size_t begin = (num_programs * w) / num_workers;
+        const size_t end = (num_programs * (w + 1)) / num_workers;
+        Worker & worker = *workers[w];
+        std::lock_guard<std::mutex> lock(worker.queue_mutex);
+        for (size_t i = begin; i < end; ++i) worker.queue.emplace_back(i);
+      }
+      std::exception_ptr error = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        batch_programs = programs;
+        batch_size = num_programs;
+        batch_eval = &eval;
+        batch_error = nullptr;
+        num_finished = 0;
+        ++batch_count;
+        start_cv.notify_all();
+        done_cv.wait(lock, [this]() { return num_finished == workers.size(); });
+        batch_programs = nullptr;
+        batch_size = 0;
+        batch_eval = nullptr;
+        error = batch_error;
+        batch_error = nullptr;
+      }
+      if (error) std::rethrow_exception(error);
+    }
+
+    /// Evaluate every program in the given vector.
+    void Evaluate(const emp::vector<program_t> & programs, const eval_fun_t & eval) {
+      Evaluate(programs.data(), programs.size(), eval);
+    }
+  };
+
+}
+
+#endif
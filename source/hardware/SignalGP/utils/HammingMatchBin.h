@@ -0,0 +1,233 @@
+#ifndef EMP_SIGNALGP_HAMMING_MATCHBIN_H
+#define EMP_SIGNALGP_HAMMING_MATCHBIN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX512VPOPCNTDQ__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "base/assert.h"
+#include "base/vector.h"
+#include "tools/BitSet.h"
+#include "tools/Random.h"
+#include "tools/matchbin_utils.h"
+
+#include "MatchCache.h"
+
+namespace sgp {
+
+  /// Matchbin specialized for emp::BitSet<W> tags compared by Hamming distance.
+  /// Matches exactly like emp::MatchBin<VAL_T, emp::HammingMetric<W>, emp::RankedSelector<THRESH_RATIO>, REGULATOR_T>
+  /// (ties go to the module added first), and can be used as the MATCHBIN_T of
+  /// LinearProgramSignalGP or LinearFunctionsProgramSignalGP.
+  /// All module tags are stored contiguously (word-major, so that one vector register holds the same
+  /// word of several tags), and a lookup scores modules in fixed-size blocks: Hamming distances for a
+  /// block are computed with XOR + popcount (using AVX-512 VPOPCNTDQ or AVX2 when the build enables
+  /// them, scalar popcount otherwise), then regulated and offered to a bounded top-n selection
+  /// before moving on to the next block.
+  template<size_t W,
+           typename VAL_T=size_t,
+           typename REGULATOR_T=emp::AdditiveCountdownRegulator<>,
+           typename THRESH_RATIO=std::ratio<-1,1>>
+  class HammingMatchBin {
+  public:
+    using query_t = emp::BitSet<W>;
+    using tag_t = emp::BitSet<W>;
+    using uid_t = size_t;
+    using val_t = VAL_T;
+    using regulator_t = REGULATOR_T;
+
+    static constexpr size_t NUM_WORDS = (W + 63) / 64;  ///< 64-bit words per tag.
+    static constexpr size_t LANES = 8;                  ///< Tag storage is padded to a multiple of LANES tags.
+    static constexpr size_t BLOCK_SIZE = 64;            ///< Modules scored per block (multiple of LANES).
+
+  protected:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    static constexpr size_t NUM_UINTS = (W + 31) / 32;
+
+    // Per-module state, indexed by insertion order.
+    emp::vector<uid_t> uids;
+    emp::vector<val_t> values;
+    emp::vector<tag_t> tags;
+    emp::vector<regulator_t> regulators;
+    emp::vector<size_t> positions;     ///< uid => index of module (NONE if uid isn't in the matchbin)
+
+    // Tags stored word-major: words[k * stride + i] is the k'th word of the i'th module's tag.
+    // Rebuilt lazily (on the next lookup) whenever modules are added.
+    emp::vector<uint64_t> words;
+    size_t stride=0;
+    bool words_dirty=false;
+
+    emp::vector<std::pair<double, size_t>> best; ///< Scratch: (score, index) of best matches so far.
+
+    static constexpr double GetThreshold() {
+      return (THRESH_RATIO::num < 0) ? std::numeric_limits<double>::infinity()
+                                     : (double)THRESH_RATIO::num / (double)THRESH_RATIO::den;
+    }
+
+    /// Pack bits into 64-bit words.
+    static void LoadWords(const tag_t & bits, uint64_t * out) {
+      for (size_t k = 0; k < NUM_WORDS; ++k) {
+        const uint64_t lo = bits.GetUInt(2 * k);
+        const uint64_t hi = (2 * k + 1 < NUM_UINTS) ? bits.GetUInt(2 * k + 1) : 0;
+        out[k] = lo | (hi << 32);
+      }
+    }
+
+    void RebuildWords() {
+      stride = ((uids.size() + LANES - 1) / LANES) * LANES;
+      words.assign(NUM_WORDS * stride, 0);
+      uint64_t tag_words[NUM_WORDS];
+      for (size_t i = 0; i < tags.size(); ++i) {
+        LoadWords(tags[i], tag_words);
+        for (size_t k = 0; k < NUM_WORDS; ++k) words[k * stride + i] = tag_words[k];
+      }
+      words_dirty = false;
+    }
+
+    size_t GetIndex(uid_t uid) const {
+      emp_assert(Has(uid), "Unknown uid", uid);
+      return positions[uid];
+    }
+
+    /// Hamming distances between query and tags [begin, begin + count) => out.
+    /// begin and count must be multiples of LANES.
+    void ComputeDistances(const uint64_t * query, size_t begin, size_t count, uint64_t * out) const {
+      const uint64_t * base = words.data() + begin;
+      #if defined(__AVX512VPOPCNTDQ__)
+      for (size_t i = 0; i < count; i += 8) {
+        __m512i acc = _mm512_setzero_si512();
+        for (size_t k = 0; k < NUM_WORDS; ++k) {
+          const __m512i v = _mm512_loadu_si512((const void *)(base + k * stride + i));
+          acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_xor_si512(v, _mm512_set1_epi64((long long)query[k]))));
+        }
+        _mm512_storeu_si512((void *)(out + i), acc);
+      }
+      #elif defined(__AVX2__)
+      // Nibble-lookup popcount (no vector popcount instruction in AVX2).
+      const __m256i lookup = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                              0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+      const __m256i low_mask = _mm256_set1_epi8(0x0f);
+      for (size_t i = 0; i < count; i += 4) {
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t k = 0; k < NUM_WORDS; ++k) {
+          const __m256i v = _mm256_loadu_si256((const __m256i *)(base + k * stride + i));
+          const __m256i x = _mm256_xor_si256(v, _mm256_set1_epi64x((long long)query[k]));
+          const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low_mask));
+          const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask));
+          acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        _mm256_storeu_si256((__m256i *)(out + i), acc);
+      }
+      #else
+      for (size_t i = 0; i < count; ++i) out[i] = 0;
+      for (size_t k = 0; k < NUM_WORDS; ++k) {
+        const uint64_t * row = base + k * stride;
+        for (size_t i = 0; i < count; ++i) out[i] += (uint64_t)__builtin_popcountll(row[i] ^ query[k]);
+      }
+      #endif
+    }
+
+    /// Offer module at index to the (sorted) top-n selection.
+    void Offer(double score, size_t index, size_t n) {
+      if (best.size() == n) {
+        if (score >= best.back().first) return; // Ties go to the earlier module.
+        best.pop_back();
+      }
+      best.emplace_back(score, index);
+      for (size_t j = best.size() - 1; j > 0 && best[j - 1].first > score; --j) std::swap(best[j - 1], best[j]);
+    }
+
+    template<bool REGULATED>
+    emp::vector<uid_t> MatchImpl(const query_t & query, size_t n) {
+      const size_t size = uids.size();
+      if (!n || !size) return {};
+      if (words_dirty) RebuildWords();
+      constexpr double thresh = GetThreshold();
+      uint64_t query_words[NUM_WORDS];
+      LoadWords(query, query_words);
+      // If everything that passes the threshold is returned, skip the bounded selection and sort once.
+      const bool bounded = n < size;
+      best.clear();
+      uint64_t distances[BLOCK_SIZE];
+      for (size_t begin = 0; begin < size; begin += BLOCK_SIZE) {
+        ComputeDistances(query_words, begin, std::min(BLOCK_SIZE, stride - begin), distances);
+        const size_t end = std::min(size, begin + BLOCK_SIZE);
+        for (size_t i = begin; i < end; ++i) {
+          const double raw = (double)distances[i - begin] / W;
+          const double score = REGULATED ? regulators[i](raw) : raw;
+          if (!(score <= thresh)) continue;
+          if (bounded) Offer(score, i, n);
+          else best.emplace_back(score, i);
+        }
+      }
+      if (!bounded) {
+        std::stable_sort(best.begin(), best.end(),
+                         [](const auto & a, const auto & b) { return a.first < b.first; });
+      }
+      emp::vector<uid_t> matches(best.size());
+      for (size_t j = 0; j < best.size(); ++j) matches[j] = uids[best[j].second];
+      return matches;
+    }
+
+  public:
+    HammingMatchBin(emp::Random & rnd) { ; }
+
+    /// Find the n best-matching (regulated) modules for query.
+    emp::vector<uid_t> Match(const query_t & query, size_t n=1) { return MatchImpl<true>(query, n); }
+
+    /// Find the n best-matching modules for query, ignoring regulation.
+    emp::vector<uid_t> MatchRaw(const query_t & query, size_t n=1) { return MatchImpl<false>(query, n); }
+
+    /// Add a module (val) with the given tag and uid.
+    uid_t Set(const val_t & val, const tag_t & tag, const uid_t uid) {
+      emp_assert(!Has(uid), "uid already in matchbin", uid);
+      if (uid >= positions.size()) positions.resize(uid + 1, NONE);
+      positions[uid] = uids.size();
+      uids.emplace_back(uid);
+      values.emplace_back(val);
+      tags.emplace_back(tag);
+      regulators.emplace_back();
+      words_dirty = true;
+      return uid;
+    }
+
+    void Clear() {
+      uids.clear();
+      values.clear();
+      tags.clear();
+      regulators.clear();
+      positions.clear();
+      words.clear();
+      stride = 0;
+      words_dirty = false;
+    }
+
+    bool Has(uid_t uid) const { return uid < positions.size() && positions[uid] != NONE; }
+    size_t Size() const { return uids.size(); }
+    const emp::vector<uid_t> & ViewUIDs() const { return uids; }
+
+    val_t & GetVal(uid_t uid) { return values[GetIndex(uid)]; }
+    const val_t & GetVal(uid_t uid) const { return values[GetIndex(uid)]; }
+    const tag_t & GetTag(uid_t uid) const { return tags[GetIndex(uid)]; }
+
+    void SetRegulator(uid_t uid, double value) { regulators[GetIndex(uid)].Set(value); }
+    void AdjRegulator(uid_t uid, double amount) { regulators[GetIndex(uid)].Adj(amount); }
+    void DecayRegulator(uid_t uid, int steps) { regulators[GetIndex(uid)].Decay(steps); }
+    void DecayRegulators(int steps=1) { for (regulator_t & regulator : regulators) regulator.Decay(steps); }
+    double ViewRegulator(uid_t uid) const { return regulators[GetIndex(uid)].View(); }
+  };
+
+  template<size_t W, typename VAL_T, typename REGULATOR_T, typename THRESH_RATIO>
+  struct IsDeterministicMatchBin<HammingMatchBin<W, VAL_T, REGULATOR_T, THRESH_RATIO>>
+    : std::true_type { };
+
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef EMP_INSTRUCTION_LIBRARY_H
 #define EMP_INSTRUCTION_LIBRARY_H
 
+#include <functional>
+#include <initializer_list>
 #include <map>
+#include <tuple>
 #include <unordered_set>
 #include <string>
 
@@ -139,7 +142,107 @@ namespace sgp {
     template <typename IN_HW>
     void ProcessInst(emp::Ptr<IN_HW> hw, const inst_t & inst) const {
       emp_assert( dynamic_cast<hardware_t*>(hw.Raw()) );
-      inst_lib[inst.id].fun_call(*(hw.template Cast<hardware_t>()), inst);
+      ProcessInst(*(hw.template Cast<hardware_t>()), inst);
+    }
+  };
+
+  /// Wrap an instruction function (e.g., sgp::inst_impl::Inst_Inc<hw_t, inst_t>) as an
+  /// instruction functor for StaticInstructionLibrary.
+  template<auto INST_FUN>
+  struct InstFun {
+    template<typename HARDWARE_T, typename INSTRUCTION_T>
+    void operator()(HARDWARE_T & hw, const INSTRUCTION_T & inst) const { INST_FUN(hw, inst); }
+  };
+
+  /// Instruction library whose first sizeof...(INST_FUNS) instructions are fixed at compile time.
+  /// - INST_FUNS is a typelist of default-constructible instruction functors (see InstFun);
+  ///   instruction i (ID i) is INST_FUNS[i].
+  /// - Those instructions are dispatched through a switch over instruction IDs (letting the
+  ///   compiler build a jump table and inline instruction bodies) rather than through a
+  ///   std::function per instruction.
+  /// - Hardware must be given this type as its library type to get compile-time dispatch, e.g.,
+  ///     template<typename HW, typename INST, typename PROP>
+  ///     using inst_lib_t = StaticInstructionLibrary<HW, INST, PROP,
+  ///                                                 InstFun<&inst_impl::Inst_Inc<HW, INST>>, ...>;
+  ///     using hw_t = LinearProgramSignalGP<..., EVENT_LIB_T, inst_lib_t>;
+  ///   (ProcessInst isn't virtual; through an InstructionLibrary reference, every instruction is
+  ///   dispatched through its std::function.)
+  /// - AddInst may still append (dynamically dispatched) instructions after the static set.
+  template<typename HARDWARE_T, typename INSTRUCTION_T, typename INSTRUCTION_PROPERTY_T, typename... INST_FUNS>
+  class StaticInstructionLibrary : public InstructionLibrary<HARDWARE_T, INSTRUCTION_T, INSTRUCTION_PROPERTY_T> {
+  public:
+    using base_t = InstructionLibrary<HARDWARE_T, INSTRUCTION_T, INSTRUCTION_PROPERTY_T>;
+    using hardware_t = HARDWARE_T;
+    using inst_t = INSTRUCTION_T;
+    using inst_prop_t = INSTRUCTION_PROPERTY_T;
+
+    static constexpr size_t NUM_STATIC_INSTS = sizeof...(INST_FUNS);
+
+    template<size_t ID>
+    using inst_fun_at_t = std::tuple_element_t<ID, std::tuple<INST_FUNS...>>;
+
+    /// Name, description, and properties of a statically dispatched instruction.
+    struct StaticInstInfo {
+      std::string name;
+      std::string desc;
+      std::unordered_set<inst_prop_t> properties;
+
+      StaticInstInfo(const std::string & _name,
+                     const std::string & _desc="",
+                     const std::unordered_set<inst_prop_t> & _properties=std::unordered_set<inst_prop_t>())
+        : name(_name), desc(_desc), properties(_properties) { ; }
+    };
+
+  protected:
+    static constexpr size_t CASES_PER_SWITCH = 16;
+
+    /// Dispatch instruction IDs [BASE, BASE+CASES_PER_SWITCH); defer larger IDs to the next switch.
+    template<size_t BASE>
+    static void DispatchFrom(hardware_t & hw, const inst_t & inst) {
+      #define SGP_STATIC_INST_CASE(I)                                              \
+        case I:                                                                    \
+          if constexpr (BASE + I < NUM_STATIC_INSTS) inst_fun_at_t<BASE + I>()(hw, inst); \
+          return;
+      switch (inst.GetID() - BASE) {
+        SGP_STATIC_INST_CASE(0)  SGP_STATIC_INST_CASE(1)  SGP_STATIC_INST_CASE(2)  SGP_STATIC_INST_CASE(3)
+        SGP_STATIC_INST_CASE(4)  SGP_STATIC_INST_CASE(5)  SGP_STATIC_INST_CASE(6)  SGP_STATIC_INST_CASE(7)
+        SGP_STATIC_INST_CASE(8)  SGP_STATIC_INST_CASE(9)  SGP_STATIC_INST_CASE(10) SGP_STATIC_INST_CASE(11)
+        SGP_STATIC_INST_CASE(12) SGP_STATIC_INST_CASE(13) SGP_STATIC_INST_CASE(14) SGP_STATIC_INST_CASE(15)
+        default:
+          if constexpr (BASE + CASES_PER_SWITCH < NUM_STATIC_INSTS) DispatchFrom<BASE + CASES_PER_SWITCH>(hw, inst);
+          return;
+      }
+      #undef SGP_STATIC_INST_CASE
+    }
+
+    template<size_t... IDS>
+    void AddStaticInsts(const emp::vector<StaticInstInfo> & info, std::index_sequence<IDS...>) {
+      (this->AddInst(info[IDS].name,
+                     [](hardware_t & hw, const inst_t & inst) { inst_fun_at_t<IDS>()(hw, inst); },
+                     info[IDS].desc,
+                     info[IDS].properties), ...);
+    }
+
+  public:
+    /// Construct from one StaticInstInfo per functor in INST_FUNS (in the same order).
+    StaticInstructionLibrary(std::initializer_list<StaticInstInfo> info) : base_t() {
+      emp_assert(info.size() == NUM_STATIC_INSTS, "Need one StaticInstInfo per static instruction.", info.size(), NUM_STATIC_INSTS);
+      AddStaticInsts(emp::vector<StaticInstInfo>(info), std::index_sequence_for<INST_FUNS...>());
+    }
+
+    /// Get the number of instructions (IDs [0, N)) dispatched at compile time.
+    static constexpr size_t GetNumStaticInsts() { return NUM_STATIC_INSTS; }
+
+    /// Process a specified instruction in the provided hardware.
+    void ProcessInst(hardware_t & hw, const inst_t & inst) const {
+      if (inst.GetID() < NUM_STATIC_INSTS) Dispatch(hw, inst);
+      else base_t::ProcessInst(hw, inst);
+    }
+
+    /// Execute a statically dispatched instruction (ID must be < NUM_STATIC_INSTS).
+    static void Dispatch(hardware_t & hw, const inst_t & inst) {
+      emp_assert(inst.GetID() < NUM_STATIC_INSTS);
+      DispatchFrom<0>(hw, inst);
     }
   };
 }
@@ -31,9 +31,9 @@ namespace sgp {
     sequence_t inst_sequence;
 
   public:
-    LinearFunction(const emp::vector<tag_t> & _tags,
-                   const sequence_t & _inst_sequence=sequence_t())
-      : tags(_tags), inst_sequence(_inst_sequence)
+    LinearFunction(emp::vector<tag_t> _tags,
+                   sequence_t _inst_sequence=sequence_t())
+      : tags(std::move(_tags)), inst_sequence(std::move(_inst_sequence))
     {
       emp_assert(tags.size(), "A function MUST have at least one tag.");
     }
@@ -178,6 +178,9 @@ namespace sgp {
     /// Push new function into program. New function will be a copy given function.
     void PushFunction(const function_t & func) { program.emplace_back(func); }
 
+    /// Push new function into program (taking the given function).
+    void PushFunction(function_t && func) { program.emplace_back(std::move(func)); }
+
     /// Push new function into program. Construct function from given tag and from
     /// given LinearProgram object.
     void PushFunction(const tag_t & tag, const LinearProgram<tag_t, arg_t> & seq=LinearProgram<tag_t, arg_t>()) {
@@ -312,6 +315,62 @@ namespace sgp {
     }
     return new_program;
   }
+
+  /// Generate a population of random programs (each generated as by GenRandLinearFunctionsProgram)
+  /// in one pass: function counts and sizes are drawn first, then every function and instruction
+  /// tag in the population is drawn into a single buffer (see emp::FillRandomBitSets), which
+  /// functions and instructions are built from.
+  template<typename HARDWARE_T, size_t TAG_WIDTH>
+  emp::vector<LinearFunctionsProgram<emp::BitSet<TAG_WIDTH>, int>> GenRandLinearFunctionsPrograms(
+    emp::Random & rnd,
+    const InstructionLibrary<HARDWARE_T,
+                             typename LinearProgram< emp::BitSet<TAG_WIDTH>, int>::Instruction,
+                             typename HARDWARE_T::inst_prop_t> & inst_lib,
+    size_t num_programs,
+    const emp::Range<size_t> & num_func_range={1, 4},
+    size_t num_func_tags=1,
+    const emp::Range<size_t> & func_inst_cnt_range={1, 32},
+    size_t num_inst_tags=1,
+    size_t num_inst_args=3,
+    const emp::Range<int> & arg_val_range={0, 15}
+  ) {
+    emp_assert(inst_lib.GetSize() > 0, "Instruction library must have at least one instruction definition before being used to generate a random instruction.");
+    using tag_t = emp::BitSet<TAG_WIDTH>;
+    using program_t = LinearFunctionsProgram<tag_t, int>;
+    using sequence_t = LinearProgram<tag_t, int>;
+    emp::vector<size_t> func_cnts(num_programs);
+    emp::vector<size_t> inst_cnts;
+    for (size_t & func_cnt : func_cnts) {
+      func_cnt = rnd.GetUInt(num_func_range.GetLower(), num_func_range.GetUpper()+1);
+      for (size_t f = 0; f < func_cnt; ++f) {
+        inst_cnts.emplace_back(rnd.GetUInt(func_inst_cnt_range.GetLower(), func_inst_cnt_range.GetUpper()+1));
+      }
+    }
+    size_t total_inst_cnt = 0;
+    for (size_t inst_cnt : inst_cnts) total_inst_cnt += inst_cnt;
+    emp::vector<tag_t> tags;
+    emp::FillRandomBitSets(rnd, tags, inst_cnts.size() * num_func_tags + total_inst_cnt * num_inst_tags);
+    emp::vector<program_t> programs(num_programs);
+    auto tag_it = tags.cbegin();
+    auto inst_cnt_it = inst_cnts.cbegin();
+    for (size_t p = 0; p < num_programs; ++p) {
+      for (size_t f = 0; f < func_cnts[p]; ++f, ++inst_cnt_it) {
+        emp::vector<tag_t> func_tags(tag_it, tag_it + num_func_tags);
+        tag_it += num_func_tags;
+        sequence_t sequence;
+        sequence.Reserve(*inst_cnt_it);
+        for (size_t i = 0; i < *inst_cnt_it; ++i) {
+          emp::vector<int> args(num_inst_args);
+          for (int & arg : args) arg = rnd.GetInt(arg_val_range.GetLower(), arg_val_range.GetUpper()+1);
+          const size_t inst_id = rnd.GetUInt(inst_lib.GetSize());
+          sequence.PushInst({inst_id, std::move(args), emp::vector<tag_t>(tag_it, tag_it + num_inst_tags)});
+          tag_it += num_inst_tags;
+        }
+        programs[p].PushFunction(typename program_t::function_t(std::move(func_tags), std::move(sequence)));
+      }
+    }
+    return programs;
+  }
 }
 
 #endif
@@ -1,7 +1,11 @@
 #ifndef EMP_SIGNALGP_LINEAR_PROGRAM_H
 #define EMP_SIGNALGP_LINEAR_PROGRAM_H
 
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <utility>
 
 #include "base/Ptr.h"
@@ -38,9 +42,9 @@ namespace sgp {
       emp::vector<tag_t> tags;
 
       Instruction(size_t _id,
-                  const emp::vector<arg_t> & _args=emp::vector<arg_t>(),
-                  const emp::vector<tag_t> & _tags=emp::vector<tag_t>())
-        : id(_id), args(_args), tags(_tags) { ; }
+                  emp::vector<arg_t> _args=emp::vector<arg_t>(),
+                  emp::vector<tag_t> _tags=emp::vector<tag_t>())
+        : id(_id), args(std::move(_args)), tags(std::move(_tags)) { ; }
 
       bool operator==(const Instruction & other) const {
         return std::tie(id, args, tags) == std::tie(other.id, other.args, other.tags);
@@ -66,8 +70,8 @@ namespace sgp {
       const tag_t & GetTag(size_t i) const { return tags[i]; }
 
       // Print each of the instruction's tag followed by the instruction and its arguments
-      template<typename HARDWARE_T, typename INST_PROPERTY_T>
-      void Print(std::ostream& out, const InstructionLibrary<HARDWARE_T, inst_t, INST_PROPERTY_T>& ilib) const{
+      template<typename HARDWARE_T, typename ILIB_INST_T, typename INST_PROPERTY_T>
+      void Print(std::ostream& out, const InstructionLibrary<HARDWARE_T, ILIB_INST_T, INST_PROPERTY_T>& ilib) const{
         out << "\t";
         // Skip last tag & arg so we dont get an extra delimiter.
         std::copy(tags.begin(), tags.end() - 1, std::ostream_iterator<tag_t>(out, "\n\t"));
@@ -123,8 +127,9 @@ namespace sgp {
     }
 
     /// Push instruction to program by name.
-    template<typename HARDWARE_T, typename INST_PROPERTY_T>
-    void PushInst(const InstructionLibrary<HARDWARE_T, Instruction, INST_PROPERTY_T> & ilib,
+    /// (The library may execute instructions in another form, e.g., PackedLinearProgram::Instruction.)
+    template<typename HARDWARE_T, typename ILIB_INST_T, typename INST_PROPERTY_T>
+    void PushInst(const InstructionLibrary<HARDWARE_T, ILIB_INST_T, INST_PROPERTY_T> & ilib,
                   const std::string & name,
                   const emp::vector<arg_t> & args=emp::vector<arg_t>(),
                   const emp::vector<tag_t> & tags=emp::vector<tag_t>()) {
@@ -135,22 +140,235 @@ namespace sgp {
     /// Push instruction to program.
     void PushInst(const Instruction & inst) { inst_seq.emplace_back(inst); }
 
+    /// Push instruction to program (taking its arguments and tags).
+    void PushInst(Instruction && inst) { inst_seq.emplace_back(std::move(inst)); }
+
+    /// Reserve space for the given number of instructions.
+    void Reserve(size_t n) { inst_seq.reserve(n); }
+
     /// Is the given instruction valid?
-    template<typename HARDWARE_T, typename INST_PROPERTY_T>
-    static bool IsValidInst(const InstructionLibrary<HARDWARE_T, Instruction, INST_PROPERTY_T> & ilib,
+    template<typename HARDWARE_T, typename ILIB_INST_T, typename INST_PROPERTY_T>
+    static bool IsValidInst(const InstructionLibrary<HARDWARE_T, ILIB_INST_T, INST_PROPERTY_T> & ilib,
                             const Instruction & inst) {
       return inst.id < ilib.GetSize();
     }
     
     // Print each instruction out
-    template<typename HARDWARE_T, typename INST_PROPERTY_T>
-    void Print(std::ostream& out, const InstructionLibrary<HARDWARE_T, inst_t, INST_PROPERTY_T>& ilib) const{
+    template<typename HARDWARE_T, typename ILIB_INST_T, typename INST_PROPERTY_T>
+    void Print(std::ostream& out, const InstructionLibrary<HARDWARE_T, ILIB_INST_T, INST_PROPERTY_T>& ilib) const{
       for(auto const& inst : inst_seq){
         inst.Print(out, ilib);
       }
     }
   };
 
+  /// Read-only view of a contiguous run of values (e.g., a packed instruction's arguments or tags).
+  template<typename T>
+  class InstSpan {
+  protected:
+    const T * data_ptr;
+    size_t len;
+
+  public:
+    InstSpan(const T * _data=nullptr, size_t _len=0) : data_ptr(_data), len(_len) { ; }
+
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    const T * data() const { return data_ptr; }
+    const T * begin() const { return data_ptr; }
+    const T * end() const { return data_ptr + len; }
+    const T & front() const { emp_assert(len); return data_ptr[0]; }
+    const T & back() const { emp_assert(len); return data_ptr[len - 1]; }
+    const T & operator[](size_t i) const { emp_assert(i < len, i, len); return data_ptr[i]; }
+  };
+
+  /// Execution form of a LinearProgram (built by hardware when a program is loaded).
+  /// - Each instruction is a fixed-width record: instruction ID, up to INLINE_ARGS
+  ///   arguments stored inline, and where to find the rest of its arguments and its tags.
+  /// - Tags (and the arguments of any instruction with more than INLINE_ARGS arguments)
+  ///   live in pools shared by the whole program, so there are no per-instruction allocations.
+  /// - Instructions provide the same read-only interface as LinearProgram::Instruction
+  ///   (GetID, GetArg, GetTag, GetArgs, GetTags).
+  /// - Instructions copied out of a packed program (or converted from a LinearProgram::Instruction)
+  ///   hold their own copy of any pooled arguments and tags, so they stay valid after the program
+  ///   is reloaded, cleared, or destroyed.
+  /// - LinearProgram remains the form to edit/mutate/serialize; rebuild with Load afterwards.
+  template<typename TAG_T, typename ARGUMENT_T=int, size_t INLINE_ARGS=3>
+  class PackedLinearProgram {
+  public:
+    class Instruction;
+    using tag_t = TAG_T;
+    using arg_t = ARGUMENT_T;
+    using inst_t = Instruction;
+    using source_program_t = LinearProgram<tag_t, arg_t>;
+
+    class Instruction {
+      friend class PackedLinearProgram;
+
+    protected:
+      /// Arguments/tags of an instruction that isn't part of a packed program.
+      struct Storage {
+        emp::vector<arg_t> args;
+        emp::vector<tag_t> tags;
+      };
+
+      size_t id=0;                                 ///< Instruction ID
+      std::array<arg_t, INLINE_ARGS> inline_args{};
+      size_t num_args=0;
+      const arg_t * pooled_args=nullptr;           ///< Arguments if there are more than INLINE_ARGS.
+      InstSpan<tag_t> tags;
+      std::shared_ptr<const Storage> storage;      ///< Set only for instructions outside of a program.
+
+      /// Point pooled arguments and tags at the given storage.
+      void Adopt(std::shared_ptr<const Storage> _storage) {
+        storage = std::move(_storage);
+        pooled_args = (num_args > INLINE_ARGS) ? storage->args.data() : nullptr;
+        tags = InstSpan<tag_t>(storage->tags.data(), storage->tags.size());
+      }
+
+    public:
+      Instruction() : tags(), storage() { ; }
+
+      /// Copy an instruction (sharing the arguments/tags of an instruction outside of a program, and
+      /// copying them out of the program otherwise).
+      Instruction(const Instruction & other)
+        : id(other.id), inline_args(other.inline_args), num_args(other.num_args), tags(), storage()
+      {
+        if (other.storage) {
+          Adopt(other.storage);
+        } else if (num_args > INLINE_ARGS || !other.tags.empty()) {
+          emp::vector<arg_t> args;
+          if (num_args > INLINE_ARGS) args.assign(other.pooled_args, other.pooled_args + num_args);
+          Adopt(std::make_shared<const Storage>(Storage{std::move(args),
+                                                        emp::vector<tag_t>(other.tags.begin(), other.tags.end())}));
+        }
+      }
+
+      /// Convert a LinearProgram instruction.
+      Instruction(const typename source_program_t::inst_t & inst)
+        : id(inst.GetID()), num_args(inst.GetArgs().size()), tags(), storage()
+      {
+        if (num_args <= INLINE_ARGS) std::copy(inst.GetArgs().begin(), inst.GetArgs().end(), inline_args.begin());
+        Adopt(std::make_shared<const Storage>(Storage{num_args > INLINE_ARGS ? inst.GetArgs() : emp::vector<arg_t>(),
+                                                      inst.GetTags()}));
+      }
+
+      Instruction(Instruction &&) = default;
+      Instruction & operator=(Instruction &&) = default;
+      Instruction & operator=(const Instruction & other) { return *this = Instruction(other); }
+
+      size_t GetID() const { return id; }
+
+      InstSpan<arg_t> GetArgs() const {
+        return InstSpan<arg_t>(num_args <= INLINE_ARGS ? inline_args.data() : pooled_args, num_args);
+      }
+      const InstSpan<tag_t> & GetTags() const { return tags; }
+
+      const arg_t & GetArg(size_t i) const {
+        emp_assert(i < num_args, i, num_args);
+        return (num_args <= INLINE_ARGS) ? inline_args[i] : pooled_args[i];
+      }
+      const tag_t & GetTag(size_t i) const { return tags[i]; }
+    };
+
+  protected:
+    emp::vector<Instruction> inst_seq;
+    emp::vector<tag_t> tag_pool;    ///< All instruction tags, in program order.
+    emp::vector<arg_t> arg_pool;    ///< Arguments of instructions with more than INLINE_ARGS arguments, in program order.
+
+    /// Point each instruction's pooled arguments and tags into the shared pools.
+    /// Pools are laid out in program order, so offsets can be recovered from the sizes.
+    void Link() {
+      size_t tag_pos = 0;
+      size_t arg_pos = 0;
+      for (Instruction & inst : inst_seq) {
+        const size_t num_tags = inst.tags.size();
+        if (inst.num_args > INLINE_ARGS) {
+          inst.pooled_args = arg_pool.data() + arg_pos;
+          arg_pos += inst.num_args;
+        } else {
+          inst.pooled_args = nullptr;
+        }
+        inst.tags = InstSpan<tag_t>(tag_pool.data() + tag_pos, num_tags);
+        tag_pos += num_tags;
+      }
+    }
+
+    /// Copy another packed program's instructions (record by record; Link fills in the pools).
+    void CopyFrom(const PackedLinearProgram & other) {
+      inst_seq.resize(other.inst_seq.size());
+      tag_pool = other.tag_pool;
+      arg_pool = other.arg_pool;
+      for (size_t i = 0; i < inst_seq.size(); ++i) {
+        Instruction & inst = inst_seq[i];
+        const Instruction & src = other.inst_seq[i];
+        inst.id = src.id;
+        inst.inline_args = src.inline_args;
+        inst.num_args = src.num_args;
+        inst.tags = InstSpan<tag_t>(nullptr, src.tags.size());
+      }
+      Link();
+    }
+
+  public:
+    PackedLinearProgram() : inst_seq(), tag_pool(), arg_pool() { ; }
+    PackedLinearProgram(const source_program_t & program) : PackedLinearProgram() { Load(program); }
+    PackedLinearProgram(const PackedLinearProgram & other) : PackedLinearProgram() { CopyFrom(other); }
+    PackedLinearProgram(PackedLinearProgram &&) = default;
+
+    PackedLinearProgram & operator=(const PackedLinearProgram & other) {
+      if (this != &other) CopyFrom(other);
+      return *this;
+    }
+    PackedLinearProgram & operator=(PackedLinearProgram &&) = default;
+
+    /// Rebuild this packed program from the given program.
+    void Load(const source_program_t & program) {
+      Clear();
+      size_t num_tags = 0;
+      size_t num_pooled_args = 0;
+      for (size_t i = 0; i < program.GetSize(); ++i) {
+        num_tags += program[i].GetTags().size();
+        if (program[i].GetArgs().size() > INLINE_ARGS) num_pooled_args += program[i].GetArgs().size();
+      }
+      inst_seq.resize(program.GetSize());
+      tag_pool.reserve(num_tags);
+      arg_pool.reserve(num_pooled_args);
+      for (size_t i = 0; i < program.GetSize(); ++i) {
+        const auto & src = program[i];
+        Instruction & inst = inst_seq[i];
+        inst.id = src.GetID();
+        inst.inline_args.fill(arg_t());
+        inst.num_args = src.GetArgs().size();
+        if (inst.num_args <= INLINE_ARGS) {
+          std::copy(src.GetArgs().begin(), src.GetArgs().end(), inst.inline_args.begin());
+        } else {
+          arg_pool.insert(arg_pool.end(), src.GetArgs().begin(), src.GetArgs().end());
+        }
+        tag_pool.insert(tag_pool.end(), src.GetTags().begin(), src.GetTags().end());
+        // Record sizes only; Link fills in where they live.
+        inst.tags = InstSpan<tag_t>(nullptr, src.GetTags().size());
+      }
+      Link();
+    }
+
+    /// Remove all instructions.
+    void Clear() {
+      inst_seq.clear();
+      tag_pool.clear();
+      arg_pool.clear();
+    }
+
+    /// Get program size.
+    size_t GetSize() const { return inst_seq.size(); }
+
+    /// Access the instruction at the given position.
+    const Instruction & operator[](size_t id) const {
+      emp_assert(id < inst_seq.size());
+      return inst_seq[id];
+    }
+  };
+
   //////////////////////////////////////////////////////////////////////////////
   // Random utilities
 
@@ -158,7 +376,7 @@ namespace sgp {
   typename LinearProgram<emp::BitSet<TAG_WIDTH>, int>::Instruction
     GenRandInst(emp::Random & rnd,
                 const InstructionLibrary<HARDWARE_T,
-                                         typename LinearProgram< emp::BitSet<TAG_WIDTH>, int>::Instruction,
+                                         typename HARDWARE_T::inst_t,
                                          typename HARDWARE_T::inst_prop_t> & inst_lib,
                 size_t num_tags=1,
                 size_t num_args=3,
@@ -174,7 +392,7 @@ namespace sgp {
   LinearProgram<emp::BitSet<TAG_WIDTH>, int> GenRandLinearProgram(
     emp::Random & rnd,
     const InstructionLibrary<HARDWARE_T,
-                             typename LinearProgram< emp::BitSet<TAG_WIDTH>, int>::Instruction,
+                             typename HARDWARE_T::inst_t,
                              typename HARDWARE_T::inst_prop_t> & inst_lib,
     const emp::Range<size_t> & inst_cnt_range={1, 32},
     // size_t min_inst_cnt=1, size_t max_inst_cnt=32,
@@ -194,6 +412,45 @@ namespace sgp {
     return new_program;
   }
 
+  /// Generate a population of random programs (each generated as by GenRandLinearProgram) in one
+  /// pass: program sizes are drawn first, then every instruction tag in the population is drawn
+  /// into a single buffer (see emp::FillRandomBitSets), which instructions are built from.
+  template<typename HARDWARE_T, size_t TAG_WIDTH>
+  emp::vector<LinearProgram<emp::BitSet<TAG_WIDTH>, int>> GenRandLinearPrograms(
+    emp::Random & rnd,
+    const InstructionLibrary<HARDWARE_T,
+                             typename HARDWARE_T::inst_t,
+                             typename HARDWARE_T::inst_prop_t> & inst_lib,
+    size_t num_programs,
+    const emp::Range<size_t> & inst_cnt_range={1, 32},
+    size_t num_inst_tags=1, size_t num_inst_args=3,
+    const emp::Range<int> & arg_val_range={0, 15}
+  ) {
+    emp_assert(inst_lib.GetSize() > 0, "Instruction library must have at least one instruction definition before being used to generate a random instruction.");
+    using program_t = LinearProgram<emp::BitSet<TAG_WIDTH>, int>;
+    emp::vector<size_t> inst_cnts(num_programs);
+    size_t total_inst_cnt = 0;
+    for (size_t & inst_cnt : inst_cnts) {
+      inst_cnt = rnd.GetUInt(inst_cnt_range.GetLower(), inst_cnt_range.GetUpper()+1);
+      total_inst_cnt += inst_cnt;
+    }
+    emp::vector<emp::BitSet<TAG_WIDTH>> tags;
+    emp::FillRandomBitSets(rnd, tags, total_inst_cnt * num_inst_tags);
+    emp::vector<program_t> programs(num_programs);
+    auto tag_it = tags.cbegin();
+    for (size_t p = 0; p < num_programs; ++p) {
+      programs[p].Reserve(inst_cnts[p]);
+      for (size_t i = 0; i < inst_cnts[p]; ++i) {
+        emp::vector<int> args(num_inst_args);
+        for (int & arg : args) arg = rnd.GetInt(arg_val_range.GetLower(), arg_val_range.GetUpper()+1);
+        const size_t inst_id = rnd.GetUInt(inst_lib.GetSize());
+        programs[p].PushInst({inst_id, std::move(args), emp::vector<emp::BitSet<TAG_WIDTH>>(tag_it, tag_it + num_inst_tags)});
+        tag_it += num_inst_tags;
+      }
+    }
+    return programs;
+  }
+
 }
 
 #endif
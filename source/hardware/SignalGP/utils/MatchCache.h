@@ -0,0 +1,88 @@
+#ifndef EMP_SIGNALGP_MATCH_CACHE_H
+#define EMP_SIGNALGP_MATCH_CACHE_H
+
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "base/vector.h"
+#include "tools/MatchBin.h"
+#include "tools/matchbin_utils.h"
+
+namespace sgp {
+
+  /// Does a matchbin of type MATCHBIN_T always return the same matches for the same query (as long
+  /// as its contents and regulators don't change)? I.e., is it safe to cache its match results?
+  /// Stochastic selectors (e.g., roulette selection) are not.
+  template<typename MATCHBIN_T>
+  struct IsDeterministicMatchBin : std::false_type { };
+
+  template<typename VAL_T, typename METRIC_T, typename REGULATOR_T, typename... SELECTOR_PARAMS>
+  struct IsDeterministicMatchBin<emp::MatchBin<VAL_T, METRIC_T, emp::RankedSelector<SELECTOR_PARAMS...>, REGULATOR_T>>
+    : std::true_type { };
+
+  /// Memoizes tag-based module lookups: maps (tag, n) => matched module ids.
+  /// The cache doesn't know what its results depend on; its owner must Clear it whenever results
+  /// might change (e.g., the set of modules changes or a module's regulator changes value).
+  /// To bound memory use, the cache empties itself once it holds max_size results.
+  template<typename TAG_T>
+  class MatchCache {
+  public:
+    using tag_t = TAG_T;
+    using matches_t = emp::vector<size_t>;
+
+  protected:
+    struct Key {
+      tag_t tag;
+      size_t n;
+      bool operator==(const Key & other) const { return n == other.n && tag == other.tag; }
+    };
+
+    struct KeyHash {
+      size_t operator()(const Key & key) const {
+        return std::hash<tag_t>()(key.tag) ^ (key.n * 0x9e3779b97f4a7c15ull);
+      }
+    };
+
+    std::unordered_map<Key, matches_t, KeyHash> cache;
+    size_t max_size;
+    size_t hits=0;    ///< Number of lookups answered from the cache.
+    size_t misses=0;  ///< Number of lookups that had to be computed.
+
+  public:
+    MatchCache(size_t _max_size=1024) : cache(), max_size(_max_size) { ; }
+
+    /// Get cached matches for (tag, n). On a miss, compute them with match_fun() and cache them.
+    template<typename MATCH_FUN_T>
+    const matches_t & Get(const tag_t & tag, size_t n, MATCH_FUN_T && match_fun) {
+      Key key{tag, n};
+      auto it = cache.find(key);
+      if (it != cache.end()) {
+        ++hits;
+        return it->second;
+      }
+      ++misses;
+      if (cache.size() >= max_size) cache.clear();
+      return cache.emplace(std::move(key), matches_t(match_fun())).first->second;
+    }
+
+    /// Forget all cached matches (does not reset hit/miss counts).
+    void Clear() { cache.clear(); }
+
+    /// How many (tag, n) results are cached?
+    size_t GetSize() const { return cache.size(); }
+
+    size_t GetMaxSize() const { return max_size; }
+    void SetMaxSize(size_t _max_size) { max_size = _max_size; }
+
+    size_t GetHits() const { return hits; }
+    size_t GetMisses() const { return misses; }
+
+    /// Reset hit/miss counts.
+    void ResetStats() { hits = 0; misses = 0; }
+  };
+
+}
+
+#endif
@@ -1,11 +1,17 @@
 #ifndef EMP_SIGNALGP_V2_MEMORY_MODEL_H
 #define EMP_SIGNALGP_V2_MEMORY_MODEL_H
 
+#include <array>
+#include <bitset>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include "base/Ptr.h"
 #include "base/vector.h"
+#include "tools/map_utils.h"
 #include "tools/Random.h"
 #include "tools/MatchBin.h"
 #include "tools/matchbin_utils.h"
@@ -33,6 +39,8 @@ namespace sgp {
         : working_mem(w), input_mem(i), output_mem(o) { ; }
       SimpleMemoryState(const SimpleMemoryState &) = default;
       SimpleMemoryState(SimpleMemoryState &&) = default;
+      SimpleMemoryState & operator=(const SimpleMemoryState &) = default;
+      SimpleMemoryState & operator=(SimpleMemoryState &&) = default;
 
       /// Set value at given key in working memory. No questions asked.
       void SetWorking(int key, double value) { working_mem[key] = value;  }
@@ -86,6 +94,14 @@ namespace sgp {
                                         const mem_buffer_t & output=mem_buffer_t())
     { return {working, input, output}; }
 
+    /// Make the given (recycled) memory state equivalent to CreateMemoryState() in place,
+    /// keeping each buffer's bucket array for reuse.
+    void ResetMemoryState(memory_state_t & state) const {
+      state.working_mem.clear();
+      state.input_mem.clear();
+      state.output_mem.clear();
+    }
+
     /// Reset memory model state.
     void Reset() {
       global_mem.clear();
@@ -148,6 +164,431 @@ namespace sgp {
 
   };
 
+
+  /// How RegisterMemoryModel interprets memory keys outside of [0, NUM_REGISTERS).
+  /// - MODULO: keys wrap around (e.g., -1 => NUM_REGISTERS-1, NUM_REGISTERS => 0).
+  /// - CLAMP: keys are clamped to the nearest register (e.g., -1 => 0, NUM_REGISTERS+3 => NUM_REGISTERS-1).
+  enum class RegisterIndexMode { MODULO, CLAMP };
+
+  /// Fixed-size register file used by RegisterMemoryModel.
+  /// - Values live in a flat array; any int key maps onto a register (see RegisterIndexMode).
+  /// - Mirrors the map-based buffers of SimpleMemoryModel: registers that have never been
+  ///   set/accessed read as 0 and are skipped when iterating, and iterating yields
+  ///   (register, value) pairs (read-only; write through Set/Access).
+  template<size_t NUM_REGISTERS, RegisterIndexMode INDEX_MODE=RegisterIndexMode::MODULO>
+  class RegisterBuffer {
+  public:
+    static_assert(NUM_REGISTERS > 0, "RegisterBuffer requires at least one register.");
+    using value_type = std::pair<int, double>;
+
+    class const_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<int, double>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type *;
+      using reference = const value_type &;
+
+    protected:
+      const RegisterBuffer * buffer;
+      size_t pos;
+      value_type cur;
+
+      void Seek() {
+        while (pos < NUM_REGISTERS && !buffer->used[pos]) ++pos;
+        if (pos < NUM_REGISTERS) cur = {(int)pos, buffer->regs[pos]};
+      }
+
+    public:
+
+      const_iterator(const RegisterBuffer * buf, size_t p) : buffer(buf), pos(p), cur() { Seek(); }
+
+      reference operator*() const { return cur; }
+      pointer operator->() const { return &cur; }
+      const_iterator & operator++() { ++pos; Seek(); return *this; }
+      const_iterator operator++(int) { const_iterator tmp(*this); ++(*this); return tmp; }
+      bool operator==(const const_iterator & other) const { return pos == other.pos; }
+      bool operator!=(const const_iterator & other) const { return pos != other.pos; }
+    };
+    using iterator = const_iterator;
+
+  protected:
+    std::array<double, NUM_REGISTERS> regs;   ///< Register values.
+    std::bitset<NUM_REGISTERS> used;          ///< Which registers have been set/accessed?
+
+  public:
+    RegisterBuffer() : regs(), used() { regs.fill(0.0); }
+    RegisterBuffer(std::initializer_list<value_type> init) : RegisterBuffer() {
+      for (const auto & mem : init) Set(mem.first, mem.second);
+    }
+    RegisterBuffer(const RegisterBuffer &) = default;
+    RegisterBuffer(RegisterBuffer &&) = default;
+    RegisterBuffer & operator=(const RegisterBuffer &) = default;
+    RegisterBuffer & operator=(RegisterBuffer &&) = default;
+
+    bool operator==(const RegisterBuffer & other) const {
+      if (used != other.used) return false;
+      for (size_t i = 0; i < NUM_REGISTERS; ++i) {
+        if (used[i] && regs[i] != other.regs[i]) return false;
+      }
+      return true;
+    }
+    bool operator!=(const RegisterBuffer & other) const { return !(*this == other); }
+
+    /// Map an arbitrary memory key onto a register index.
+    static constexpr size_t ToIndex(int key) {
+      if (INDEX_MODE == RegisterIndexMode::CLAMP) {
+        return (key < 0) ? 0 : (((size_t)key >= NUM_REGISTERS) ? NUM_REGISTERS - 1 : (size_t)key);
+      }
+      const int m = key % (int)NUM_REGISTERS;
+      return (size_t)(m < 0 ? m + (int)NUM_REGISTERS : m);
+    }
+
+    static constexpr size_t GetNumRegisters() { return NUM_REGISTERS; }
+
+    /// Number of registers that have been set/accessed.
+    size_t size() const { return used.count(); }
+    bool empty() const { return used.none(); }
+    void clear() { regs.fill(0.0); used.reset(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, NUM_REGISTERS); }
+
+    bool Has(int key) const { return used[ToIndex(key)]; }
+    double Get(int key) const { return regs[ToIndex(key)]; }
+    void Set(int key, double value) {
+      const size_t i = ToIndex(key);
+      regs[i] = value;
+      used.set(i);
+    }
+    double & Access(int key) {
+      const size_t i = ToIndex(key);
+      used.set(i);
+      return regs[i];
+    }
+
+    /// Copy every set/accessed register of other into this buffer.
+    void Merge(const RegisterBuffer & other) {
+      for (size_t i = 0; i < NUM_REGISTERS; ++i) {
+        if (other.used[i]) regs[i] = other.regs[i];
+      }
+      used |= other.used;
+    }
+  };
+
+  /// Memory model with the same semantics as SimpleMemoryModel, but backed by
+  /// fixed-size register files instead of hash maps. Memory keys (instruction
+  /// arguments) outside of [0, NUM_REGISTERS) are wrapped or clamped (INDEX_MODE).
+  template<size_t NUM_REGISTERS, RegisterIndexMode INDEX_MODE=RegisterIndexMode::MODULO>
+  class RegisterMemoryModel {
+  public:
+    struct RegisterMemoryState;
+    using memory_state_t = RegisterMemoryState;
+    using mem_buffer_t = RegisterBuffer<NUM_REGISTERS, INDEX_MODE>;
+
+    /// RegisterMemoryModel's memory state struct.
+    /// - Consists of: working, input, and output register files.
+    struct RegisterMemoryState {
+      mem_buffer_t working_mem;      // Working memory buffer!
+      mem_buffer_t input_mem;        // Input memory buffer!
+      mem_buffer_t output_mem;       // Output memory buffer!
+
+      RegisterMemoryState(const mem_buffer_t & w=mem_buffer_t(),
+                          const mem_buffer_t & i=mem_buffer_t(),
+                          const mem_buffer_t & o=mem_buffer_t())
+        : working_mem(w), input_mem(i), output_mem(o) { ; }
+      RegisterMemoryState(const RegisterMemoryState &) = default;
+      RegisterMemoryState(RegisterMemoryState &&) = default;
+      RegisterMemoryState & operator=(const RegisterMemoryState &) = default;
+      RegisterMemoryState & operator=(RegisterMemoryState &&) = default;
+
+      void SetWorking(int key, double value) { working_mem.Set(key, value); }
+      void SetInput(int key, double value) { input_mem.Set(key, value); }
+      void SetOutput(int key, double value) { output_mem.Set(key, value); }
+
+      double & AccessWorking(int key) { return working_mem.Access(key); }
+      double & AccessInput(int key) { return input_mem.Access(key); }
+      double & AccessOutput(int key) { return output_mem.Access(key); }
+
+      double GetWorking(int key) const { return working_mem.Get(key); }
+      double GetInput(int key) const { return input_mem.Get(key); }
+      double GetOutput(int key) const { return output_mem.Get(key); }
+
+      mem_buffer_t & GetWorkingMemory() { return working_mem; }
+      const mem_buffer_t & GetWorkingMemory() const { return working_mem; }
+      mem_buffer_t & GetInputMemory() { return input_mem; }
+      const mem_buffer_t & GetInputMemory() const { return input_mem; }
+      mem_buffer_t & GetOutputMemory() { return output_mem; }
+      const mem_buffer_t & GetOutputMemory() const { return output_mem; }
+    };
+
+  protected:
+    mem_buffer_t global_mem=mem_buffer_t(); /// 'Global memory' buffer.
+
+  public:
+
+    RegisterMemoryState CreateMemoryState(const mem_buffer_t & working=mem_buffer_t(),
+                                          const mem_buffer_t & input=mem_buffer_t(),
+                                          const mem_buffer_t & output=mem_buffer_t())
+    { return {working, input, output}; }
+
+    /// Make the given (recycled) memory state equivalent to CreateMemoryState() in place.
+    void ResetMemoryState(memory_state_t & state) const {
+      state.working_mem.clear();
+      state.input_mem.clear();
+      state.output_mem.clear();
+    }
+
+    /// Reset memory model state.
+    void Reset() {
+      global_mem.clear();
+    }
+
+    /// Print a single memory buffer.
+    void PrintMemoryBuffer(const mem_buffer_t & buffer, std::ostream & os=std::cout) const {
+      os << "[";
+      bool comma = false;
+      for (const auto & mem : buffer) {
+        if (comma) os << ", ";
+        os << "{" << mem.first << ":" << mem.second << "}";
+        comma = true;
+      }
+      os << "]";
+    }
+
+    /// Print the state of memory.
+    void PrintMemoryState(const memory_state_t & state, std::ostream & os=std::cout) const {
+      os << "Working memory (" << state.working_mem.size() << "): ";
+      PrintMemoryBuffer(state.working_mem, os);
+      os << "\n";
+      os << "Input memory (" << state.input_mem.size() << "): ";
+      PrintMemoryBuffer(state.input_mem, os);
+      os << "\n";
+      os << "Output memory (" << state.output_mem.size() << "): ";
+      PrintMemoryBuffer(state.output_mem, os);
+      os << "\n";
+    }
+
+    void PrintState(std::ostream & os=std::cout) const {
+      os << "Global memory (" << global_mem.size() << "): ";
+      PrintMemoryBuffer(global_mem, os);
+    }
+
+    mem_buffer_t & GetGlobalBuffer() { return global_mem; }
+    const mem_buffer_t & GetGlobalBuffer() const { return global_mem; }
+
+    void SetGlobal(int key, double val) { global_mem.Set(key, val); }
+
+    double GetGlobal(int key) const { return global_mem.Get(key); }
+
+    double & AccessGlobal(int key) { return global_mem.Access(key); }
+
+    void OnModuleCall(memory_state_t & caller_mem, memory_state_t & callee_mem) {
+      callee_mem.input_mem.Merge(caller_mem.working_mem);
+    }
+
+    // Handle Module return
+    void OnModuleReturn(memory_state_t & returning_mem, memory_state_t & caller_mem) {
+      caller_mem.working_mem.Merge(returning_mem.output_mem);
+    }
+
+  };
+
+  /// Copy-on-write memory buffer used by CowMemoryModel.
+  /// - Copies of a buffer share the same underlying map until one of them is written to, at which
+  ///   point the writer makes its own copy. An empty buffer doesn't allocate anything.
+  /// - Otherwise behaves like SimpleMemoryModel's map-based buffers: keys that have never been
+  ///   set/accessed read as 0 and are skipped when iterating, and iterating yields (key, value)
+  ///   pairs (read-only; write through Set/Access).
+  /// - References returned by Access are invalidated when the buffer is next shared and written to.
+  class CowBuffer {
+  public:
+    using map_t = std::unordered_map<int, double>;
+    using value_type = map_t::value_type;
+    using const_iterator = map_t::const_iterator;
+    using iterator = const_iterator;
+
+  protected:
+    std::shared_ptr<map_t> mem;   ///< Underlying map (possibly shared with other buffers); null if empty.
+
+    static const map_t & GetEmptyMap() {
+      static const map_t empty_map;
+      return empty_map;
+    }
+
+    const map_t & View() const { return mem ? *mem : GetEmptyMap(); }
+
+    /// Get a map that this buffer doesn't share with anyone (copying the shared map if necessary).
+    map_t & MakeUnique() {
+      if (!mem) mem = std::make_shared<map_t>();
+      else if (mem.use_count() > 1) mem = std::make_shared<map_t>(*mem);
+      return *mem;
+    }
+
+  public:
+    CowBuffer() : mem() { ; }
+    CowBuffer(std::initializer_list<std::pair<int, double>> init) : CowBuffer() {
+      for (const auto & entry : init) Set(entry.first, entry.second);
+    }
+    CowBuffer(const CowBuffer &) = default;
+    CowBuffer(CowBuffer &&) = default;
+    CowBuffer & operator=(const CowBuffer &) = default;
+    CowBuffer & operator=(CowBuffer &&) = default;
+
+    bool operator==(const CowBuffer & other) const { return mem == other.mem || View() == other.View(); }
+    bool operator!=(const CowBuffer & other) const { return !(*this == other); }
+
+    size_t size() const { return mem ? mem->size() : 0; }
+    bool empty() const { return !size(); }
+    void clear() { mem.reset(); }
+
+    const_iterator begin() const { return View().begin(); }
+    const_iterator end() const { return View().end(); }
+
+    /// Is this buffer's content currently shared with another buffer?
+    bool IsShared() const { return mem && mem.use_count() > 1; }
+
+    bool Has(int key) const { return mem && emp::Has(*mem, key); }
+    double Get(int key) const { return mem ? emp::Find(*mem, key, 0.0) : 0.0; }
+    void Set(int key, double value) { MakeUnique()[key] = value; }
+    double & Access(int key) { return MakeUnique()[key]; }  // (operator[] value-initializes new keys to 0)
+
+    /// Copy every entry of other into this buffer. If this buffer is empty, it just shares other's map.
+    void Merge(const CowBuffer & other) {
+      if (other.empty() || mem == other.mem) return;
+      if (empty()) {
+        mem = other.mem;
+        return;
+      }
+      map_t & dest = MakeUnique();
+      for (const auto & entry : *other.mem) dest[entry.first] = entry.second;
+    }
+  };
+
+  /// Memory model with the same semantics as SimpleMemoryModel, but whose buffers are
+  /// copy-on-write (CowBuffer). New call states don't allocate, a callee's input buffer shares
+  /// its caller's working buffer rather than copying it, and returning only copies the entries
+  /// of the callee's output buffer. I.e., calls and returns cost O(memory touched) rather than
+  /// O(buffer size).
+  class CowMemoryModel {
+  public:
+    struct CowMemoryState;
+    using memory_state_t = CowMemoryState;
+    using mem_buffer_t = CowBuffer;
+
+    /// CowMemoryModel's memory state struct.
+    /// - Consists of: working, input, and output memory buffers.
+    struct CowMemoryState {
+      mem_buffer_t working_mem;      // Working memory buffer!
+      mem_buffer_t input_mem;        // Input memory buffer!
+      mem_buffer_t output_mem;       // Output memory buffer!
+
+      CowMemoryState(const mem_buffer_t & w=mem_buffer_t(),
+                     const mem_buffer_t & i=mem_buffer_t(),
+                     const mem_buffer_t & o=mem_buffer_t())
+        : working_mem(w), input_mem(i), output_mem(o) { ; }
+      CowMemoryState(const CowMemoryState &) = default;
+      CowMemoryState(CowMemoryState &&) = default;
+      CowMemoryState & operator=(const CowMemoryState &) = default;
+      CowMemoryState & operator=(CowMemoryState &&) = default;
+
+      void SetWorking(int key, double value) { working_mem.Set(key, value); }
+      void SetInput(int key, double value) { input_mem.Set(key, value); }
+      void SetOutput(int key, double value) { output_mem.Set(key, value); }
+
+      double & AccessWorking(int key) { return working_mem.Access(key); }
+      double & AccessInput(int key) { return input_mem.Access(key); }
+      double & AccessOutput(int key) { return output_mem.Access(key); }
+
+      double GetWorking(int key) const { return working_mem.Get(key); }
+      double GetInput(int key) const { return input_mem.Get(key); }
+      double GetOutput(int key) const { return output_mem.Get(key); }
+
+      mem_buffer_t & GetWorkingMemory() { return working_mem; }
+      const mem_buffer_t & GetWorkingMemory() const { return working_mem; }
+      mem_buffer_t & GetInputMemory() { return input_mem; }
+      const mem_buffer_t & GetInputMemory() const { return input_mem; }
+      mem_buffer_t & GetOutputMemory() { return output_mem; }
+      const mem_buffer_t & GetOutputMemory() const { return output_mem; }
+    };
+
+  protected:
+    mem_buffer_t global_mem=mem_buffer_t(); /// 'Global memory' buffer.
+
+  public:
+
+    CowMemoryState CreateMemoryState(const mem_buffer_t & working=mem_buffer_t(),
+                                     const mem_buffer_t & input=mem_buffer_t(),
+                                     const mem_buffer_t & output=mem_buffer_t())
+    { return {working, input, output}; }
+
+    /// Make the given (recycled) memory state equivalent to CreateMemoryState() in place.
+    /// (Empty buffers hold no storage; this lets go of any maps shared with other states.)
+    void ResetMemoryState(memory_state_t & state) const {
+      state.working_mem.clear();
+      state.input_mem.clear();
+      state.output_mem.clear();
+    }
+
+    /// Reset memory model state.
+    void Reset() {
+      global_mem.clear();
+    }
+
+    /// Print a single memory buffer.
+    void PrintMemoryBuffer(const mem_buffer_t & buffer, std::ostream & os=std::cout) const {
+      os << "[";
+      bool comma = false;
+      for (const auto & mem : buffer) {
+        if (comma) os << ", ";
+        os << "{" << mem.first << ":" << mem.second << "}";
+        comma = true;
+      }
+      os << "]";
+    }
+
+    /// Print the state of memory.
+    void PrintMemoryState(const memory_state_t & state, std::ostream & os=std::cout) const {
+      os << "Working memory (" << state.working_mem.size() << "): ";
+      PrintMemoryBuffer(state.working_mem, os);
+      os << "\n";
+      os << "Input memory (" << state.input_mem.size() << "): ";
+      PrintMemoryBuffer(state.input_mem, os);
+      os << "\n";
+      os << "Output memory (" << state.output_mem.size() << "): ";
+      PrintMemoryBuffer(state.output_mem, os);
+      os << "\n";
+    }
+
+    void PrintState(std::ostream & os=std::cout) const {
+      os << "Global memory (" << global_mem.size() << "): ";
+      PrintMemoryBuffer(global_mem, os);
+    }
+
+    mem_buffer_t & GetGlobalBuffer() { return global_mem; }
+    const mem_buffer_t & GetGlobalBuffer() const { return global_mem; }
+
+    void SetGlobal(int key, double val) { global_mem.Set(key, val); }
+
+    double GetGlobal(int key) const { return global_mem.Get(key); }
+
+    double & AccessGlobal(int key) { return global_mem.Access(key); }
+
+    /// Callee's input memory shares the caller's working memory (until either is written to).
+    void OnModuleCall(memory_state_t & caller_mem, memory_state_t & callee_mem) {
+      callee_mem.input_mem.Merge(caller_mem.working_mem);
+    }
+
+    // Handle Module return
+    void OnModuleReturn(memory_state_t & returning_mem, memory_state_t & caller_mem) {
+      // The returning state is about to be discarded; let go of its input memory first, which
+      // is likely still shared with the caller's working memory (and would force a copy).
+      returning_mem.input_mem.clear();
+      caller_mem.working_mem.Merge(returning_mem.output_mem);
+    }
+
+  };
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,764 @@
+#ifndef EMP_SIGNALGP_PROGRAM_SERIALIZATION_H
+#define EMP_SIGNALGP_PROGRAM_SERIALIZATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SGP_SERIALIZATION_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "base/assert.h"
+#include "base/vector.h"
+#include "tools/BitSet.h"
+
+#include "LinearProgram.h"
+#include "LinearFunctionsProgram.h"
+
+// Binary (de)serialization for LinearProgram and LinearFunctionsProgram populations.
+//
+// File layout (all integers are unsigned LEB128 varints unless noted otherwise):
+//   header:  "SGPB" | version | program kind (1 byte) | tag width (in bits)
+//            | number of instruction names | (name length | name bytes)*
+//   records: (record length in bytes | record)*, until end of file.
+// Program records:
+//   LinearProgram:          instruction sequence
+//   LinearFunctionsProgram: number of functions | (number of tags | tags | instruction sequence)*
+//   instruction sequence:   number of instructions
+//                           | (instruction id | number of args | args (zigzag varints)
+//                              | number of tags | tags)*
+// Tags are packed into ceil(width / 8) bytes (little-endian bit order). Instruction ids index
+// into the header's name table, so files can be read with any instruction library that defines
+// every name in the table (ids are remapped on load).
+
+namespace sgp {
+namespace serialization {
+
+  constexpr uint32_t FORMAT_VERSION = 1;
+  constexpr uint8_t MAGIC[4] = {'S', 'G', 'P', 'B'};
+
+  enum class ProgramKind : uint8_t { LINEAR_PROGRAM=1, LINEAR_FUNCTIONS_PROGRAM=2 };
+
+  /// How to pack a tag into bytes. Specialize for other tag types.
+  /// Must provide NUM_BITS, NUM_BYTES, Write(tag, out), and Read(in).
+  template<typename TAG_T>
+  struct TagCodec;
+
+  template<size_t W>
+  struct TagCodec<emp::BitSet<W>> {
+    static constexpr size_t NUM_BITS = W;
+    static constexpr size_t NUM_BYTES = (W + 7) / 8;
+
+    static void Write(const emp::BitSet<W> & tag, uint8_t * out) {
+      for (size_t i = 0; i < NUM_BYTES; i += 4) {
+        const uint32_t bits = tag.GetUInt(i / 4);
+        for (size_t j = i; j < std::min(i + 4, NUM_BYTES); ++j) out[j] = (uint8_t)(bits >> (8 * (j - i)));
+      }
+    }
+
+    static emp::BitSet<W> Read(const uint8_t * in) {
+      emp::BitSet<W> tag;
+      for (size_t i = 0; i < NUM_BYTES; i += 4) {
+        uint32_t bits = 0;
+        for (size_t j = i; j < std::min(i + 4, NUM_BYTES); ++j) {
+          uint8_t byte = in[j];
+          if (j == NUM_BYTES - 1 && W % 8) byte &= (uint8_t)((1u << (W % 8)) - 1); // Ignore padding.
+          bits |= (uint32_t)byte << (8 * (j - i));
+        }
+        tag.SetUInt(i / 4, bits);
+      }
+      return tag;
+    }
+  };
+
+  inline uint64_t ZigZagEncode(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+  inline int64_t ZigZagDecode(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+  /// Appends encoded values to a byte buffer.
+  class ByteWriter {
+  protected:
+    emp::vector<uint8_t> buffer;
+
+  public:
+    void Clear() { buffer.clear(); }
+    size_t GetSize() const { return buffer.size(); }
+    const uint8_t * GetData() const { return buffer.data(); }
+
+    void PutByte(uint8_t byte) { buffer.emplace_back(byte); }
+
+    void PutVarint(uint64_t value) {
+      while (value >= 0x80) {
+        buffer.emplace_back((uint8_t)(value | 0x80));
+        value >>= 7;
+      }
+      buffer.emplace_back((uint8_t)value);
+    }
+
+    void PutSignedVarint(int64_t value) { PutVarint(ZigZagEncode(value)); }
+
+    void PutString(const std::string & str) {
+      PutVarint(str.size());
+      buffer.insert(buffer.end(), str.begin(), str.end());
+    }
+
+    template<typename TAG_T>
+    void PutTag(const TAG_T & tag) {
+      const size_t pos = buffer.size();
+      buffer.resize(pos + TagCodec<TAG_T>::NUM_BYTES);
+      TagCodec<TAG_T>::Write(tag, buffer.data() + pos);
+    }
+
+    /// Write buffer to out, prefixed by its length.
+    void WriteRecord(std::ostream & out) const {
+      ByteWriter length;
+      length.PutVarint(buffer.size());
+      out.write((const char *)length.GetData(), (std::streamsize)length.GetSize());
+      out.write((const char *)buffer.data(), (std::streamsize)buffer.size());
+    }
+  };
+
+  /// Decodes values from a range of bytes. Any read past the end (or malformed varint) puts the
+  /// reader into a failed state (check IsOK); failed reads return zero/nullptr.
+  class ByteReader {
+  protected:
+    const uint8_t * pos;
+    const uint8_t * end;
+    bool ok=true;
+
+  public:
+    ByteReader(const uint8_t * _begin, const uint8_t * _end) : pos(_begin), end(_end) { ; }
+
+    bool IsOK() const { return ok; }
+    bool AtEnd() const { return ok && pos == end; }
+    size_t GetRemaining() const { return (size_t)(end - pos); }
+    const uint8_t * GetPos() const { return pos; }
+    bool Fail() { ok = false; return false; }
+
+    bool GetByte(uint8_t & byte) {
+      if (!ok || pos == end) return Fail();
+      byte = *pos++;
+      return true;
+    }
+
+    uint64_t GetVarint() {
+      uint64_t value = 0;
+      uint8_t byte = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        if (!GetByte(byte)) return 0;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+      }
+      Fail();
+      return 0;
+    }
+
+    int64_t GetSignedVarint() { return ZigZagDecode(GetVarint()); }
+
+    /// Get pointer to the next count bytes (and skip over them).
+    const uint8_t * GetBytes(size_t count) {
+      if (!ok || count > GetRemaining()) { Fail(); return nullptr; }
+      const uint8_t * bytes = pos;
+      pos += count;
+      return bytes;
+    }
+
+    bool GetString(size_t length, std::string & str) {
+      const uint8_t * bytes = GetBytes(length);
+      if (!ok) return false;
+      str.assign((const char *)bytes, length);
+      return true;
+    }
+
+    /// Read an element count; fails if count elements (each at least min_bytes long) can't fit
+    /// in what's left (so corrupt counts never trigger huge allocations).
+    size_t GetCount(size_t min_bytes) {
+      const uint64_t count = GetVarint();
+      if (min_bytes && count > GetRemaining() / min_bytes) { Fail(); return 0; }
+      return (size_t)count;
+    }
+  };
+
+  /// Decodes values from an input stream (same interface as ByteReader, where it makes sense).
+  class StreamReader {
+  protected:
+    std::istream & in;
+    bool ok=true;
+
+  public:
+    StreamReader(std::istream & _in) : in(_in) { ; }
+
+    bool IsOK() const { return ok; }
+    bool Fail() { ok = false; return false; }
+
+    bool GetByte(uint8_t & byte) {
+      const auto c = in.get();
+      if (!ok || c == std::istream::traits_type::eof()) return Fail();
+      byte = (uint8_t)c;
+      return true;
+    }
+
+    uint64_t GetVarint() {
+      uint64_t value = 0;
+      uint8_t byte = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        if (!GetByte(byte)) return 0;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+      }
+      Fail();
+      return 0;
+    }
+
+    /// Read count bytes into out (grown in chunks, so a corrupt count fails at end of stream
+    /// rather than allocating everything up front).
+    bool GetBytes(size_t count, emp::vector<uint8_t> & out) {
+      constexpr size_t CHUNK_SIZE = 1 << 16;
+      out.clear();
+      while (ok && out.size() < count) {
+        const size_t pos = out.size();
+        const size_t chunk = std::min(CHUNK_SIZE, count - pos);
+        out.resize(pos + chunk);
+        in.read((char *)out.data() + pos, (std::streamsize)chunk);
+        if ((size_t)in.gcount() != chunk) Fail();
+      }
+      return ok;
+    }
+
+    bool GetString(size_t length, std::string & str) {
+      emp::vector<uint8_t> bytes;
+      if (!GetBytes(length, bytes)) return false;
+      str.assign(bytes.begin(), bytes.end());
+      return true;
+    }
+
+    /// Is the stream exhausted (without consuming anything)?
+    bool AtEnd() { return in.peek() == std::istream::traits_type::eof(); }
+  };
+
+  /// Everything stored at the start of a program file.
+  struct FileHeader {
+    uint32_t version=FORMAT_VERSION;
+    ProgramKind kind=ProgramKind::LINEAR_PROGRAM;
+    size_t tag_bits=0;
+    emp::vector<std::string> inst_names;   ///< Indexed by instruction ids used in the file.
+  };
+
+  /// Read-only view of tags packed into a program record.
+  template<typename TAG_T>
+  class PackedTags {
+  protected:
+    const uint8_t * bytes;
+    size_t count;
+
+  public:
+    using codec_t = TagCodec<TAG_T>;
+
+    PackedTags(const uint8_t * _bytes=nullptr, size_t _count=0) : bytes(_bytes), count(_count) { ; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /// Unpack the i'th tag.
+    TAG_T operator[](size_t i) const {
+      emp_assert(i < count, i, count);
+      return codec_t::Read(bytes + i * codec_t::NUM_BYTES);
+    }
+
+    /// Raw (packed) bytes of the i'th tag.
+    const uint8_t * GetBytes(size_t i) const { return bytes + i * codec_t::NUM_BYTES; }
+
+    emp::vector<TAG_T> ToVector() const {
+      emp::vector<TAG_T> tags;
+      tags.reserve(count);
+      for (size_t i = 0; i < count; ++i) tags.emplace_back((*this)[i]);
+      return tags;
+    }
+  };
+
+  /// An instruction as found in a program record (id already remapped to the reader's
+  /// instruction library). Arguments are decoded; tags are unpacked on request.
+  template<typename TAG_T, typename ARG_T>
+  struct InstView {
+    size_t id;
+    size_t function;              ///< Function this instruction belongs to (0 for LinearProgram).
+    InstSpan<ARG_T> args;
+    PackedTags<TAG_T> tags;
+
+    size_t GetID() const { return id; }
+    size_t GetFunction() const { return function; }
+    const InstSpan<ARG_T> & GetArgs() const { return args; }
+    const ARG_T & GetArg(size_t i) const { return args[i]; }
+    const PackedTags<TAG_T> & GetTags() const { return tags; }
+    TAG_T GetTag(size_t i) const { return tags[i]; }
+  };
+
+  /// A LinearFunctionsProgram function (header) as found in a program record.
+  template<typename TAG_T>
+  struct FunctionView {
+    size_t function;
+    PackedTags<TAG_T> tags;
+
+    size_t GetFunction() const { return function; }
+    const PackedTags<TAG_T> & GetTags() const { return tags; }
+    TAG_T GetTag(size_t i=0) const { return tags[i]; }
+  };
+
+  namespace internal {
+
+    template<typename TAG_T, typename ARG_T>
+    void EncodeInstSequence(ByteWriter & out, const LinearProgram<TAG_T, ARG_T> & seq) {
+      out.PutVarint(seq.GetSize());
+      for (size_t i = 0; i < seq.GetSize(); ++i) {
+        const auto & inst = seq[i];
+        out.PutVarint(inst.GetID());
+        out.PutVarint(inst.GetArgs().size());
+        for (const ARG_T & arg : inst.GetArgs()) out.PutSignedVarint((int64_t)arg);
+        out.PutVarint(inst.GetTags().size());
+        for (const TAG_T & tag : inst.GetTags()) out.PutTag(tag);
+      }
+    }
+
+    /// Decode an instruction sequence, calling inst_fun on each instruction.
+    /// args is scratch space (reused across instructions).
+    template<typename TAG_T, typename ARG_T, typename INST_FUN>
+    bool VisitInstSequence(ByteReader & in, const emp::vector<size_t> & remap, size_t function,
+                           emp::vector<ARG_T> & args, INST_FUN && inst_fun) {
+      constexpr size_t TAG_BYTES = TagCodec<TAG_T>::NUM_BYTES;
+      const size_t num_insts = in.GetCount(3); // id, arg count, tag count
+      for (size_t i = 0; i < num_insts && in.IsOK(); ++i) {
+        const uint64_t file_id = in.GetVarint();
+        if (file_id >= remap.size()) return in.Fail();
+        const size_t num_args = in.GetCount(1);
+        args.resize(num_args);
+        for (size_t a = 0; a < num_args; ++a) {
+          const int64_t value = in.GetSignedVarint();
+          if (value < (int64_t)std::numeric_limits<ARG_T>::min()
+              || (value > 0 && (uint64_t)value > (uint64_t)std::numeric_limits<ARG_T>::max())) {
+            return in.Fail();
+          }
+          args[a] = (ARG_T)value;
+        }
+        const size_t num_tags = in.GetCount(TAG_BYTES);
+        const uint8_t * tag_bytes = in.GetBytes(num_tags * TAG_BYTES);
+        if (!in.IsOK()) return false;
+        inst_fun(InstView<TAG_T, ARG_T>{remap[file_id], function,
+                                        InstSpan<ARG_T>(args.data(), num_args),
+                                        PackedTags<TAG_T>(tag_bytes, num_tags)});
+      }
+      return in.IsOK();
+    }
+
+  }
+
+  /// How each program type is laid out in a record.
+  template<typename PROGRAM_T>
+  struct ProgramFormat;
+
+  template<typename TAG_T, typename ARG_T>
+  struct ProgramFormat<LinearProgram<TAG_T, ARG_T>> {
+    using program_t = LinearProgram<TAG_T, ARG_T>;
+    using tag_t = TAG_T;
+    using arg_t = ARG_T;
+    using inst_view_t = InstView<tag_t, arg_t>;
+    using function_view_t = FunctionView<tag_t>;
+    static constexpr ProgramKind KIND = ProgramKind::LINEAR_PROGRAM;
+
+    static void Encode(ByteWriter & out, const program_t & program) {
+      internal::EncodeInstSequence(out, program);
+    }
+
+    /// Walk a record (func_fun is never called; LinearPrograms have no functions).
+    template<typename FUNC_FUN, typename INST_FUN>
+    static bool Visit(ByteReader & in, const emp::vector<size_t> & remap, FUNC_FUN &&, INST_FUN && inst_fun) {
+      emp::vector<arg_t> args;
+      return internal::VisitInstSequence<tag_t, arg_t>(in, remap, 0, args, inst_fun) && in.AtEnd();
+    }
+
+    static bool Decode(ByteReader & in, const emp::vector<size_t> & remap, program_t & program) {
+      program.Clear();
+      return Visit(in, remap, [](const function_view_t &) { ; },
+                   [&program](const inst_view_t & inst) {
+                     program.PushInst(inst.GetID(),
+                                      emp::vector<arg_t>(inst.GetArgs().begin(), inst.GetArgs().end()),
+                                      inst.GetTags().ToVector());
+                   });
+    }
+  };
+
+  template<typename TAG_T, typename ARG_T>
+  struct ProgramFormat<LinearFunctionsProgram<TAG_T, ARG_T>> {
+    using program_t = LinearFunctionsProgram<TAG_T, ARG_T>;
+    using tag_t = TAG_T;
+    using arg_t = ARG_T;
+    using inst_view_t = InstView<tag_t, arg_t>;
+    using function_view_t = FunctionView<tag_t>;
+    static constexpr ProgramKind KIND = ProgramKind::LINEAR_FUNCTIONS_PROGRAM;
+
+    static void Encode(ByteWriter & out, const program_t & program) {
+      out.PutVarint(program.GetSize());
+      for (size_t f = 0; f < program.GetSize(); ++f) {
+        out.PutVarint(program[f].GetTags().size());
+        for (const tag_t & tag : program[f].GetTags()) out.PutTag(tag);
+        internal::EncodeInstSequence(out, program[f].GetInstSequence());
+      }
+    }
+
+    /// Walk a record: func_fun is called on each function before inst_fun is called on its
+    /// instructions.
+    template<typename FUNC_FUN, typename INST_FUN>
+    static bool Visit(ByteReader & in, const emp::vector<size_t> & remap, FUNC_FUN && func_fun, INST_FUN && inst_fun) {
+      constexpr size_t TAG_BYTES = TagCodec<tag_t>::NUM_BYTES;
+      emp::vector<arg_t> args;
+      const size_t num_functions = in.GetCount(2); // tag count, instruction count
+      for (size_t f = 0; f < num_functions && in.IsOK(); ++f) {
+        const size_t num_tags = in.GetCount(TAG_BYTES);
+        const uint8_t * tag_bytes = in.GetBytes(num_tags * TAG_BYTES);
+        if (!num_tags) return in.Fail(); // Functions must have at least one tag.
+        if (!in.IsOK()) return false;
+        func_fun(function_view_t{f, PackedTags<tag_t>(tag_bytes, num_tags)});
+        if (!internal::VisitInstSequence<tag_t, arg_t>(in, remap, f, args, inst_fun)) return false;
+      }
+      return in.AtEnd();
+    }
+
+    static bool Decode(ByteReader & in, const emp::vector<size_t> & remap, program_t & program) {
+      program.Clear();
+      return Visit(in, remap,
+                   [&program](const function_view_t & function) {
+                     program.PushFunction(function.GetTags().ToVector());
+                   },
+                   [&program](const inst_view_t & inst) {
+                     program.PushInst(inst.GetFunction(), inst.GetID(),
+                                      emp::vector<arg_t>(inst.GetArgs().begin(), inst.GetArgs().end()),
+                                      inst.GetTags().ToVector());
+                   });
+    }
+  };
+
+  namespace internal {
+
+    template<typename PROGRAM_T, typename ILIB_T>
+    void WriteHeader(std::ostream & out, const ILIB_T & ilib) {
+      ByteWriter header;
+      for (uint8_t byte : MAGIC) header.PutByte(byte);
+      header.PutVarint(FORMAT_VERSION);
+      header.PutByte((uint8_t)ProgramFormat<PROGRAM_T>::KIND);
+      header.PutVarint(TagCodec<typename PROGRAM_T::tag_t>::NUM_BITS);
+      header.PutVarint(ilib.GetSize());
+      for (size_t i = 0; i < ilib.GetSize(); ++i) header.PutString(ilib.GetName(i));
+      out.write((const char *)header.GetData(), (std::streamsize)header.GetSize());
+    }
+
+    /// Read header from in (a ByteReader or StreamReader). Returns an error message
+    /// (empty on success).
+    template<typename READER_T>
+    std::string ReadHeader(READER_T & in, FileHeader & header) {
+      uint8_t byte = 0;
+      for (uint8_t expected : MAGIC) {
+        if (!in.GetByte(byte) || byte != expected) return "Not a SignalGP program file.";
+      }
+      const uint64_t version = in.GetVarint();
+      if (!in.IsOK()) return "Truncated header.";
+      if (version == 0 || version > FORMAT_VERSION) return "Unsupported format version: " + std::to_string(version);
+      header.version = (uint32_t)version;
+      if (!in.GetByte(byte)) return "Truncated header.";
+      header.kind = (ProgramKind)byte;
+      header.tag_bits = (size_t)in.GetVarint();
+      const size_t num_names = (size_t)in.GetVarint();
+      header.inst_names.clear();
+      for (size_t i = 0; i < num_names && in.IsOK(); ++i) {
+        std::string name;
+        in.GetString((size_t)in.GetVarint(), name);
+        header.inst_names.emplace_back(std::move(name));
+      }
+      if (!in.IsOK()) return "Truncated header.";
+      return "";
+    }
+
+    /// Check that a header describes PROGRAM_T programs, and build the map from file
+    /// instruction ids to ilib's ids. Returns an error message (empty on success).
+    template<typename PROGRAM_T, typename ILIB_T>
+    std::string CheckHeader(const FileHeader & header, const ILIB_T & ilib, emp::vector<size_t> & remap) {
+      if (header.kind != ProgramFormat<PROGRAM_T>::KIND) return "Program kind mismatch.";
+      if (header.tag_bits != TagCodec<typename PROGRAM_T::tag_t>::NUM_BITS) {
+        return "Tag width mismatch: file has " + std::to_string(header.tag_bits) + "-bit tags.";
+      }
+      remap.clear();
+      for (const std::string & name : header.inst_names) {
+        if (!ilib.IsInst(name)) return "Unknown instruction: " + name;
+        remap.emplace_back(ilib.GetID(name));
+      }
+      return "";
+    }
+
+  }
+
+  /// Streams programs to a binary program file.
+  ///
+  /// Usage:
+  ///   std::ofstream out("population.sgpb", std::ios::binary);
+  ///   ProgramWriter<program_t> writer(out, inst_lib);
+  ///   for (const program_t & program : population) writer.Write(program);
+  template<typename PROGRAM_T>
+  class ProgramWriter {
+  public:
+    using program_t = PROGRAM_T;
+    using format_t = ProgramFormat<program_t>;
+    static_assert(std::is_integral<typename program_t::arg_t>::value, "Only integral instruction arguments can be serialized.");
+
+  protected:
+    std::ostream & out;
+    ByteWriter buffer;
+    size_t num_insts;       ///< Size of the instruction library programs are written against.
+    size_t num_written=0;
+
+    template<typename SEQUENCE_T>
+    bool IsValidSequence(const SEQUENCE_T & seq) const {
+      for (size_t i = 0; i < seq.GetSize(); ++i) if (seq[i].GetID() >= num_insts) return false;
+      return true;
+    }
+
+    /// Are all of program's instruction ids in the header's instruction name table?
+    bool IsValidProgram(const program_t & program) const {
+      if constexpr (format_t::KIND == ProgramKind::LINEAR_PROGRAM) {
+        return IsValidSequence(program);
+      } else {
+        for (size_t f = 0; f < program.GetSize(); ++f) {
+          if (!IsValidSequence(program[f].GetInstSequence())) return false;
+        }
+        return true;
+      }
+    }
+
+  public:
+    /// Write file header (with ilib's instruction names) to out.
+    template<typename ILIB_T>
+    ProgramWriter(std::ostream & _out, const ILIB_T & ilib) : out(_out), buffer(), num_insts(ilib.GetSize()) {
+      internal::WriteHeader<program_t>(out, ilib);
+    }
+
+    /// Append program to the file. Returns false (and writes nothing) if program uses an
+    /// instruction id that isn't in the instruction library the writer was made with.
+    bool Write(const program_t & program) {
+      if (!IsValidProgram(program)) return false;
+      buffer.Clear();
+      format_t::Encode(buffer, program);
+      buffer.WriteRecord(out);
+      ++num_written;
+      return true;
+    }
+
+    size_t GetNumWritten() const { return num_written; }
+    bool IsGood() const { return (bool)out; }
+  };
+
+  /// Streams programs from a binary program file.
+  ///
+  /// Usage:
+  ///   std::ifstream in("population.sgpb", std::ios::binary);
+  ///   ProgramReader<program_t> reader(in, inst_lib);
+  ///   program_t program;
+  ///   while (reader.Read(program)) { ... }
+  ///   if (!reader.IsGood()) std::cerr << reader.GetError() << std::endl;
+  template<typename PROGRAM_T>
+  class ProgramReader {
+  public:
+    using program_t = PROGRAM_T;
+    using format_t = ProgramFormat<program_t>;
+
+  protected:
+    StreamReader in;
+    FileHeader header;
+    emp::vector<size_t> remap;       ///< File instruction id => library instruction id.
+    emp::vector<uint8_t> buffer;
+    std::string error;
+    size_t num_read=0;
+
+  public:
+    /// Read (and validate) the file header from in.
+    template<typename ILIB_T>
+    ProgramReader(std::istream & _in, const ILIB_T & ilib) : in(_in), header(), remap(), buffer(), error() {
+      error = internal::ReadHeader(in, header);
+      if (error.empty()) error = internal::CheckHeader<program_t>(header, ilib, remap);
+    }
+
+    /// Read the next program. Returns false at end of file or on error (see IsGood/GetError).
+    bool Read(program_t & program) {
+      if (!IsGood() || in.AtEnd()) return false;
+      const uint64_t length = in.GetVarint();
+      if (!in.GetBytes((size_t)length, buffer)) {
+        error = "Truncated program record " + std::to_string(num_read) + ".";
+        return false;
+      }
+      ByteReader record(buffer.data(), buffer.data() + buffer.size());
+      if (!format_t::Decode(record, remap, program)) {
+        error = "Malformed program record " + std::to_string(num_read) + ".";
+        return false;
+      }
+      ++num_read;
+      return true;
+    }
+
+    bool IsGood() const { return error.empty(); }
+    const std::string & GetError() const { return error; }
+    const FileHeader & GetHeader() const { return header; }
+    size_t GetNumRead() const { return num_read; }
+  };
+
+  /// A single program's record in a MappedProgramFile (valid as long as the file is open).
+  template<typename PROGRAM_T>
+  class ProgramRecord {
+  public:
+    using program_t = PROGRAM_T;
+    using format_t = ProgramFormat<program_t>;
+    using inst_view_t = typename format_t::inst_view_t;
+    using function_view_t = typename format_t::function_view_t;
+
+  protected:
+    const uint8_t * bytes;
+    size_t size;
+    const emp::vector<size_t> * remap;
+
+  public:
+    ProgramRecord(const uint8_t * _bytes, size_t _size, const emp::vector<size_t> & _remap)
+      : bytes(_bytes), size(_size), remap(&_remap) { ; }
+
+    /// Size of this program's record, in bytes.
+    size_t GetByteSize() const { return size; }
+
+    /// Call func_fun on each function (LinearFunctionsProgram only) and inst_fun on each
+    /// instruction, in program order, without building the program.
+    /// Returns false if the record is malformed.
+    template<typename FUNC_FUN, typename INST_FUN>
+    bool Visit(FUNC_FUN && func_fun, INST_FUN && inst_fun) const {
+      ByteReader in(bytes, bytes + size);
+      return format_t::Visit(in, *remap, func_fun, inst_fun);
+    }
+
+    /// Call inst_fun on each instruction (see Visit).
+    template<typename INST_FUN>
+    bool ForEachInst(INST_FUN && inst_fun) const {
+      return Visit([](const function_view_t &) { ; }, inst_fun);
+    }
+
+    /// Fully deserialize this record into program. Returns false if the record is malformed.
+    bool Decode(program_t & program) const {
+      ByteReader in(bytes, bytes + size);
+      return format_t::Decode(in, *remap, program);
+    }
+  };
+
+  /// Read-only, memory-mapped program file. Opening a file only scans record lengths;
+  /// programs are decoded on demand (or just visited, see ProgramRecord).
+  /// Falls back to reading the whole file into memory where mmap isn't available.
+  template<typename PROGRAM_T>
+  class MappedProgramFile {
+  public:
+    using program_t = PROGRAM_T;
+    using record_t = ProgramRecord<program_t>;
+
+  protected:
+    const uint8_t * data=nullptr;
+    size_t size=0;
+    #ifdef SGP_SERIALIZATION_MMAP
+    void * mapping=nullptr;
+    #endif
+    emp::vector<uint8_t> owned;            ///< File contents, when not memory-mapped.
+    FileHeader header;
+    emp::vector<size_t> remap;             ///< File instruction id => library instruction id.
+    emp::vector<std::pair<size_t, size_t>> records; ///< (offset, length) of each program record.
+    std::string error;
+
+    bool Map(const std::string & path) {
+      #ifdef SGP_SERIALIZATION_MMAP
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) return false;
+      struct stat info;
+      if (::fstat(fd, &info) != 0) { ::close(fd); return false; }
+      size = (size_t)info.st_size;
+      if (size) {
+        mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) { mapping = nullptr; ::close(fd); return false; }
+        data = (const uint8_t *)mapping;
+      }
+      ::close(fd);
+      return true;
+      #else
+      std::ifstream in(path, std::ios::binary);
+      if (!in) return false;
+      owned.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      data = owned.data();
+      size = owned.size();
+      return true;
+      #endif
+    }
+
+  public:
+    MappedProgramFile() : owned(), header(), remap(), records(), error() { ; }
+    MappedProgramFile(const MappedProgramFile &) = delete;
+    MappedProgramFile & operator=(const MappedProgramFile &) = delete;
+    ~MappedProgramFile() { Close(); }
+
+    /// Map the file at path and index its program records. Returns false on failure (see GetError).
+    template<typename ILIB_T>
+    bool Open(const std::string & path, const ILIB_T & ilib) {
+      Close();
+      if (!Map(path)) { error = "Failed to open " + path + "."; return false; }
+      ByteReader in(data, data + size);
+      error = internal::ReadHeader(in, header);
+      if (error.empty()) error = internal::CheckHeader<program_t>(header, ilib, remap);
+      while (error.empty() && !in.AtEnd()) {
+        const size_t length = (size_t)in.GetVarint();
+        const uint8_t * record = in.GetBytes(length);
+        if (!in.IsOK()) error = "Truncated program record " + std::to_string(records.size()) + ".";
+        else records.emplace_back((size_t)(record - data), length);
+      }
+      if (!error.empty()) { Close(false); return false; }
+      return true;
+    }
+
+    /// Unmap the file.
+    void Close(bool clear_error=true) {
+      #ifdef SGP_SERIALIZATION_MMAP
+      if (mapping) ::munmap(mapping, size);
+      mapping = nullptr;
+      #endif
+      owned.clear();
+      data = nullptr;
+      size = 0;
+      header = FileHeader();
+      records.clear();
+      remap.clear();
+      if (clear_error) error.clear();
+    }
+
+    bool IsOpen() const { return data != nullptr || records.size(); }
+    const std::string & GetError() const { return error; }
+    const FileHeader & GetHeader() const { return header; }
+
+    /// Number of programs in the file.
+    size_t GetSize() const { return records.size(); }
+
+    record_t operator[](size_t i) const {
+      emp_assert(i < records.size(), i, records.size());
+      return record_t(data + records[i].first, records[i].second, remap);
+    }
+
+    /// Deserialize the i'th program. Returns false if its record is malformed.
+    bool Decode(size_t i, program_t & program) const { return (*this)[i].Decode(program); }
+  };
+
+}
+}
+
+#endif
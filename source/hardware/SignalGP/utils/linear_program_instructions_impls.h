@@ -277,7 +277,7 @@ namespace sgp { namespace inst_impl {
         ++call_state.IP();
       }
     } else {
-      --mem_state.AccessWorking(inst.args[0]);
+      --mem_state.AccessWorking(inst.GetArg(0));
       // Open flow
       hw.GetFlowHandler().OpenFlow(hw,{lsgp_utils::FlowType::WHILE_LOOP,
                                               cur_mp,
@@ -416,11 +416,13 @@ namespace sgp { namespace inst_impl {
   }
 
   // - Inst_Input
+  // Reads input memory with GetInput (rather than AccessInput), so input memory isn't written to;
+  // e.g., CowMemoryModel input memory stays shared with the caller's working memory.
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   void Inst_InputToWorking(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & mem_state = call_state.GetMemory();
-    mem_state.SetWorking(inst.GetArg(1), mem_state.AccessInput(inst.GetArg(0)));
+    mem_state.SetWorking(inst.GetArg(1), mem_state.GetInput(inst.GetArg(0)));
   }
 
   // - Inst_Output
@@ -527,14 +529,14 @@ namespace sgp { namespace inst_impl {
   /// Description: Sets the regulator of a tag in the matchbin.
   template<typename HARDWARE_T, typename INSTRUCTION_T, int MULTIPLIER=1>
   void Inst_SetRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
-    emp::vector<size_t> best_fun(hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1));
+    emp::vector<size_t> best_fun(hw.FindModuleMatchRaw(inst.GetTag(0), 1));
     if (best_fun.size() == 0) { return; }
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & mem_state = call_state.GetMemory();
     const double regulator_val = MULTIPLIER * mem_state.AccessWorking(inst.GetArg(0));
     // (+) values down regulate
     // (-) values up regulate
-    hw.GetMatchBin().SetRegulator(best_fun[0], regulator_val);
+    hw.SetModuleRegulator(best_fun[0], regulator_val);
   }
 
 
@@ -549,21 +551,21 @@ namespace sgp { namespace inst_impl {
     const double regulator_val = MULTIPLIER * mem_state.AccessWorking(inst.GetArg(0));
     // (+) values down regulate
     // (-) values up regulate
-    hw.GetMatchBin().SetRegulator(flow.GetMP(), regulator_val);
+    hw.SetModuleRegulator(flow.GetMP(), regulator_val);
   }
 
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   void Inst_ClearRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
-    emp::vector<size_t> best_fun(hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1));
+    emp::vector<size_t> best_fun(hw.FindModuleMatchRaw(inst.GetTag(0), 1));
     if (best_fun.size() == 0) { return; }
-    hw.GetMatchBin().SetRegulator(best_fun[0], 0);
+    hw.SetModuleRegulator(best_fun[0], 0);
   }
 
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_ClearOwnRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & flow = call_state.GetTopFlow();
-    hw.GetMatchBin().SetRegulator(flow.GetMP(), 0);
+    hw.SetModuleRegulator(flow.GetMP(), 0);
   }
 
   /// Non-default instruction: AdjRegulator
@@ -571,12 +573,12 @@ namespace sgp { namespace inst_impl {
   template<typename HARDWARE_T, typename INSTRUCTION_T, int MULTIPLIER=1>
   static void Inst_AdjRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
     // const State & state = hw.GetCurState();
-    emp::vector<size_t> best_fun = hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1);
+    emp::vector<size_t> best_fun = hw.FindModuleMatchRaw(inst.GetTag(0), 1);
     if (!best_fun.size()) return;
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & mem_state = call_state.GetMemory();
     const double adj = MULTIPLIER * mem_state.AccessWorking(inst.GetArg(0));
-    hw.GetMatchBin().AdjRegulator(best_fun[0], adj);
+    hw.AdjModuleRegulator(best_fun[0], adj);
   }
 
   /// Non-default instruction: AdjOwnRegulator
@@ -587,37 +589,37 @@ namespace sgp { namespace inst_impl {
     auto & mem_state = call_state.GetMemory();
     auto & flow = call_state.GetTopFlow();
     const double adj = MULTIPLIER * mem_state.AccessWorking(inst.GetArg(0));
-    hw.GetMatchBin().AdjRegulator(flow.GetMP(), adj);
+    hw.AdjModuleRegulator(flow.GetMP(), adj);
   }
 
   /// Non-default instruction: IncRegulator
   /// Number of arguments: 3
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_IncRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
-    emp::vector<size_t> best_fun = hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1);
+    emp::vector<size_t> best_fun = hw.FindModuleMatchRaw(inst.GetTag(0), 1);
     if (!best_fun.size()) return;
-    hw.GetMatchBin().AdjRegulator(best_fun[0], 1.0);
+    hw.AdjModuleRegulator(best_fun[0], 1.0);
   }
 
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_IncOwnRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & flow = call_state.GetTopFlow();
-    hw.GetMatchBin().AdjRegulator(flow.GetMP(), 1.0);
+    hw.AdjModuleRegulator(flow.GetMP(), 1.0);
   }
 
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_DecRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
-    emp::vector<size_t> best_fun = hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1);
+    emp::vector<size_t> best_fun = hw.FindModuleMatchRaw(inst.GetTag(0), 1);
     if (!best_fun.size()) return;
-    hw.GetMatchBin().AdjRegulator(best_fun[0], -1.0);
+    hw.AdjModuleRegulator(best_fun[0], -1.0);
   }
 
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_DecOwnRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & flow = call_state.GetTopFlow();
-    hw.GetMatchBin().AdjRegulator(flow.GetMP(), -1.0);
+    hw.AdjModuleRegulator(flow.GetMP(), -1.0);
   }
 
   /// Non-default instruction: SenseRegulator
@@ -625,11 +627,11 @@ namespace sgp { namespace inst_impl {
   /// Description: senses the value of the regulator of another function.
   template<typename HARDWARE_T, typename INSTRUCTION_T>
   static void Inst_SenseRegulator(HARDWARE_T & hw, const INSTRUCTION_T & inst) {
-    emp::vector<size_t> best_fun = hw.GetMatchBin().MatchRaw(inst.GetTag(0), 1);
+    emp::vector<size_t> best_fun = hw.FindModuleMatchRaw(inst.GetTag(0), 1);
     if (best_fun.size()) {
       auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
       auto & mem_state = call_state.GetMemory();
-      mem_state.SetWorking(inst.GetArg(0), hw.GetMatchBin().ViewRegulator(best_fun[0]));
+      mem_state.SetWorking(inst.GetArg(0), hw.ViewModuleRegulator(best_fun[0]));
     }
   }
 
@@ -641,7 +643,7 @@ namespace sgp { namespace inst_impl {
     auto & call_state = hw.GetCurThread().GetExecState().GetTopCallState();
     auto & mem_state = call_state.GetMemory();
     auto & flow = call_state.GetTopFlow();
-    mem_state.SetWorking(inst.GetArg(0), hw.GetMatchBin().ViewRegulator(flow.GetMP()));
+    mem_state.SetWorking(inst.GetArg(0), hw.ViewModuleRegulator(flow.GetMP()));
   }
 
   // - Inst_Nop
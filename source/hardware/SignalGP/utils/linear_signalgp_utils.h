@@ -1,7 +1,12 @@
 #ifndef EMP_LINEAR_SIGNALGP_UTILS
 #define EMP_LINEAR_SIGNALGP_UTILS
 
+#include <array>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <memory>
 
@@ -47,35 +52,158 @@ namespace sgp { namespace lsgp_utils {
     bool IsCall() const { return type == FlowType::CALL; }
   };
 
-  // NEED: hardware_t, flow_t, exec_state_t,
-  template<typename HARDWARE_T, typename EXEC_STATE_T>
+  /// Default behavior for opening, closing, and breaking each type of control flow: BASIC,
+  /// WHILE_LOOP, CALL, ROUTINE. All functions are static, so FlowHandler can inline them.
+  /// HARDWARE_T must provide IsValidProgramPosition(mp, ip) and GetFlowHandler().
+  struct DefaultFlowPolicy {
+
+    /// Opening any type of flow: push it onto the current call state's flow stack.
+    template<typename HARDWARE_T, typename EXEC_STATE_T>
+    static void OpenFlow(HARDWARE_T & hw, EXEC_STATE_T & exec_state, const FlowInfo & new_flow) {
+      emp_assert(exec_state.call_stack.size(), "Failed to open flow. No calls on call stack.");
+      exec_state.GetTopCallState().flow_stack.emplace_back(new_flow);
+    }
+
+    template<typename HARDWARE_T, typename EXEC_STATE_T>
+    static void CloseFlow(HARDWARE_T & hw, FlowType type, EXEC_STATE_T & exec_state) {
+      emp_assert(exec_state.call_stack.size(), "Failed to close flow. No calls on call stack.");
+      auto & call_state = exec_state.GetTopCallState();
+      emp_assert(call_state.IsFlow(), "Failed to close flow. No flow to close.");
+      switch (type) {
+        case FlowType::BASIC: {
+          // - Pop current flow from stack.
+          // - Set new top of flow stack (if any)'s IP and MP to returning IP and MP.
+          const size_t ip = call_state.GetTopFlow().ip;
+          const size_t mp = call_state.GetTopFlow().mp;
+          call_state.flow_stack.pop_back();
+          if (call_state.IsFlow()) {
+            FlowInfo & top = call_state.GetTopFlow();
+            top.ip = ip;
+            top.mp = mp;
+          }
+          break;
+        }
+        case FlowType::WHILE_LOOP: {
+          // Move IP to start of block
+          const size_t loop_begin = call_state.GetTopFlow().begin;
+          const size_t mp = call_state.GetTopFlow().mp;
+          call_state.flow_stack.pop_back();
+          if (call_state.IsFlow()) {
+            call_state.SetIP(loop_begin);
+            call_state.SetMP(mp);
+          }
+          break;
+        }
+        case FlowType::ROUTINE: {
+          // - Pop flow from flow stack
+          // - No need to pass IP and MP down (we want to return to previous IP/MP)
+          call_state.flow_stack.pop_back();
+          break;
+        }
+        case FlowType::CALL: {
+          // - Pop call flow from flow stack.
+          // - No need to pass IP and MP down (presumably, this was the bottom
+          //   of the flow stack).
+          if (call_state.IsCircular()) {
+            FlowInfo & top = call_state.GetTopFlow();
+            top.ip = top.begin;
+          } else {
+            call_state.flow_stack.pop_back();
+          }
+          break;
+        }
+      }
+    }
+
+    template<typename HARDWARE_T, typename EXEC_STATE_T>
+    static void BreakFlow(HARDWARE_T & hw, FlowType type, EXEC_STATE_T & exec_state) {
+      emp_assert(exec_state.call_stack.size(), "Failed to break flow. No calls on call stack.");
+      switch (type) {
+        case FlowType::BASIC:
+        case FlowType::WHILE_LOOP: {
+          auto & call_state = exec_state.GetTopCallState();
+          emp_assert(call_state.IsFlow(), "Failed to break flow. No flow to close.");
+          const size_t flow_end = call_state.GetTopFlow().GetEnd();
+          call_state.flow_stack.pop_back();
+          if (call_state.IsFlow()) {
+            call_state.SetIP(flow_end);
+            if (hw.IsValidProgramPosition(call_state.GetMP(), call_state.GetIP())) {
+              ++call_state.IP();
+            }
+          }
+          break;
+        }
+        // Breaking from a routine or call is the same as closing it (however closing is configured).
+        case FlowType::ROUTINE:
+        case FlowType::CALL:
+          hw.GetFlowHandler().CloseFlow(hw, type, exec_state);
+          break;
+      }
+    }
+  };
+
+  /// Manages opening, closing, and breaking each type of execution flow.
+  /// By default, flows behave as specified by POLICY_T's static OpenFlow/CloseFlow/BreakFlow
+  /// functions (which are inlined). Behavior can be overridden per flow type (and per operation)
+  /// by setting the corresponding FlowControl function (e.g., hw.SetOpenFlowFun(...)); leaving
+  /// (or setting) a function empty means 'use the policy'. FlowControl functions hold only the
+  /// overrides; Get{Open,Close,Break}FlowFun return the handler in effect (override or policy).
+  /// Hardware picks POLICY_T with its FLOW_POLICY_T template parameter.
+  template<typename HARDWARE_T, typename EXEC_STATE_T, typename POLICY_T=DefaultFlowPolicy>
   struct FlowHandler {
     using exec_state_t = EXEC_STATE_T;
     using hardware_t = HARDWARE_T;
+    using policy_t = POLICY_T;
     using fun_end_flow_t = std::function<void(hardware_t&, exec_state_t &)>;
     using fun_open_flow_t  = std::function<void(hardware_t&, exec_state_t &, const FlowInfo &)>;
 
+    static constexpr size_t NUM_FLOW_TYPES = 4;
+
+    /// Overrides for a single flow type (empty functions fall back to POLICY_T).
     struct FlowControl {
       fun_open_flow_t open_flow_fun;
       fun_end_flow_t close_flow_fun;
       fun_end_flow_t break_flow_fun;
     };
 
-    /// Mapping from flow type to flow control structure.
-    // todo - could change this to an array because we know things at compile time
-    std::map<FlowType, FlowControl> lib = {{FlowType::BASIC, FlowControl()},
-                                           {FlowType::WHILE_LOOP, FlowControl()},
-                                           {FlowType::ROUTINE, FlowControl()},
-                                           {FlowType::CALL, FlowControl()} };
+    /// Flow control overrides, indexed by flow type.
+    std::array<FlowControl, NUM_FLOW_TYPES> lib;
+
+    static size_t ToIndex(FlowType type) {
+      emp_assert((size_t)type < NUM_FLOW_TYPES, "FlowType not recognized!");
+      return (size_t)type;
+    }
+
+    FlowControl & operator[](FlowType type) { return lib[ToIndex(type)]; }
+    const FlowControl & operator[](FlowType type) const { return lib[ToIndex(type)]; }
+
+    /// Remove all overrides (i.e., every flow type behaves as specified by POLICY_T).
+    void ResetOverrides() { lib.fill(FlowControl()); }
+
+    /// Get the function that opens the given type of flow: its override, if set; otherwise, one
+    /// that calls POLICY_T's OpenFlow.
+    fun_open_flow_t GetOpenFlowFun(FlowType type) const {
+      const FlowControl & control = lib[ToIndex(type)];
+      if (control.open_flow_fun) return control.open_flow_fun;
+      return [](hardware_t & hw, exec_state_t & state, const FlowInfo & new_flow) {
+        policy_t::OpenFlow(hw, state, new_flow);
+      };
+    }
 
-    FlowControl & operator[](FlowType type) {
-      emp_assert(emp::Has(lib, type), "FlowType not recognized!");
-      return lib[type];
+    /// Get the function that closes the given type of flow: its override, if set; otherwise, one
+    /// that calls POLICY_T's CloseFlow.
+    fun_end_flow_t GetCloseFlowFun(FlowType type) const {
+      const FlowControl & control = lib[ToIndex(type)];
+      if (control.close_flow_fun) return control.close_flow_fun;
+      return [type](hardware_t & hw, exec_state_t & state) { policy_t::CloseFlow(hw, type, state); };
     }
 
-    const FlowControl & operator[](FlowType type) const {
-      emp_assert(emp::Has(lib, type), "FlowType not recognized!");
-      return lib[type];
+    /// Get the function that breaks the given type of flow: its override, if set; otherwise, one
+    /// that calls POLICY_T's BreakFlow.
+    fun_end_flow_t GetBreakFlowFun(FlowType type) const {
+      const FlowControl & control = lib[ToIndex(type)];
+      if (control.break_flow_fun) return control.break_flow_fun;
+      return [type](hardware_t & hw, exec_state_t & state) { policy_t::BreakFlow(hw, type, state); };
     }
 
     std::string FlowTypeToString(FlowType type) const {
@@ -89,22 +217,34 @@ namespace sgp { namespace lsgp_utils {
     }
 
     void OpenFlow(hardware_t & hw, const FlowInfo & new_flow, exec_state_t & state) {
-      FlowType type = new_flow.type;
-      emp_assert(emp::Has(lib, type), "FlowType not recognized!");
-      lib[type].open_flow_fun(hw, state, new_flow);
+      const FlowControl & control = lib[ToIndex(new_flow.type)];
+      if (control.open_flow_fun) control.open_flow_fun(hw, state, new_flow);
+      else policy_t::OpenFlow(hw, state, new_flow);
     }
 
     void CloseFlow(hardware_t & hw, FlowType type, exec_state_t & state) {
-      emp_assert(emp::Has(lib, type), "FlowType not recognized!");
-      lib[type].close_flow_fun(hw, state);
+      const FlowControl & control = lib[ToIndex(type)];
+      if (control.close_flow_fun) control.close_flow_fun(hw, state);
+      else policy_t::CloseFlow(hw, type, state);
     }
 
     void BreakFlow(hardware_t & hw, FlowType type, exec_state_t & state) {
-      emp_assert(emp::Has(lib, type), "FlowType not recognized!");
-      lib[type].break_flow_fun(hw, state);
+      const FlowControl & control = lib[ToIndex(type)];
+      if (control.break_flow_fun) control.break_flow_fun(hw, state);
+      else policy_t::BreakFlow(hw, type, state);
     }
   };
 
+  namespace internal {
+    // Detects whether a memory model can reset a memory state in place (ResetMemoryState).
+    template<typename MEMORY_MODEL_T, typename MEMORY_STATE_T, typename=void>
+    struct HasResetMemoryState : std::false_type { };
+    template<typename MEMORY_MODEL_T, typename MEMORY_STATE_T>
+    struct HasResetMemoryState<MEMORY_MODEL_T, MEMORY_STATE_T,
+                               std::void_t<decltype(std::declval<MEMORY_MODEL_T&>().ResetMemoryState(std::declval<MEMORY_STATE_T&>()))>>
+      : std::true_type { };
+  }
+
   /// State information for a function call.
   template<typename MEMORY_STATE_T>
   struct CallState {
@@ -115,6 +255,55 @@ namespace sgp { namespace lsgp_utils {
     CallState(const MEMORY_STATE_T & _mem=MEMORY_STATE_T(), bool _circular=false)
       : memory(_mem), flow_stack(), circular(_circular) { ; }
 
+    /// Construct a call state with fresh memory from the given memory model.
+    template<typename MEMORY_MODEL_T,
+             typename=std::enable_if_t<std::is_same<typename MEMORY_MODEL_T::memory_state_t, MEMORY_STATE_T>::value>>
+    CallState(MEMORY_MODEL_T & model, bool _circular=false)
+      : memory(model.CreateMemoryState()), flow_stack(), circular(_circular) { ; }
+
+    /// Reinitialize a recycled call state (see FrameStack). Keeps flow stack capacity.
+    void Reset(MEMORY_STATE_T && _mem, bool _circular=false) {
+      memory = std::move(_mem);
+      flow_stack.clear();
+      circular = _circular;
+    }
+
+    /// Give this call state fresh memory from the given memory model. If the model has a
+    /// ResetMemoryState(memory_state_t &), memory is reset in place (so buffers keep their
+    /// storage); otherwise, it is replaced with model.CreateMemoryState().
+    template<typename MEMORY_MODEL_T>
+    void ResetMemory(MEMORY_MODEL_T & model) {
+      if constexpr (internal::HasResetMemoryState<MEMORY_MODEL_T, MEMORY_STATE_T>::value) {
+        model.ResetMemoryState(memory);
+      } else {
+        memory = model.CreateMemoryState();
+      }
+    }
+
+    /// Reinitialize a recycled call state with fresh memory from the given memory model (see
+    /// ResetMemory). Keeps flow stack capacity.
+    template<typename MEMORY_MODEL_T,
+             typename=std::enable_if_t<std::is_same<typename MEMORY_MODEL_T::memory_state_t, MEMORY_STATE_T>::value>>
+    void Reset(MEMORY_MODEL_T & model, bool _circular=false) {
+      ResetMemory(model);
+      flow_stack.clear();
+      circular = _circular;
+    }
+
+    /// Called when this call state is popped off of a FrameStack. Memory is left as-is (to be
+    /// reset in place when the frame is reused). Keeps flow stack capacity.
+    void Release() {
+      flow_stack.clear();
+    }
+
+    /// Called when this call state is popped off of a FrameStack: empties memory with the given
+    /// memory model (see ResetMemory). Keeps flow stack capacity.
+    template<typename MEMORY_MODEL_T>
+    void Release(MEMORY_MODEL_T & model) {
+      ResetMemory(model);
+      flow_stack.clear();
+    }
+
     bool IsFlow() const { return !flow_stack.empty(); }
 
     emp::vector<FlowInfo> & GetFlowStack() { return flow_stack; }
@@ -153,12 +342,73 @@ namespace sgp { namespace lsgp_utils {
     size_t & MP() { emp_assert(flow_stack.size()); return flow_stack.back().mp; }
   };
 
+  /// Stack of call frames that recycles popped frames rather than destroying them, so that
+  /// frames (and their flow stacks) keep their capacity across calls/returns and thread resets.
+  /// Once a thread's call stack has reached a given depth, calls at or below that depth don't
+  /// allocate (besides whatever the memory model allocates).
+  /// FRAME_T must provide Reset(args...) (to reinitialize a recycled frame) and Release(args...)
+  /// (to clean up a popped frame).
+  template<typename FRAME_T>
+  class FrameStack {
+  public:
+    using value_type = FRAME_T;
+    using iterator = typename emp::vector<FRAME_T>::iterator;
+    using const_iterator = typename emp::vector<FRAME_T>::const_iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  protected:
+    emp::vector<FRAME_T> frames;  ///< Live frames ([0, num_frames)) followed by recycled ones.
+    size_t num_frames=0;
+
+  public:
+    size_t size() const { return num_frames; }
+    bool empty() const { return !num_frames; }
+    /// Number of frames (live + recycled) held by this stack.
+    size_t capacity() const { return frames.size(); }
+
+    FRAME_T & operator[](size_t i) { emp_assert(i < num_frames); return frames[i]; }
+    const FRAME_T & operator[](size_t i) const { emp_assert(i < num_frames); return frames[i]; }
+    FRAME_T & back() { emp_assert(num_frames); return frames[num_frames - 1]; }
+    const FRAME_T & back() const { emp_assert(num_frames); return frames[num_frames - 1]; }
+    FRAME_T & front() { emp_assert(num_frames); return frames[0]; }
+    const FRAME_T & front() const { emp_assert(num_frames); return frames[0]; }
+
+    iterator begin() { return frames.begin(); }
+    iterator end() { return frames.begin() + num_frames; }
+    const_iterator begin() const { return frames.begin(); }
+    const_iterator end() const { return frames.begin() + num_frames; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    /// Push a frame, recycling a previously popped frame if there is one.
+    template<typename... ARGS>
+    FRAME_T & emplace_back(ARGS &&... args) {
+      if (num_frames < frames.size()) frames[num_frames].Reset(std::forward<ARGS>(args)...);
+      else frames.emplace_back(std::forward<ARGS>(args)...);
+      return frames[num_frames++];
+    }
+
+    /// Pop a frame (keeping it for reuse). Arguments are passed on to the frame's Release.
+    template<typename... ARGS>
+    void pop_back(ARGS &&... args) {
+      emp_assert(num_frames);
+      frames[--num_frames].Release(std::forward<ARGS>(args)...);
+    }
+
+    /// Pop all frames (keeping them for reuse).
+    void clear() { while (num_frames) pop_back(); }
+  };
+
   /// Execution State. TODO - add label?
   template<typename MEMORY_MODEL_T>
   struct ExecState {
     using memory_state_t = typename MEMORY_MODEL_T::memory_state_t;
     using call_state_t = CallState<memory_state_t>;
-    emp::vector<call_state_t> call_stack;   ///< Program call stack.
+    using call_stack_t = FrameStack<call_state_t>;
+    call_stack_t call_stack;   ///< Program call stack.
 
     /// Empty out the call stack.
     void Clear() { call_stack.clear(); }
@@ -172,7 +422,7 @@ namespace sgp { namespace lsgp_utils {
     }
 
     /// Get a mutable reference to the entire call stack.
-    emp::vector<call_state_t> & GetCallStack() { return call_stack; }
+    call_stack_t & GetCallStack() { return call_stack; }
   };
 
 }}
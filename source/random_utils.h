@@ -12,7 +12,7 @@
 #ifndef SGP_BITSET_UTILS_H
 #define SGP_BITSET_UTILS_H
 
-#include <unordered_set>
+#include <cstdint>
 #include <string>
 #include <functional>
 #include <algorithm>
@@ -26,6 +26,92 @@
 
 namespace emp {
 
+  /// Randomize every bit of the given BitSet<W> (each bit is 1 with probability 0.5).
+  /// Draws 32 random bits at a time from rnd (rather than one draw per bit).
+  template<size_t W>
+  void RandomizeBitSet(emp::Random & rnd, BitSet<W> & bs) {
+    constexpr size_t NUM_WORDS = (W + 31) / 32;
+    constexpr size_t LAST_BITS = W % 32;
+    for (size_t i = 0; i < NUM_WORDS; ++i) {
+      uint32_t value = rnd.GetUInt();
+      if (LAST_BITS && i + 1 == NUM_WORDS) value &= (uint32_t(1) << LAST_BITS) - 1;
+      bs.SetUInt(i, value);
+    }
+  }
+
+  namespace internal {
+    /// Set of BitSet<W> for uniqueness checks while generating tags in bulk: open addressing
+    /// (linear probing) in a table sized up front for a known number of insertions, so there
+    /// is no rehashing and no per-element allocation.
+    template<size_t W>
+    class BitSetProbeSet {
+    protected:
+      emp::vector<BitSet<W>> slots;
+      emp::vector<unsigned char> used;
+      size_t mask;
+      size_t shift;
+
+      size_t Slot(const BitSet<W> & bs) const {
+        // Fibonacci hashing spreads weak hashes (e.g., of small tags) over the table.
+        return (size_t)(((uint64_t)std::hash<BitSet<W>>()(bs) * 0x9E3779B97F4A7C15ull) >> shift);
+      }
+
+    public:
+      /// Make a set that can hold up to max_size bitsets.
+      BitSetProbeSet(size_t max_size) {
+        size_t bits = 4;
+        while (((size_t)1 << bits) < 2 * max_size) ++bits;
+        slots.resize((size_t)1 << bits);
+        used.resize(slots.size(), 0);
+        mask = slots.size() - 1;
+        shift = 64 - bits;
+      }
+
+      /// Insert bs; return whether it was new.
+      bool Insert(const BitSet<W> & bs) {
+        for (size_t i = Slot(bs); ; i = (i + 1) & mask) {
+          if (!used[i]) {
+            used[i] = 1;
+            slots[i] = bs;
+            return true;
+          }
+          if (slots[i] == bs) return false;
+        }
+      }
+    };
+  }
+
+  /// Append 'count' random BitSet<W> to the given buffer (reusing its capacity), drawing their
+  /// bits in bulk (see RandomizeBitSet).
+  /// If 'guarantee_unique' is true (or unique_from is not empty), the appended bitsets are unique
+  /// with respect to each other and to unique_from.
+  /// @param rnd - Random number generator to use.
+  /// @param buffer - Buffer to append generated bitsets to.
+  /// @param count - How many bitsets should be generated?
+  /// @param guarantee_unique - Should generated bitsets be guaranteed to be unique from each other?
+  /// @param unique_from - Other bitsets that the bitsets being generated should be unique with respect to.
+  template<size_t W>
+  void FillRandomBitSets(emp::Random & rnd, emp::vector<BitSet<W>> & buffer, size_t count,
+                         bool guarantee_unique=false,
+                         const emp::vector<BitSet<W>> & unique_from=emp::vector<BitSet<W>>())
+  {
+    const size_t begin = buffer.size();
+    buffer.resize(begin + count);
+    if (!guarantee_unique && unique_from.size() == 0) {
+      for (size_t i = begin; i < buffer.size(); ++i) RandomizeBitSet(rnd, buffer[i]);
+      return;
+    }
+    internal::BitSetProbeSet<W> unique_set(unique_from.size() + count);
+    size_t num_unique = 0;
+    for (const BitSet<W> & bs : unique_from) num_unique += unique_set.Insert(bs);
+    emp_assert(num_unique + count <= emp::Pow2(W), "Not possible to generate requested number of BitSets");
+    for (size_t i = begin; i < buffer.size(); ++i) {
+      do {
+        RandomizeBitSet(rnd, buffer[i]);
+      } while (!unique_set.Insert(buffer[i]));
+    }
+  }
+
   /// Generate one random BitSet<W>.
   /// Given a vector of other BitSets (unique_from), this function will guarantee
   /// the generated BitSet is unique with respect to those BitSets.
@@ -33,22 +119,18 @@ namespace emp {
   /// @param unique_from - Other BitSets that the generated BitSet should be unique from.
   template<size_t W>
   BitSet<W> RandomBitSet(emp::Random & rnd, const emp::vector<BitSet<W>> & unique_from=emp::vector<BitSet<W>>()) {
-    std::unordered_set<BitSet<W>> unique_from_set(unique_from.begin(), unique_from.end());
-    emp_assert(unique_from_set.size() < emp::Pow2(W), "BitSet<W> is not large enough to be able to guarantee requested number of unique tags");
-    BitSet<W> new_bitset(rnd, 0.5);
-    while (unique_from_set.size()) {
-      if (emp::Has(unique_from_set, new_bitset)) {
-        new_bitset.Randomize(rnd);
-        continue;
-      }
-      break;
-    }
+    emp_assert(unique_from.size() < emp::Pow2(W), "BitSet<W> is not large enough to be able to guarantee requested number of unique tags");
+    BitSet<W> new_bitset;
+    do {
+      RandomizeBitSet(rnd, new_bitset);
+    } while (std::find(unique_from.begin(), unique_from.end(), new_bitset) != unique_from.end());
     return new_bitset;
   }
 
   /// Generate 'count' number of random BitSet<W>.
   /// Given a vector of other bitsets (unique_from), this function will guarantee the bitsets generated
   /// and returned are unique with respect to unique_from.
+  /// (To generate many bitsets into one reused buffer, see FillRandomBitSets.)
   /// @param rnd - Random number generator to use when generating a random bitset.
   /// @param count - How many bitsets should be generated?
   /// @param guarantee_unique - Should generated bitsets be guaranteed to be unique from each other?
@@ -57,25 +139,8 @@ namespace emp {
   emp::vector<BitSet<W>> RandomBitSets(emp::Random & rnd, size_t count, bool guarantee_unique=false,
                                        const emp::vector<BitSet<W>> & unique_from=emp::vector<BitSet<W>>())
   {
-    // If we don't have to make any promises, run quickly!
-    emp::vector<BitSet<W>> new_bitsets(count);
-    if (!guarantee_unique && unique_from.size() == 0) {
-      for (auto & bs : new_bitsets) { bs.Randomize(rnd); }
-    } else {
-      std::unordered_set<BitSet<W>> unique_from_set(unique_from.begin(), unique_from.end());
-      emp_assert(unique_from_set.size()+count <= emp::Pow2(W), "Not possible to generate requested number of BitSets");
-      for (auto & bs : new_bitsets) {
-        bs.Randomize(rnd);
-        while (unique_from_set.size()) {
-          if (emp::Has(unique_from_set, bs)) {
-            bs.Randomize(rnd);
-            continue;
-          }
-          break;
-        }
-        unique_from_set.emplace(bs);
-      }
-    }
+    emp::vector<BitSet<W>> new_bitsets;
+    FillRandomBitSets(rnd, new_bitsets, count, guarantee_unique, unique_from);
     return new_bitsets;
   }
 
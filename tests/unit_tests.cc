@@ -2,14 +2,25 @@
 
 #include "catch.hpp"
 
+#include <array>
+#include <cstdio>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
 
 #include "tools/BitSet.h"
 #include "tools/Range.h"
 
+#include "EventInbox.h"
 #include "EventLibrary.h"
+#include "EventTimerWheel.h"
+#include "StaticEventLibrary.h"
 
 #include "SignalGPBase.h"
+#include "ThreadIDSet.h"
+#include "ThreadPriorityHeap.h"
 #include "impls/SignalGPToy.h"
 #include "impls/SignalGPLinearProgram.h"
 #include "impls/SignalGPLinearFunctionsProgram.h"
@@ -17,7 +28,10 @@
 #include "utils/linear_program_instructions_impls.h"
 #include "utils/linear_functions_program_instructions_impls.h"
 #include "utils/MemoryModel.h"
+#include "utils/HammingMatchBin.h"
 #include "utils/LinearFunctionsProgram.h"
+#include "utils/BatchEvaluator.h"
+#include "utils/ProgramSerialization.h"
 #include "../source/random_utils.h"
 
 TEST_CASE( "Hello World", "[general]" ) {
@@ -125,6 +139,26 @@ TEST_CASE("RandomBitSets<W>") {
     for (size_t t = 0; t < tags.size(); ++t) temp_set.emplace(tags[t].GetUInt(0));
     REQUIRE(temp_set.size() == 128+64);
   }
+
+  // Bulk generation into a reused buffer.
+  emp::vector<emp::BitSet<20>> buffer;
+  emp::FillRandomBitSets(random, buffer, 500);
+  emp::FillRandomBitSets(random, buffer, 500);
+  REQUIRE(buffer.size() == 1000);
+  uint32_t any_bits = 0;
+  for (const auto & bs : buffer) {
+    REQUIRE(bs.GetUInt(0) < emp::Pow2(20)); // No bits past W.
+    any_bits |= bs.GetUInt(0);
+  }
+  REQUIRE(any_bits == emp::Pow2(20) - 1);
+  buffer.clear();
+  emp::FillRandomBitSets(random, buffer, 10000, true);
+  std::unordered_set<uint32_t> unique20;
+  for (const auto & bs : buffer) unique20.emplace(bs.GetUInt(0));
+  REQUIRE(unique20.size() == 10000);
+  // Unique with respect to previously generated tags (without guaranteeing uniqueness among themselves).
+  auto more_tags = emp::RandomBitSets<20>(random, 1000, false, buffer);
+  for (const auto & bs : more_tags) REQUIRE(unique20.emplace(bs.GetUInt(0)).second);
 }
 
 TEST_CASE("LinearProgram<emp::BitSet<W>,int> - GenRandInst") {
@@ -276,6 +310,30 @@ TEST_CASE("LinearProgram<emp::BitSet<W>,int> - GenRandLinearProgram") {
       }
     }
   }
+
+  // Generate a whole population at once.
+  const auto population = sgp::GenRandLinearPrograms<hardware_t, TAG_WIDTH>(random, inst_lib, 1000, {MIN_INST_CNT, MAX_INST_CNT}, NUM_TAGS, NUM_ARGS, {MIN_ARG_VAL, MAX_ARG_VAL});
+  REQUIRE(population.size() == 1000);
+  size_t total_size = 0;
+  for (const program_t & program : population) {
+    REQUIRE(program.GetSize() >= MIN_INST_CNT);
+    REQUIRE(program.GetSize() <= MAX_INST_CNT);
+    total_size += program.GetSize();
+    for (size_t pID = 0; pID < program.GetSize(); ++pID) {
+      auto & inst = program[pID];
+      REQUIRE(inst.id < inst_lib.GetSize());
+      REQUIRE(inst.GetTags().size() == NUM_TAGS);
+      REQUIRE(inst.GetArgs().size() == NUM_ARGS);
+      for (auto & arg : inst.GetArgs()) {
+        REQUIRE(arg >= MIN_ARG_VAL);
+        REQUIRE(arg <= MAX_ARG_VAL);
+      }
+    }
+  }
+  REQUIRE(population.front() != population.back());
+  // Program sizes are uniform over the requested range.
+  REQUIRE(total_size / population.size() > (MAX_INST_CNT + MIN_INST_CNT) * 4 / 10);
+  REQUIRE(total_size / population.size() < (MAX_INST_CNT + MIN_INST_CNT) * 6 / 10);
 }
 
 TEST_CASE("LinearFunction<emp::BitSet<W>, int> - GenRandLinearFunction") {
@@ -446,6 +504,36 @@ TEST_CASE("LinearFunctionsProgram<emp::BitSet<W>, int> - GenRandLinearFunctionsP
       }
     }
   }
+
+  // Generate a whole population at once.
+  const auto population = sgp::GenRandLinearFunctionsPrograms<hardware_t, TAG_WIDTH>(random, inst_lib, 200, {MIN_NUM_FUNC, MAX_NUM_FUNC}, NUM_FUNC_TAGS, {MIN_INST_CNT, MAX_INST_CNT}, NUM_INST_TAGS, NUM_INST_ARGS, {MIN_ARG_VAL, MAX_ARG_VAL});
+  REQUIRE(population.size() == 200);
+  std::unordered_set<tag_t> func_tags;
+  size_t num_func_tags = 0;
+  for (const program_t & program : population) {
+    REQUIRE(program.GetSize() >= MIN_NUM_FUNC);
+    REQUIRE(program.GetSize() <= MAX_NUM_FUNC);
+    for (size_t fID = 0; fID < program.GetSize(); ++fID) {
+      const function_t & function = program[fID];
+      REQUIRE(function.GetSize() >= MIN_INST_CNT);
+      REQUIRE(function.GetSize() <= MAX_INST_CNT);
+      REQUIRE(function.GetTags().size() == NUM_FUNC_TAGS);
+      func_tags.insert(function.GetTags().begin(), function.GetTags().end());
+      num_func_tags += NUM_FUNC_TAGS;
+      for (size_t pID = 0; pID < function.GetSize(); ++pID) {
+        const auto & inst = function.GetInstSequence()[pID];
+        REQUIRE(inst.id < inst_lib.GetSize());
+        REQUIRE(inst.GetTags().size() == NUM_INST_TAGS);
+        REQUIRE(inst.GetArgs().size() == NUM_INST_ARGS);
+        for (auto & arg : inst.GetArgs()) {
+          REQUIRE(arg >= MIN_ARG_VAL);
+          REQUIRE(arg <= MAX_ARG_VAL);
+        }
+      }
+    }
+  }
+  // Tags are random (not repeated between functions).
+  REQUIRE(func_tags.size() > num_func_tags * 9 / 10);
 }
 
 TEST_CASE("Toy SignalGP", "[general]") {
@@ -5021,3 +5109,2669 @@ TEST_CASE("SignalGP - Linear Program", "[general]") {
   // }
 
 }
+
+TEST_CASE("SignalGP - Linear Program - FindEndOfBlock", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using mem_model_t = sgp::SimpleMemoryModel;
+  using signalgp_t = sgp::LinearProgramSignalGP<mem_model_t,
+                                                emp::BitSet<TAG_WIDTH>,
+                                                int,
+                                                emp::MatchBin< size_t,
+                                                               emp::HammingMetric<TAG_WIDTH>,
+                                                               emp::RankedSelector<>,
+                                                               emp::AdditiveCountdownRegulator<>
+                                                              >>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using program_t = typename signalgp_t::program_t;
+
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+  inst_lib.AddInst("Nop", [](signalgp_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "Increment!");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "Decrement!");
+  inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+
+  emp::Random random(2);
+  signalgp_t hardware(random, inst_lib, event_lib);
+
+  // Reference implementation: the original scan, which tracks every position it has seen.
+  auto reference_eob = [&hardware, &inst_lib](size_t mp, size_t ip) {
+    const program_t & program = hardware.GetProgram();
+    int depth = 1;
+    std::unordered_set<size_t> seen;
+    while (true) {
+      if (!hardware.IsValidProgramPosition(mp, ip)) break;
+      const inst_t & inst = program[ip];
+      if (inst_lib.HasProperty(inst.GetID(), inst_prop_t::BLOCK_DEF)) {
+        ++depth;
+      } else if (inst_lib.HasProperty(inst.GetID(), inst_prop_t::BLOCK_CLOSE)) {
+        --depth;
+        if (depth == 0) break;
+      }
+      seen.emplace(ip);
+      ++ip;
+      if (ip >= program.GetSize() && seen.size() < hardware.GetModule(mp).GetSize()) ip %= program.GetSize();
+    }
+    return ip;
+  };
+
+  // Block table lookups (and scans) should agree with the reference at every position.
+  for (size_t i = 0; i < 500; ++i) {
+    program_t program(sgp::GenRandLinearProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {1, 64}));
+    hardware.SetProgram(program);
+    // Every non-module-definition position belongs to exactly one module.
+    size_t num_module_defs = 0;
+    for (size_t ip = 0; ip < program.GetSize(); ++ip) {
+      if (inst_lib.HasProperty(program[ip].GetID(), inst_prop_t::MODULE)) ++num_module_defs;
+    }
+    size_t total_module_size = 0;
+    for (size_t mp = 0; mp < hardware.GetNumModules(); ++mp) total_module_size += hardware.GetModule(mp).GetSize();
+    REQUIRE(total_module_size == program.GetSize() - num_module_defs);
+    for (size_t mp = 0; mp < hardware.GetNumModules(); ++mp) {
+      for (size_t ip = 0; ip <= program.GetSize(); ++ip) {
+        REQUIRE(hardware.GetModule(mp).InModule(ip) == hardware.IsValidProgramPosition(mp, ip));
+        REQUIRE(hardware.IsValidProgramPosition(mp, ip) == (hardware.GetModuleAt(ip) == mp));
+        const size_t expected = reference_eob(mp, ip);
+        REQUIRE(hardware.FindEndOfBlock(mp, ip) == expected);
+        REQUIRE(hardware.ScanEndOfBlock(mp, ip) == expected);
+      }
+    }
+  }
+
+  // Nested blocks + a block that wraps around the end of the program.
+  program_t program;
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});                            // 0
+  program.PushInst(inst_lib, "Close", {0, 0, 0});                          // 1
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {emp::BitSet<TAG_WIDTH>()}); // 2
+  program.PushInst(inst_lib, "While", {0, 0, 0});                          // 3
+  program.PushInst(inst_lib, "If", {0, 0, 0});                             // 4
+  program.PushInst(inst_lib, "Dec", {0, 0, 0});                            // 5
+  program.PushInst(inst_lib, "Close", {0, 0, 0});                          // 6
+  program.PushInst(inst_lib, "If", {0, 0, 0});                             // 7
+  hardware.SetProgram(program);
+  REQUIRE(hardware.GetNumModules() == 1);
+  REQUIRE(hardware.GetModule(0).GetSize() == 7);
+  for (size_t ip = 0; ip < program.GetSize(); ++ip) {
+    REQUIRE(hardware.IsValidProgramPosition(0, ip) == (ip != 2));
+  }
+  REQUIRE(!hardware.IsValidProgramPosition(0, program.GetSize()));
+  REQUIRE(hardware.FindEndOfBlock(0, 5) == 6); // If @ 4
+  REQUIRE(hardware.FindEndOfBlock(0, 4) == 2); // While @ 3 (never closed; runs off the end of the module)
+  REQUIRE(hardware.FindEndOfBlock(0, 0) == 1); // If @ 7 (wraps)
+  REQUIRE(hardware.FindEndOfBlock(0, 2) == 2); // Module definition isn't in the module.
+}
+
+TEST_CASE("SignalGP - Linear Program - In-place program edits", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using mem_model_t = sgp::SimpleMemoryModel;
+  using mem_buffer_t = typename mem_model_t::mem_buffer_t;
+  using signalgp_t = sgp::LinearProgramSignalGP<mem_model_t,
+                                                emp::BitSet<TAG_WIDTH>,
+                                                int,
+                                                emp::MatchBin< size_t,
+                                                               emp::HammingMetric<TAG_WIDTH>,
+                                                               emp::RankedSelector<>,
+                                                               emp::AdditiveCountdownRegulator<>
+                                                              >>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using inst_t = typename signalgp_t::inst_t;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using program_t = typename signalgp_t::program_t;
+
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "Increment!");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "Decrement!");
+
+  emp::Random random(2);
+  signalgp_t hardware(random, inst_lib, event_lib);
+  program_t program;
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  hardware.SetProgram(program);
+
+  auto spawned = hardware.SpawnThreadWithID(0);
+  REQUIRE(spawned);
+  auto & mem_state = hardware.GetThread(spawned.value()).GetExecState().GetTopCallState().GetMemory();
+  hardware.SingleProcess(); // Inc(0)
+  REQUIRE(mem_state.working_mem == mem_buffer_t({{0, 1.0}}));
+
+  // Edits made through EditProgram take effect on the next step, without UpdateModules.
+  hardware.EditProgram()[1].SetID(inst_lib.GetID("Dec"));
+  hardware.EditProgram()[2].GetArgs()[0] = 1;
+  REQUIRE(hardware.GetPackedProgram()[1].GetID() == inst_lib.GetID("Dec"));
+  hardware.SingleProcess(); // Dec(0)
+  REQUIRE(mem_state.working_mem == mem_buffer_t({{0, 0.0}}));
+  hardware.SingleProcess(); // Inc(1)
+  REQUIRE(mem_state.working_mem == mem_buffer_t({{0, 0.0}, {1, 1.0}}));
+
+  // In-place edits that change block structure are picked up too.
+  inst_lib.AddInst("Nop", [](signalgp_t & hw, const inst_t & inst) { ; }, "No operation!");
+  inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {signalgp_t::InstProperty::BLOCK_DEF});
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {signalgp_t::InstProperty::BLOCK_CLOSE});
+  hardware.Reset();
+  program.Clear();
+  program.PushInst(inst_lib, "If", {1, 0, 0});    // 0 (mem[1] == 0, so skip the block)
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});   // 1
+  program.PushInst(inst_lib, "Close", {0, 0, 0}); // 2
+  program.PushInst(inst_lib, "Inc", {2, 0, 0});   // 3
+  program.PushInst(inst_lib, "Nop", {0, 0, 0});   // 4
+  program.PushInst(inst_lib, "Inc", {3, 0, 0});   // 5
+  hardware.SetProgram(program);
+  REQUIRE(hardware.FindEndOfBlock(0, 1) == 2);
+  // Move the Close from 2 to 4.
+  hardware.EditProgram()[2].SetID(inst_lib.GetID("Nop"));
+  hardware.EditProgram()[4].SetID(inst_lib.GetID("Close"));
+  REQUIRE(hardware.FindEndOfBlock(0, 1) == 4);
+  spawned = hardware.SpawnThreadWithID(0);
+  REQUIRE(spawned);
+  auto & block_mem_state = hardware.GetThread(spawned.value()).GetExecState().GetTopCallState().GetMemory();
+  hardware.SingleProcess(); // If(1): skip past the Close @ 4
+  REQUIRE(hardware.FindEndOfBlock(0, 1) == 4);
+  hardware.SingleProcess(); // Inc(3)
+  REQUIRE(block_mem_state.working_mem == mem_buffer_t({{1, 0.0}, {3, 1.0}}));
+}
+
+TEST_CASE("SignalGP - RegisterMemoryModel", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  constexpr size_t NUM_REGISTERS = 8;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using simple_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using reg_mem_model_t = sgp::RegisterMemoryModel<NUM_REGISTERS>;
+  using reg_hw_t = sgp::LinearProgramSignalGP<reg_mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using program_t = typename simple_hw_t::program_t;
+
+  // Out-of-range keys.
+  using wrap_buffer_t = sgp::RegisterBuffer<NUM_REGISTERS, sgp::RegisterIndexMode::MODULO>;
+  using clamp_buffer_t = sgp::RegisterBuffer<NUM_REGISTERS, sgp::RegisterIndexMode::CLAMP>;
+  REQUIRE(wrap_buffer_t::ToIndex(3) == 3);
+  REQUIRE(wrap_buffer_t::ToIndex(8) == 0);
+  REQUIRE(wrap_buffer_t::ToIndex(19) == 3);
+  REQUIRE(wrap_buffer_t::ToIndex(-1) == 7);
+  REQUIRE(wrap_buffer_t::ToIndex(-9) == 7);
+  REQUIRE(clamp_buffer_t::ToIndex(3) == 3);
+  REQUIRE(clamp_buffer_t::ToIndex(8) == 7);
+  REQUIRE(clamp_buffer_t::ToIndex(-4) == 0);
+
+  // Buffers behave like the map-based buffers: untouched registers read as 0
+  // and are skipped by iteration.
+  wrap_buffer_t buffer;
+  REQUIRE(buffer.empty());
+  REQUIRE(buffer.Get(2) == 0.0);
+  buffer.Set(10, 4.0);
+  buffer.Access(-1) += 1.0;
+  REQUIRE(buffer.size() == 2);
+  REQUIRE(buffer.Get(2) == 4.0);
+  REQUIRE(buffer == wrap_buffer_t({{2, 4.0}, {7, 1.0}}));
+  emp::vector<std::pair<int, double>> visited(buffer.begin(), buffer.end());
+  REQUIRE(visited == emp::vector<std::pair<int, double>>({{2, 4.0}, {7, 1.0}}));
+
+  // Shared instruction set (added in the same order, so instruction IDs line up).
+  auto add_insts = [](auto & inst_lib, auto * hw) {
+    using hw_t = std::remove_pointer_t<decltype(hw)>;
+    using inst_t = typename hw_t::inst_t;
+    using inst_prop_t = typename hw_t::InstProperty;
+    inst_lib.AddInst("ModuleDef", [](hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+    inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+    inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<hw_t, inst_t>, "");
+    inst_lib.AddInst("Not", sgp::inst_impl::Inst_Not<hw_t, inst_t>, "");
+    inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<hw_t, inst_t>, "");
+    inst_lib.AddInst("Sub", sgp::inst_impl::Inst_Sub<hw_t, inst_t>, "");
+    inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<hw_t, inst_t>, "");
+    inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("If", sgp::inst_impl::Inst_If<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("While", sgp::inst_impl::Inst_While<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<hw_t, inst_t>, "");
+    inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<hw_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+    inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<hw_t, inst_t>, "");
+    inst_lib.AddInst("Routine", sgp::inst_impl::Inst_Routine<hw_t, inst_t>, "");
+    inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<hw_t, inst_t>, "");
+    inst_lib.AddInst("CopyMem", sgp::inst_impl::Inst_CopyMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("SwapMem", sgp::inst_impl::Inst_SwapMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("InputToWorking", sgp::inst_impl::Inst_InputToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToOutput", sgp::inst_impl::Inst_WorkingToOutput<hw_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<hw_t, inst_t>, "");
+    inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("FullWorkingToGlobal", sgp::inst_impl::Inst_FullWorkingToGlobal<hw_t, inst_t>, "");
+    inst_lib.AddInst("FullGlobalToWorking", sgp::inst_impl::Inst_FullGlobalToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<hw_t, inst_t>, "");
+    inst_lib.AddInst("Terminate", sgp::inst_impl::Inst_Terminate<hw_t, inst_t>, "");
+  };
+
+  typename simple_hw_t::inst_lib_t simple_inst_lib;
+  typename simple_hw_t::event_lib_t simple_event_lib;
+  typename reg_hw_t::inst_lib_t reg_inst_lib;
+  typename reg_hw_t::event_lib_t reg_event_lib;
+  add_insts(simple_inst_lib, (simple_hw_t*)nullptr);
+  add_insts(reg_inst_lib, (reg_hw_t*)nullptr);
+
+  emp::Random random(3);
+  emp::Random simple_random(4);
+  emp::Random reg_random(4);
+  simple_hw_t simple_hw(simple_random, simple_inst_lib, simple_event_lib);
+  reg_hw_t reg_hw(reg_random, reg_inst_lib, reg_event_lib);
+
+  auto same_value = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+
+  // With every argument in [0, NUM_REGISTERS), running the same program should
+  // give the same results under both memory models.
+  for (size_t i = 0; i < 100; ++i) {
+    program_t program(sgp::GenRandLinearProgram<simple_hw_t, TAG_WIDTH>(random, simple_inst_lib, {1, 64}, 1, 3, {0, (int)NUM_REGISTERS - 1}));
+    simple_hw.Reset();
+    reg_hw.Reset();
+    simple_hw.SetProgram(program);
+    reg_hw.SetProgram(program);
+    for (size_t step = 0; step < 512; ++step) {
+      if (!simple_hw.GetNumActiveThreads() && !simple_hw.GetNumPendingThreads()) simple_hw.SpawnThreadWithID(0);
+      if (!reg_hw.GetNumActiveThreads() && !reg_hw.GetNumPendingThreads()) reg_hw.SpawnThreadWithID(0);
+      simple_hw.SingleProcess();
+      reg_hw.SingleProcess();
+    }
+    REQUIRE(simple_hw.GetNumActiveThreads() == reg_hw.GetNumActiveThreads());
+    const auto & simple_global = simple_hw.GetMemoryModel().GetGlobalBuffer();
+    const auto & reg_global = reg_hw.GetMemoryModel().GetGlobalBuffer();
+    REQUIRE(simple_global.size() == reg_global.size());
+    for (const auto & mem : simple_global) {
+      REQUIRE(reg_global.Has(mem.first));
+      REQUIRE(same_value(mem.second, reg_global.Get(mem.first)));
+    }
+  }
+
+  // Out-of-range arguments wrap around.
+  {
+    program_t program;
+    program.PushInst(reg_inst_lib, "Inc", {9, 0, 0});
+    program.PushInst(reg_inst_lib, "Inc", {-7, 0, 0});
+    program.PushInst(reg_inst_lib, "WorkingToGlobal", {1, 15, 0});
+    reg_hw.Reset();
+    reg_hw.SetProgram(program);
+    auto spawned = reg_hw.SpawnThreadWithID(0);
+    REQUIRE((bool)spawned);
+    auto & mem_state = reg_hw.GetThread(spawned.value()).GetExecState().GetTopCallState().GetMemory();
+    reg_hw.SingleProcess();
+    reg_hw.SingleProcess();
+    REQUIRE(mem_state.working_mem == reg_mem_model_t::mem_buffer_t({{1, 2.0}}));
+    reg_hw.SingleProcess();
+    REQUIRE(reg_hw.GetMemoryModel().GetGlobalBuffer() == reg_mem_model_t::mem_buffer_t({{7, 2.0}}));
+  }
+
+  // The register memory model also plugs into LinearFunctionsProgramSignalGP.
+  {
+    using lfp_hw_t = sgp::LinearFunctionsProgramSignalGP<reg_mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+    using inst_t = typename lfp_hw_t::inst_t;
+    using inst_prop_t = typename lfp_hw_t::InstProperty;
+    typename lfp_hw_t::inst_lib_t inst_lib;
+    typename lfp_hw_t::event_lib_t event_lib;
+    inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<lfp_hw_t, inst_t>, "");
+    inst_lib.AddInst("If", sgp::lfp_inst_impl::Inst_If<lfp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<lfp_hw_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+    inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<lfp_hw_t, inst_t>, "");
+    inst_lib.AddInst("InputToWorking", sgp::inst_impl::Inst_InputToWorking<lfp_hw_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToOutput", sgp::inst_impl::Inst_WorkingToOutput<lfp_hw_t, inst_t>, "");
+    lfp_hw_t hardware(random, inst_lib, event_lib);
+    typename lfp_hw_t::program_t program;
+    typename lfp_hw_t::tag_t tag_0;
+    typename lfp_hw_t::tag_t tag_1;
+    tag_1.SetUInt(0, 0xFFFF);
+    program.PushFunction(tag_0);
+    program.PushInst(inst_lib, "Inc", {12, 0, 0});
+    program.PushInst(inst_lib, "Call", {0, 0, 0}, {tag_1});
+    program.PushFunction(tag_1);
+    program.PushInst(inst_lib, "InputToWorking", {4, 5, 0});
+    program.PushInst(inst_lib, "Inc", {5, 0, 0});
+    program.PushInst(inst_lib, "WorkingToOutput", {5, 6, 0});
+    hardware.SetProgram(program);
+    auto spawned = hardware.SpawnThreadWithID(0);
+    REQUIRE((bool)spawned);
+    auto & call_stack = hardware.GetThread(spawned.value()).GetExecState().GetCallStack();
+    for (size_t i = 0; i < 5; ++i) hardware.SingleProcess();
+    REQUIRE(call_stack.size() == 2);
+    REQUIRE(call_stack.back().GetMemory().output_mem == reg_mem_model_t::mem_buffer_t({{6, 2.0}}));
+    hardware.SingleProcess(); // Return from call.
+    REQUIRE(call_stack.size() == 1);
+    REQUIRE(call_stack.back().GetMemory().working_mem == reg_mem_model_t::mem_buffer_t({{4, 1.0}, {6, 2.0}}));
+  }
+}
+
+// Static instruction set (> 16 instructions to exercise chained switches), as a library template
+// for LinearProgramSignalGP's INST_LIB_T.
+template<typename HW, typename INST, typename PROP>
+using TestStaticInstLib =
+  sgp::StaticInstructionLibrary<HW, INST, PROP,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Inc<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Dec<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Not<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Add<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Sub<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_TestLess<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_SetMem<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_If<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_While<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Countdown<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Break<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Close<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Call<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Routine<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Return<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_CopyMem<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_SwapMem<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_InputToWorking<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_WorkingToOutput<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_WorkingToGlobal<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_GlobalToWorking<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Fork<HW, INST>>,
+                                sgp::InstFun<&sgp::inst_impl::Inst_Terminate<HW, INST>>
+                                >;
+
+TEST_CASE("SignalGP - StaticInstructionLibrary", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using mem_model_t = sgp::SimpleMemoryModel;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using static_signalgp_t = sgp::LinearProgramSignalGP<mem_model_t, emp::BitSet<TAG_WIDTH>, int, matchbin_t,
+                                                       sgp::DefaultCustomComponent, sgp::NoInstrumentation, void,
+                                                       TestStaticInstLib>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using program_t = typename signalgp_t::program_t;
+  using mem_buffer_t = typename mem_model_t::mem_buffer_t;
+  using static_inst_lib_t = typename static_signalgp_t::inst_lib_t;
+  using static_inst_prop_t = typename static_signalgp_t::InstProperty;
+  using static_event_lib_t = typename static_signalgp_t::event_lib_t;
+
+  static_assert(std::is_same<static_inst_lib_t, TestStaticInstLib<static_signalgp_t, inst_t, static_inst_prop_t>>::value);
+  static_assert(std::is_same<typename static_signalgp_t::program_t, program_t>::value);
+
+  static_inst_lib_t static_inst_lib({
+    {"Inc"}, {"Dec"}, {"Not"}, {"Add"}, {"Sub"}, {"TestLess"}, {"SetMem"},
+    {"If", "", {static_inst_prop_t::BLOCK_DEF}}, {"While", "", {static_inst_prop_t::BLOCK_DEF}},
+    {"Countdown", "", {static_inst_prop_t::BLOCK_DEF}}, {"Break"}, {"Close", "", {static_inst_prop_t::BLOCK_CLOSE}},
+    {"Call"}, {"Routine"}, {"Return"}, {"CopyMem"}, {"SwapMem"}, {"InputToWorking"},
+    {"WorkingToOutput"}, {"WorkingToGlobal"}, {"GlobalToWorking"}, {"Fork"}, {"Terminate"}
+  });
+  // Runtime instructions can still be added after the static set.
+  static_inst_lib.AddInst("ModuleDef", [](static_signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {static_inst_prop_t::MODULE});
+
+  REQUIRE(static_inst_lib.GetSize() == static_inst_lib_t::NUM_STATIC_INSTS + 1);
+  REQUIRE(static_inst_lib.GetNumStaticInsts() == static_inst_lib_t::NUM_STATIC_INSTS);
+  REQUIRE(static_inst_lib.GetID("Close") == 11);
+  REQUIRE(static_inst_lib.HasProperty(static_inst_lib.GetID("While"), static_inst_prop_t::BLOCK_DEF));
+  REQUIRE(static_inst_lib.HasProperty(static_inst_lib.GetID("ModuleDef"), static_inst_prop_t::MODULE));
+
+  // Equivalent, fully dynamic instruction library (on hardware that uses InstructionLibrary).
+  inst_lib_t dynamic_inst_lib;
+  dynamic_inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Not", sgp::inst_impl::Inst_Not<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Sub", sgp::inst_impl::Inst_Sub<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  dynamic_inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  dynamic_inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  dynamic_inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  dynamic_inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Routine", sgp::inst_impl::Inst_Routine<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("CopyMem", sgp::inst_impl::Inst_CopyMem<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("SwapMem", sgp::inst_impl::Inst_SwapMem<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("InputToWorking", sgp::inst_impl::Inst_InputToWorking<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("WorkingToOutput", sgp::inst_impl::Inst_WorkingToOutput<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("Terminate", sgp::inst_impl::Inst_Terminate<signalgp_t, inst_t>, "");
+  dynamic_inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  REQUIRE(dynamic_inst_lib.GetSize() == static_inst_lib.GetSize());
+  for (size_t id = 0; id < static_inst_lib.GetSize(); ++id) REQUIRE(dynamic_inst_lib.GetName(id) == static_inst_lib.GetName(id));
+
+  event_lib_t event_lib;
+  static_event_lib_t static_event_lib;
+  emp::Random random(5);
+  emp::Random static_random(6);
+  emp::Random dynamic_random(6);
+  static_signalgp_t static_hw(static_random, static_inst_lib, static_event_lib);
+  signalgp_t dynamic_hw(dynamic_random, dynamic_inst_lib, event_lib);
+
+  SECTION ("Explicit program") {
+    program_t program;
+    program.PushInst(static_inst_lib, "Inc", {0, 0, 0});
+    program.PushInst(static_inst_lib, "Inc", {1, 0, 0});
+    program.PushInst(static_inst_lib, "Add", {0, 1, 2});
+    program.PushInst(static_inst_lib, "WorkingToGlobal", {2, 3, 0});
+    program.PushInst(static_inst_lib, "ModuleDef", {0, 0, 0}, {typename static_signalgp_t::tag_t()});
+    static_hw.SetProgram(program);
+    auto spawned = static_hw.SpawnThreadWithID(0);
+    REQUIRE((bool)spawned);
+    auto & mem_state = static_hw.GetThread(spawned.value()).GetExecState().GetTopCallState().GetMemory();
+    for (size_t i = 0; i < 4; ++i) static_hw.SingleProcess();
+    REQUIRE(mem_state.working_mem == mem_buffer_t({{0, 1.0}, {1, 1.0}, {2, 2.0}}));
+    REQUIRE(static_hw.GetMemoryModel().GetGlobalBuffer() == mem_buffer_t({{3, 2.0}}));
+  }
+
+  SECTION ("Random programs") {
+    // Static and dynamic dispatch should produce identical executions.
+    for (size_t i = 0; i < 200; ++i) {
+      program_t program(sgp::GenRandLinearProgram<static_signalgp_t, TAG_WIDTH>(random, static_inst_lib, {1, 64}, 1, 3, {0, 7}));
+      static_hw.Reset();
+      dynamic_hw.Reset();
+      static_hw.SetProgram(program);
+      dynamic_hw.SetProgram(program);
+      for (size_t step = 0; step < 256; ++step) {
+        if (!static_hw.GetNumActiveThreads() && !static_hw.GetNumPendingThreads()) static_hw.SpawnThreadWithID(0);
+        if (!dynamic_hw.GetNumActiveThreads() && !dynamic_hw.GetNumPendingThreads()) dynamic_hw.SpawnThreadWithID(0);
+        static_hw.SingleProcess();
+        dynamic_hw.SingleProcess();
+      }
+      REQUIRE(static_hw.GetActiveThreadIDs() == dynamic_hw.GetActiveThreadIDs());
+      for (size_t thread_id : static_hw.GetActiveThreadIDs()) {
+        auto & static_stack = static_hw.GetThread(thread_id).GetExecState().GetCallStack();
+        auto & dynamic_stack = dynamic_hw.GetThread(thread_id).GetExecState().GetCallStack();
+        REQUIRE(static_stack.size() == dynamic_stack.size());
+        if (static_stack.size()) {
+          REQUIRE(static_stack.back().GetMemory().working_mem.size() == dynamic_stack.back().GetMemory().working_mem.size());
+        }
+      }
+      REQUIRE(static_hw.GetMemoryModel().GetGlobalBuffer().size() == dynamic_hw.GetMemoryModel().GetGlobalBuffer().size());
+    }
+  }
+}
+
+TEST_CASE("PackedLinearProgram<emp::BitSet<W>, int>", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using tag_t = emp::BitSet<TAG_WIDTH>;
+  using program_t = sgp::LinearProgram<tag_t, int>;
+  using packed_program_t = sgp::PackedLinearProgram<tag_t, int, 3>;
+
+  emp::Random random(7);
+
+  // Packed instructions should present the same ID/arguments/tags as the source program,
+  // including instructions whose arguments don't fit inline.
+  auto check_same = [](const program_t & program, const packed_program_t & packed) {
+    REQUIRE(packed.GetSize() == program.GetSize());
+    for (size_t i = 0; i < program.GetSize(); ++i) {
+      const auto & inst = program[i];
+      const auto & packed_inst = packed[i];
+      REQUIRE(packed_inst.GetID() == inst.GetID());
+      REQUIRE(packed_inst.GetArgs().size() == inst.GetArgs().size());
+      REQUIRE(packed_inst.GetTags().size() == inst.GetTags().size());
+      REQUIRE(emp::vector<int>(packed_inst.GetArgs().begin(), packed_inst.GetArgs().end()) == inst.GetArgs());
+      REQUIRE(emp::vector<tag_t>(packed_inst.GetTags().begin(), packed_inst.GetTags().end()) == inst.GetTags());
+      for (size_t a = 0; a < inst.GetArgs().size(); ++a) REQUIRE(packed_inst.GetArg(a) == inst.GetArg(a));
+      for (size_t t = 0; t < inst.GetTags().size(); ++t) REQUIRE(packed_inst.GetTag(t) == inst.GetTag(t));
+    }
+  };
+
+  for (size_t i = 0; i < 200; ++i) {
+    program_t program;
+    const size_t num_insts = random.GetUInt(0, 32);
+    for (size_t k = 0; k < num_insts; ++k) {
+      emp::vector<int> args(random.GetUInt(0, 6));
+      for (int & arg : args) arg = random.GetInt(-8, 8);
+      program.PushInst(random.GetUInt(16), args, emp::RandomBitSets<TAG_WIDTH>(random, random.GetUInt(0, 3)));
+    }
+    packed_program_t packed(program);
+    check_same(program, packed);
+    // Copies must point at their own storage.
+    packed_program_t copied(packed);
+    packed.Clear();
+    check_same(program, copied);
+    packed = copied;
+    copied.Load(program_t());
+    REQUIRE(copied.GetSize() == 0);
+    check_same(program, packed);
+  }
+
+  // Instructions copied out of a packed program must not depend on it.
+  auto check_inst = [](const program_t::inst_t & inst, const packed_program_t::inst_t & packed_inst) {
+    REQUIRE(packed_inst.GetID() == inst.GetID());
+    REQUIRE(emp::vector<int>(packed_inst.GetArgs().begin(), packed_inst.GetArgs().end()) == inst.GetArgs());
+    REQUIRE(emp::vector<tag_t>(packed_inst.GetTags().begin(), packed_inst.GetTags().end()) == inst.GetTags());
+    for (size_t a = 0; a < inst.GetArgs().size(); ++a) REQUIRE(packed_inst.GetArg(a) == inst.GetArg(a));
+  };
+  program_t program;
+  program.PushInst(1, {1, 2}, emp::RandomBitSets<TAG_WIDTH>(random, 2));
+  program.PushInst(2, {1, 2, 3, 4, 5}, emp::RandomBitSets<TAG_WIDTH>(random, 1));
+  program.PushInst(3, {}, {});
+  packed_program_t packed(program);
+  emp::vector<packed_program_t::inst_t> copies;
+  for (size_t i = 0; i < packed.GetSize(); ++i) {
+    packed_program_t::inst_t copy = packed[i];
+    copies.emplace_back(copy);
+  }
+  packed_program_t::inst_t assigned;
+  assigned = packed[1];
+  program_t other;
+  for (size_t k = 0; k < 8; ++k) other.PushInst(k, {9, 9, 9, 9}, emp::RandomBitSets<TAG_WIDTH>(random, 3));
+  packed.Load(other);
+  for (size_t i = 0; i < program.GetSize(); ++i) check_inst(program[i], copies[i]);
+  check_inst(program[1], assigned);
+  packed.Clear();
+  for (size_t i = 0; i < program.GetSize(); ++i) check_inst(program[i], copies[i]);
+  // LinearProgram instructions convert to packed instructions.
+  for (size_t i = 0; i < program.GetSize(); ++i) {
+    const packed_program_t::inst_t & converted = program[i];
+    check_inst(program[i], converted);
+  }
+}
+
+TEST_CASE("BatchEvaluator<LinearFunctionsProgramSignalGP>", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using mem_model_t = sgp::SimpleMemoryModel;
+  using signalgp_t = sgp::LinearFunctionsProgramSignalGP<mem_model_t,
+                                                         emp::BitSet<TAG_WIDTH>,
+                                                         int,
+                                                         emp::MatchBin< size_t,
+                                                                        emp::HammingMetric<TAG_WIDTH>,
+                                                                        emp::RankedSelector<>,
+                                                                        emp::AdditiveCountdownRegulator<>
+                                                                      >>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using program_t = typename signalgp_t::program_t;
+  using evaluator_t = sgp::BatchEvaluator<signalgp_t>;
+
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  inst_lib.AddInst("Break", sgp::inst_impl::Inst_Break<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("If", sgp::lfp_inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("While", sgp::lfp_inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Countdown", sgp::lfp_inst_impl::Inst_Countdown<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+
+  emp::Random random(8);
+  emp::vector<program_t> programs;
+  for (size_t i = 0; i < 300; ++i) {
+    // Uneven program sizes => uneven runtimes.
+    const size_t max_insts = (i % 10 == 0) ? 128 : 16;
+    programs.emplace_back(sgp::GenRandLinearFunctionsProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {1, 4}, 1, {1, max_insts}, 1, 3, {0, 7}));
+  }
+
+  // Score: a draw from the hardware's random number generator, plus the final global memory.
+  auto evaluate = [](emp::vector<double> & scores) {
+    return [&scores](signalgp_t & hw, const program_t & program, size_t program_id) {
+      hw.SetProgram(program);
+      double score = hw.GetRandom().GetUInt(1000);
+      hw.SpawnThreadWithID(0);
+      hw.Process(256);
+      for (const auto & mem : hw.GetMemoryModel().GetGlobalBuffer()) score += mem.first * mem.second;
+      scores[program_id] = score;
+    };
+  };
+  auto setup = [](signalgp_t & hw) { hw.SetActiveThreadLimit(8); };
+
+  emp::vector<double> serial_scores(programs.size(), -1.0);
+  emp::vector<double> parallel_scores(programs.size(), -1.0);
+  {
+    evaluator_t serial(inst_lib, event_lib, 1, 10, setup);
+    REQUIRE(serial.GetNumWorkers() == 1);
+    serial.Evaluate(programs, evaluate(serial_scores));
+  }
+  evaluator_t parallel(inst_lib, event_lib, 4, 10, setup);
+  REQUIRE(parallel.GetNumWorkers() == 4);
+  // Evaluate several batches on the same pool; results shouldn't depend on scheduling.
+  for (size_t rep = 0; rep < 3; ++rep) {
+    std::fill(parallel_scores.begin(), parallel_scores.end(), -1.0);
+    parallel.Evaluate(programs, evaluate(parallel_scores));
+    for (size_t i = 0; i < programs.size(); ++i) {
+      REQUIRE(parallel_scores[i] != -1.0);
+      REQUIRE((parallel_scores[i] == serial_scores[i] || (std::isnan(parallel_scores[i]) && std::isnan(serial_scores[i]))));
+    }
+  }
+
+  // Partial batches.
+  std::fill(parallel_scores.begin(), parallel_scores.end(), -1.0);
+  parallel.Evaluate(programs.data() + 10, 3, [&parallel_scores](signalgp_t & hw, const program_t & program, size_t program_id) {
+    parallel_scores[program_id] = 1.0;
+  });
+  REQUIRE(std::count(parallel_scores.begin(), parallel_scores.end(), 1.0) == 3);
+  REQUIRE(parallel_scores[0] == 1.0);
+
+  // Exceptions thrown by evaluations propagate to the caller.
+  REQUIRE_THROWS(parallel.Evaluate(programs, [](signalgp_t & hw, const program_t & program, size_t program_id) {
+    if (program_id == 5) throw std::runtime_error("bad program");
+  }));
+  // ...and the pool is still usable afterward.
+  size_t count = 0;
+  std::mutex count_mutex;
+  parallel.Evaluate(programs, [&count, &count_mutex](signalgp_t & hw, const program_t & program, size_t program_id) {
+    std::lock_guard<std::mutex> lock(count_mutex);
+    ++count;
+  });
+  REQUIRE(count == programs.size());
+}
+
+TEST_CASE("SignalGP - EventQueue", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel,
+                                                emp::BitSet<TAG_WIDTH>,
+                                                int,
+                                                emp::MatchBin< size_t,
+                                                               emp::HammingMetric<TAG_WIDTH>,
+                                                               emp::RankedSelector<>,
+                                                               emp::AdditiveCountdownRegulator<>
+                                                              >>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using event_t = typename signalgp_t::event_t;
+
+  // Non-trivial event: payload string + a token that counts live copies.
+  struct MessageEvent : public sgp::BaseEvent {
+    std::string msg;
+    std::shared_ptr<int> token;
+    MessageEvent(size_t id, const std::string & m, const std::shared_ptr<int> & t)
+      : BaseEvent(id), msg(m), token(t) { ; }
+    void Print(std::ostream & os) const override { os << "{msg:" << msg << "}"; }
+  };
+  // Trivially destructible event that's bigger than an arena block.
+  struct BigEvent : public sgp::BaseEvent {
+    std::array<double, 1024> data;
+    BigEvent(size_t id, double val) : BaseEvent(id), data() { data.fill(val); }
+  };
+
+  emp::vector<std::string> handled;
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+  const size_t msg_id = event_lib.AddEvent("Message", [&handled](signalgp_t & hw, const event_t & e) {
+    const MessageEvent & event = static_cast<const MessageEvent &>(e);
+    handled.emplace_back(event.msg);
+    // Handlers may queue more events; they're handled in the same step.
+    if (event.msg == "ping") hw.QueueEvent(MessageEvent(event.GetID(), "pong", event.token));
+  });
+  const size_t big_id = event_lib.AddEvent("Big", [&handled](signalgp_t & hw, const event_t & e) {
+    const BigEvent & event = static_cast<const BigEvent &>(e);
+    handled.emplace_back("big:" + std::to_string((int)(event.data.front() + event.data.back())));
+  });
+
+  emp::Random random(9);
+  signalgp_t hardware(random, inst_lib, event_lib);
+  auto token = std::make_shared<int>(0);
+
+  hardware.QueueEvent(MessageEvent(msg_id, "a", token));
+  hardware.QueueEvent(BigEvent(big_id, 2.0));
+  hardware.QueueEvent(MessageEvent(msg_id, "ping", token));
+  hardware.QueueEvent(sgp::BaseEvent(big_id + 1));
+  REQUIRE(hardware.GetNumQueuedEvents() == 4);
+  REQUIRE(token.use_count() == 3);
+
+  std::ostringstream os;
+  hardware.PrintEventQueue(os);
+  REQUIRE(os.str() == "Event queue (4): [{msg:a}, {id:1}, {msg:ping}, {id:2}]");
+
+  // Copies of the hardware get their own copies of queued events.
+  {
+    signalgp_t hw_copy(hardware);
+    REQUIRE(hw_copy.GetNumQueuedEvents() == 4);
+    REQUIRE(token.use_count() == 5);
+    hw_copy.ClearEventQueue();
+    REQUIRE(hw_copy.GetNumQueuedEvents() == 0);
+    REQUIRE(token.use_count() == 3);
+  }
+
+  // Register a handler for the plain BaseEvent (id 2) before processing.
+  event_lib.AddEvent("Nothing", [](signalgp_t & hw, const event_t & e) { ; });
+  hardware.SingleProcess();
+  REQUIRE(handled == emp::vector<std::string>({"a", "big:4", "ping", "pong"}));
+  REQUIRE(hardware.GetNumQueuedEvents() == 0);
+  REQUIRE(token.use_count() == 1);
+
+  // Arena memory gets reused step after step.
+  for (size_t i = 0; i < 10; ++i) {
+    for (size_t k = 0; k < 50; ++k) hardware.QueueEvent(MessageEvent(msg_id, "x", token));
+    hardware.SingleProcess();
+  }
+  REQUIRE(token.use_count() == 1);
+
+  // Standalone queue: FIFO order, arena reuse, and O(1) rewind when empty.
+  sgp::EventQueue<sgp::BaseEvent, 256> queue;
+  for (size_t rep = 0; rep < 3; ++rep) {
+    for (size_t i = 0; i < 100; ++i) queue.Push(MessageEvent(i, "m", token));
+    const size_t num_blocks = queue.GetNumBlocks();
+    REQUIRE(queue.size() == 100);
+    for (size_t i = 0; i < 100; ++i) {
+      REQUIRE(queue.Front().GetID() == i);
+      queue.PopFront();
+    }
+    REQUIRE(queue.empty());
+    REQUIRE(token.use_count() == 1);
+    if (rep) REQUIRE(queue.GetNumBlocks() == num_blocks);
+  }
+  queue.Push(BigEvent(0, 1.0));
+  queue.Push(MessageEvent(1, "after big", token));
+  sgp::EventQueue<sgp::BaseEvent, 256> moved(std::move(queue));
+  REQUIRE(queue.empty());
+  REQUIRE(moved.size() == 2);
+  REQUIRE(static_cast<const MessageEvent &>(moved[1]).msg == "after big");
+  moved.Clear();
+  REQUIRE(token.use_count() == 1);
+}
+
+TEST_CASE("SignalGP - ThreadIDSet", "[general]") {
+  emp::Random random(3);
+
+  // Random operations should match std::unordered_set.
+  sgp::ThreadIDSet id_set(32);
+  std::unordered_set<size_t> ref_set;
+  for (size_t i = 0; i < 10000; ++i) {
+    const size_t id = (size_t)random.GetUInt(48); // Some ids beyond initial capacity.
+    if (random.P(0.5)) {
+      REQUIRE(id_set.insert(id) == ref_set.emplace(id).second);
+    } else {
+      REQUIRE(id_set.erase(id) == ref_set.erase(id));
+    }
+    REQUIRE(id_set.size() == ref_set.size());
+    REQUIRE(id_set.Has(id) == (bool)ref_set.count(id));
+    if (random.P(0.01)) {
+      id_set.clear();
+      ref_set.clear();
+      REQUIRE(id_set.empty());
+    }
+  }
+  std::unordered_set<size_t> iterated(id_set.begin(), id_set.end());
+  REQUIRE(iterated == ref_set);
+
+  // Equality ignores order.
+  sgp::ThreadIDSet a;
+  sgp::ThreadIDSet b;
+  for (size_t id : {3, 1, 4, 5}) a.insert(id);
+  for (size_t id : {5, 4, 3, 1}) b.insert(id);
+  REQUIRE(a == b);
+  b.erase(1);
+  REQUIRE(a != b);
+  b.insert(9);
+  REQUIRE(a != b);
+
+  // Shrinking thread capacity drops out-of-range active thread ids.
+  using signalgp_t = ToySignalGP<size_t>;
+  typename signalgp_t::event_lib_t event_lib;
+  signalgp_t hardware(event_lib);
+  hardware.SetActiveThreadLimit(8);
+  hardware.SetThreadCapacity(16);
+  hardware.SetProgram({10, 20, 30, 40, 50, 60, 70, 80});
+  hardware.SpawnThreads(0, 12);
+  hardware.SingleProcess();
+  REQUIRE(hardware.GetActiveThreadIDs().size() == 8);
+  hardware.SetThreadCapacity(4);
+  REQUIRE(hardware.ValidateThreadState());
+  REQUIRE(hardware.GetActiveThreadIDs().size() <= 4);
+  for (size_t id : hardware.GetActiveThreadIDs()) {
+    REQUIRE(id < 4);
+    REQUIRE(hardware.GetThread(id).IsRunning());
+  }
+}
+
+TEST_CASE("SignalGP - ThreadPriorityHeap", "[general]") {
+  emp::Random random(4);
+
+  // Random pushes/removes/updates should agree with brute force.
+  sgp::ThreadMaxPriorityHeap max_heap;
+  sgp::ThreadMinPriorityHeap min_heap;
+  std::unordered_map<size_t, double> priorities;
+  for (size_t i = 0; i < 5000; ++i) {
+    const size_t id = (size_t)random.GetUInt(40);
+    const double priority = (double)random.GetUInt(8); // Lots of ties.
+    const double op = random.GetDouble();
+    if (op < 0.4) {
+      if (!emp::Has(priorities, id)) {
+        max_heap.Push(id, priority);
+        min_heap.Push(id, priority);
+        priorities[id] = priority;
+      }
+    } else if (op < 0.7) {
+      max_heap.Remove(id);
+      min_heap.Remove(id);
+      priorities.erase(id);
+    } else if (op < 0.95) {
+      if (emp::Has(priorities, id)) {
+        max_heap.Update(id, priority);
+        min_heap.Update(id, priority);
+        priorities[id] = priority;
+      }
+    } else if (max_heap.size()) {
+      priorities.erase(max_heap.Top());
+      min_heap.Remove(max_heap.Top());
+      max_heap.Pop();
+    }
+    REQUIRE(max_heap.size() == priorities.size());
+    REQUIRE(min_heap.size() == priorities.size());
+    if (priorities.empty()) continue;
+    // Max heap: highest priority (ties -> largest id). Min heap: lowest priority (ties -> smallest id).
+    std::pair<double, size_t> best_max(priorities.begin()->second, priorities.begin()->first);
+    std::pair<double, size_t> best_min(best_max);
+    for (const auto & entry : priorities) {
+      best_max = std::max(best_max, std::make_pair(entry.second, entry.first));
+      best_min = std::min(best_min, std::make_pair(entry.second, entry.first));
+      REQUIRE(max_heap.GetPriority(entry.first) == entry.second);
+    }
+    REQUIRE(max_heap.Top() == best_max.second);
+    REQUIRE(max_heap.TopPriority() == best_max.first);
+    REQUIRE(min_heap.Top() == best_min.second);
+    REQUIRE(min_heap.TopPriority() == best_min.first);
+  }
+  max_heap.clear();
+  REQUIRE(max_heap.empty());
+  REQUIRE(!max_heap.Has(0));
+
+  // Ties are broken by order key (when given) instead of id.
+  min_heap.clear();
+  min_heap.Push(1, 1.0, 7);
+  min_heap.Push(2, 1.0, 3);
+  min_heap.Push(0, 1.0, 5);
+  REQUIRE(min_heap.Top() == 2);
+  min_heap.Update(2, 2.0);
+  REQUIRE(min_heap.Top() == 0);
+  min_heap.Update(2, 1.0); // Keeps its order key.
+  REQUIRE(min_heap.Top() == 2);
+
+  // Thread activation (w/priorities) on hardware.
+  using signalgp_t = ToySignalGP<size_t>;
+  typename signalgp_t::event_lib_t event_lib;
+  signalgp_t hardware(event_lib);
+  hardware.SetActiveThreadLimit(4);
+  hardware.SetThreadCapacity(8);
+  hardware.SetProgram({1000});
+  auto active_priorities = [&hardware]() {
+    std::multiset<double> active;
+    for (size_t id : hardware.GetActiveThreadIDs()) active.emplace(hardware.GetThread(id).GetPriority());
+    return active;
+  };
+
+  emp::vector<size_t> ids;
+  for (double priority : {1.0, 2.0, 3.0, 4.0}) ids.emplace_back(hardware.SpawnThreadWithID(0, priority).value());
+  hardware.SingleProcess();
+  REQUIRE(hardware.ValidateThreadState());
+  REQUIRE(active_priorities() == std::multiset<double>({1.0, 2.0, 3.0, 4.0}));
+
+  // Higher priority pending threads replace the lowest priority active threads.
+  for (double priority : {0.5, 5.0, 2.5}) hardware.SpawnThreadWithID(0, priority);
+  hardware.SingleProcess();
+  REQUIRE(hardware.ValidateThreadState());
+  REQUIRE(active_priorities() == std::multiset<double>({2.5, 3.0, 4.0, 5.0}));
+  REQUIRE(hardware.GetThreadExecOrder().size() == 4);
+
+  // Priority changes are respected.
+  hardware.SetThreadPriority(ids[3], 0.1); // 4.0 => 0.1
+  hardware.SpawnThreadWithID(0, 0.2);
+  hardware.SingleProcess();
+  REQUIRE(hardware.ValidateThreadState());
+  REQUIRE(active_priorities() == std::multiset<double>({0.2, 2.5, 3.0, 5.0}));
+  REQUIRE(hardware.GetThread(ids[3]).IsDead());
+  hardware.GetThread(ids[2]).SetPriority(10.0); // 3.0 => 10.0 (behind the hardware's back)
+  hardware.SpawnThreadWithID(0, 2.6);
+  hardware.SpawnThreadWithID(0, 2.7);
+  hardware.SingleProcess();
+  REQUIRE(hardware.ValidateThreadState());
+  REQUIRE(active_priorities() == std::multiset<double>({2.6, 2.7, 5.0, 10.0}));
+
+  // Once thread space is full, new threads commandeer the lowest-priority pending thread.
+  while (hardware.GetNumUnusedThreads()) hardware.SpawnThreadWithID(0, 1.0 + (double)hardware.GetNumUnusedThreads());
+  hardware.GetThread(hardware.GetPendingThreadIDs().back()).SetPriority(0.0);
+  const size_t lowest_pending = hardware.GetPendingThreadIDs().back();
+  REQUIRE(!hardware.SpawnThreadWithID(0, 0.0));
+  REQUIRE(hardware.SpawnThreadWithID(0, 0.5).value() == lowest_pending);
+  REQUIRE(hardware.GetThread(lowest_pending).GetPriority() == 0.5);
+  REQUIRE(hardware.ValidateThreadState());
+  hardware.SingleProcess();
+  REQUIRE(hardware.ValidateThreadState());
+  // Pending priorities were {5, 4, 3, 0.5}.
+  REQUIRE(active_priorities() == std::multiset<double>({4.0, 5.0, 5.0, 10.0}));
+
+  // Among equally low-priority pending threads, new threads displace the one that has been
+  // pending the longest (not the one with the smallest id).
+  hardware.Reset();
+  hardware.SetActiveThreadLimit(1);
+  hardware.SetThreadCapacity(3);
+  hardware.SetProgram({1000});
+  const size_t top_id = hardware.SpawnThreadWithID(0, 5.0).value();
+  hardware.SingleProcess();
+  // Deny two low-priority threads so that their ids are reused in reverse order.
+  hardware.SpawnThreadWithID(0, 1.0);
+  hardware.SpawnThreadWithID(0, 1.0);
+  hardware.SingleProcess();
+  REQUIRE(hardware.GetActiveThreadIDs().size() == 1);
+  REQUIRE(hardware.GetActiveThreadIDs()[0] == top_id);
+  const size_t first_pending = hardware.SpawnThreadWithID(0, 1.0).value();
+  const size_t second_pending = hardware.SpawnThreadWithID(0, 1.0).value();
+  REQUIRE(first_pending > second_pending);
+  REQUIRE(hardware.SpawnThreadWithID(0, 2.0).value() == first_pending);
+  REQUIRE(hardware.SpawnThreadWithID(0, 3.0).value() == second_pending);
+  REQUIRE(hardware.ValidateThreadState());
+  // Displaced threads keep their place in the pending queue.
+  REQUIRE(hardware.GetPendingThreadIDs() == std::deque<size_t>({first_pending, second_pending}));
+  REQUIRE(hardware.GetThread(first_pending).GetPriority() == 2.0);
+  REQUIRE(hardware.GetThread(second_pending).GetPriority() == 3.0);
+}
+
+TEST_CASE("SignalGP - Match cache", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using tag_t = emp::BitSet<TAG_WIDTH>;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, tag_t, int, matchbin_t>;
+  using inst_lib_t = typename signalgp_t::inst_lib_t;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using event_lib_t = typename signalgp_t::event_lib_t;
+  using program_t = typename signalgp_t::program_t;
+
+  REQUIRE(sgp::IsDeterministicMatchBin<matchbin_t>::value);
+  REQUIRE(!sgp::IsDeterministicMatchBin<int>::value);
+
+  inst_lib_t inst_lib;
+  event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("SetRegulator", sgp::inst_impl::Inst_SetRegulator<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("SenseRegulator", sgp::inst_impl::Inst_SenseRegulator<signalgp_t, inst_t>, "");
+
+  emp::Random random(5);
+  emp::vector<tag_t> module_tags;
+  for (size_t i = 0; i < 8; ++i) module_tags.emplace_back(random);
+  program_t program;
+  for (const tag_t & tag : module_tags) {
+    program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tag});
+    program.PushInst(inst_lib, "Nop", {0, 0, 0});
+  }
+
+  signalgp_t hardware(random, inst_lib, event_lib);
+  signalgp_t reference(random, inst_lib, event_lib);
+  REQUIRE(hardware.IsMatchCaching());
+  reference.SetMatchCaching(false);
+  hardware.SetProgram(program);
+  reference.SetProgram(program);
+
+  // Repeated lookups hit the cache and agree with uncached lookups.
+  emp::vector<tag_t> queries;
+  for (size_t i = 0; i < 4; ++i) queries.emplace_back(random);
+  for (size_t rep = 0; rep < 10; ++rep) {
+    for (const tag_t & query : queries) {
+      REQUIRE(hardware.FindModuleMatch(query, 1) == reference.FindModuleMatch(query, 1));
+      REQUIRE(hardware.FindModuleMatch(query, 3) == reference.FindModuleMatch(query, 3));
+      REQUIRE(hardware.FindModuleMatchRaw(query, 1) == reference.FindModuleMatchRaw(query, 1));
+    }
+  }
+  REQUIRE(hardware.GetMatchCache().GetMisses() == 8);
+  REQUIRE(hardware.GetMatchCache().GetHits() == 72);
+  REQUIRE(hardware.GetRawMatchCache().GetMisses() == 4);
+  REQUIRE(reference.GetMatchCache().GetMisses() == 0);
+
+  // Regulator changes invalidate cached matches (but raw matches are unaffected)...
+  const size_t best = hardware.FindModuleMatch(queries[0], 1)[0];
+  hardware.SetModuleRegulator(best, 100.0); // (+) values down regulate
+  reference.SetModuleRegulator(best, 100.0);
+  REQUIRE(hardware.GetMatchCache().GetSize() == 0);
+  REQUIRE(hardware.GetRawMatchCache().GetSize() == 4);
+  REQUIRE(hardware.FindModuleMatch(queries[0], 1) == reference.FindModuleMatch(queries[0], 1));
+  REQUIRE(hardware.FindModuleMatch(queries[0], 1)[0] != best);
+  REQUIRE(hardware.ViewModuleRegulator(best) == 100.0);
+  // ...but setting a regulator to its current value doesn't.
+  const size_t cached = hardware.GetMatchCache().GetSize();
+  hardware.SetModuleRegulator(best, 100.0);
+  hardware.AdjModuleRegulator(best, 0.0);
+  REQUIRE(hardware.GetMatchCache().GetSize() == cached);
+  // Decaying regulators invalidates matches once the regulator resets.
+  hardware.DecayModuleRegulators(5);
+  reference.DecayModuleRegulators(5);
+  REQUIRE(hardware.GetMatchCache().GetSize() == 0);
+  REQUIRE(hardware.FindModuleMatch(queries[0], 1)[0] == best);
+  REQUIRE(reference.FindModuleMatch(queries[0], 1)[0] == best);
+
+  // Regulator instructions go through the hardware (and its caches).
+  program_t reg_program;
+  reg_program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {module_tags[0]});
+  reg_program.PushInst(inst_lib, "SetMem", {0, 7, 0});
+  reg_program.PushInst(inst_lib, "SetRegulator", {0, 0, 0}, {module_tags[3]});
+  reg_program.PushInst(inst_lib, "SenseRegulator", {1, 0, 0}, {module_tags[3]});
+  for (size_t i = 1; i < program.GetSize(); ++i) reg_program.PushInst(program[i]);
+  hardware.SetProgram(reg_program);
+  hardware.SpawnThreadWithID(0);
+  for (size_t i = 0; i < 3; ++i) hardware.SingleProcess();
+  REQUIRE(hardware.ViewModuleRegulator(3) == 7.0);
+  const size_t thread_id = *hardware.GetActiveThreadIDs().begin();
+  REQUIRE(hardware.GetThread(thread_id).GetExecState().GetTopCallState().GetMemory().AccessWorking(1) == 7.0);
+
+  // Loading a new program invalidates everything.
+  hardware.SetProgram(program);
+  REQUIRE(hardware.GetMatchCache().GetSize() == 0);
+  REQUIRE(hardware.GetRawMatchCache().GetSize() == 0);
+  REQUIRE(hardware.ViewModuleRegulator(3) == 0.0);
+}
+
+/// Check that HammingMatchBin matches like the equivalent emp::MatchBin.
+/// Matches are compared by score since modules with equal scores may be returned in either order.
+template<size_t W, typename THRESH_RATIO=std::ratio<-1,1>>
+void CheckHammingMatchBin(emp::Random & random, size_t num_modules) {
+  using tag_t = emp::BitSet<W>;
+  using regulator_t = emp::AdditiveCountdownRegulator<>;
+  using matchbin_t = sgp::HammingMatchBin<W, size_t, regulator_t, THRESH_RATIO>;
+  using reference_t = emp::MatchBin<size_t, emp::HammingMetric<W>, emp::RankedSelector<THRESH_RATIO>, regulator_t>;
+  matchbin_t matchbin(random);
+  reference_t reference(random);
+  emp::vector<tag_t> tags;
+  for (size_t i = 0; i < num_modules; ++i) {
+    tags.emplace_back(random);
+    REQUIRE(matchbin.Set(i, tags.back(), i) == i);
+    reference.Set(i, tags.back(), i);
+  }
+  REQUIRE(matchbin.Size() == num_modules);
+  for (size_t i = 0; i < num_modules; i += 3) {
+    const double value = random.GetDouble(-0.5, 0.5);
+    matchbin.SetRegulator(i, value);
+    reference.SetRegulator(i, value);
+    REQUIRE(matchbin.ViewRegulator(i) == value);
+  }
+  emp::HammingMetric<W> metric;
+  for (size_t q = 0; q < 50; ++q) {
+    const tag_t query(random);
+    for (size_t n : {(size_t)1, (size_t)3, num_modules / 2, num_modules + 1}) {
+      const auto matches = matchbin.Match(query, n);
+      const auto ref_matches = reference.Match(query, n);
+      REQUIRE(matches.size() == ref_matches.size());
+      for (size_t i = 0; i < matches.size(); ++i) {
+        REQUIRE(reference.ViewRegulator(matches[i]) == matchbin.ViewRegulator(matches[i]));
+        regulator_t regulator;
+        regulator.Set(matchbin.ViewRegulator(matches[i]));
+        regulator_t ref_regulator;
+        ref_regulator.Set(reference.ViewRegulator(ref_matches[i]));
+        REQUIRE(regulator(metric(query, tags[matches[i]])) == ref_regulator(metric(query, tags[ref_matches[i]])));
+      }
+      const auto raw_matches = matchbin.MatchRaw(query, n);
+      const auto ref_raw_matches = reference.MatchRaw(query, n);
+      REQUIRE(raw_matches.size() == ref_raw_matches.size());
+      for (size_t i = 0; i < raw_matches.size(); ++i) {
+        REQUIRE(metric(query, tags[raw_matches[i]]) == metric(query, tags[ref_raw_matches[i]]));
+      }
+    }
+    // A module always matches its own tag best.
+    const size_t target = random.GetUInt(num_modules);
+    REQUIRE(metric(tags[target], tags[matchbin.MatchRaw(tags[target], 1)[0]]) == 0.0);
+  }
+}
+
+TEST_CASE("SignalGP - HammingMatchBin", "[general]") {
+  emp::Random random(3);
+  CheckHammingMatchBin<16>(random, 8);
+  CheckHammingMatchBin<100>(random, 70);
+  CheckHammingMatchBin<128>(random, 64);
+  CheckHammingMatchBin<256>(random, 150);
+  CheckHammingMatchBin<128, std::ratio<1,2>>(random, 130); // With a match threshold.
+
+  // Clearing/reusing a matchbin; regulator decay.
+  sgp::HammingMatchBin<128> matchbin(random);
+  REQUIRE(sgp::IsDeterministicMatchBin<sgp::HammingMatchBin<128>>::value);
+  const emp::BitSet<128> tag_a(random);
+  const emp::BitSet<128> tag_b(random);
+  REQUIRE(matchbin.Match(tag_a, 1).size() == 0);
+  matchbin.Set(0, tag_a, 5);
+  matchbin.Set(1, tag_b, 2);
+  REQUIRE(matchbin.Has(5));
+  REQUIRE(!matchbin.Has(0));
+  REQUIRE(matchbin.GetVal(2) == 1);
+  REQUIRE(matchbin.GetTag(5) == tag_a);
+  REQUIRE(matchbin.Match(tag_a, 1) == emp::vector<size_t>{5});
+  matchbin.SetRegulator(5, 10.0);
+  REQUIRE(matchbin.Match(tag_a, 1) == emp::vector<size_t>{2});
+  REQUIRE(matchbin.MatchRaw(tag_a, 1) == emp::vector<size_t>{5});
+  matchbin.DecayRegulators(5);
+  REQUIRE(matchbin.ViewRegulator(5) == 0.0);
+  REQUIRE(matchbin.Match(tag_a, 1) == emp::vector<size_t>{5});
+  matchbin.Clear();
+  REQUIRE(matchbin.Size() == 0);
+  matchbin.Set(0, tag_b, 0);
+  REQUIRE(matchbin.Match(tag_a, 2) == emp::vector<size_t>{0});
+
+  // Works as the matchbin of LinearProgramSignalGP and LinearFunctionsProgramSignalGP.
+  constexpr size_t TAG_WIDTH = 128;
+  using tag_t = emp::BitSet<TAG_WIDTH>;
+  using matchbin_t = sgp::HammingMatchBin<TAG_WIDTH>;
+  using lp_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, tag_t, int, matchbin_t>;
+  using lfp_hw_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, tag_t, int, matchbin_t>;
+  emp::HammingMetric<TAG_WIDTH> metric;
+  {
+    using inst_t = typename lp_hw_t::inst_t;
+    using inst_prop_t = typename lp_hw_t::InstProperty;
+    typename lp_hw_t::inst_lib_t inst_lib;
+    typename lp_hw_t::event_lib_t event_lib;
+    inst_lib.AddInst("ModuleDef", [](lp_hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+    inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<lp_hw_t, inst_t>, "");
+    emp::vector<tag_t> module_tags;
+    typename lp_hw_t::program_t program;
+    for (size_t i = 0; i < 80; ++i) {
+      module_tags.emplace_back(random);
+      program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {module_tags.back()});
+      program.PushInst(inst_lib, "Nop", {0, 0, 0});
+    }
+    lp_hw_t hw(random, inst_lib, event_lib);
+    hw.SetProgram(program);
+    REQUIRE(hw.GetNumModules() == 80);
+    for (size_t i = 0; i < module_tags.size(); ++i) REQUIRE(hw.FindModuleMatch(module_tags[i], 1)[0] == i);
+    const tag_t query(random);
+    const auto matches = hw.FindModuleMatch(query, 4);
+    REQUIRE(matches.size() == 4);
+    for (size_t i = 1; i < matches.size(); ++i) {
+      REQUIRE(metric(query, module_tags[matches[i - 1]]) <= metric(query, module_tags[matches[i]]));
+    }
+    hw.SetModuleRegulator(matches[0], 2.0);
+    REQUIRE(hw.FindModuleMatch(query, 1)[0] == matches[1]);
+  }
+  {
+    using inst_t = typename lfp_hw_t::inst_t;
+    typename lfp_hw_t::inst_lib_t inst_lib;
+    typename lfp_hw_t::event_lib_t event_lib;
+    inst_lib.AddInst("Nop", sgp::inst_impl::Inst_Nop<lfp_hw_t, inst_t>, "");
+    auto program = sgp::GenRandLinearFunctionsProgram<lfp_hw_t, TAG_WIDTH>(random, inst_lib, {64, 64}, 1, {1, 4}, 1, 3, {0, 7});
+    lfp_hw_t hw(random, inst_lib, event_lib);
+    hw.SetProgram(program);
+    for (size_t i = 0; i < program.GetSize(); ++i) {
+      const auto match = hw.FindModuleMatch(program[i].GetTag(), 1);
+      REQUIRE(match.size() == 1);
+      REQUIRE(program[match[0]].GetTag() == program[i].GetTag());
+    }
+    hw.SpawnThreadWithTag(program[10].GetTag());
+    hw.SingleProcess();
+    REQUIRE(hw.GetNumActiveThreads() == 1);
+  }
+}
+
+TEST_CASE("SignalGP - CowMemoryModel", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using simple_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using cow_hw_t = sgp::LinearProgramSignalGP<sgp::CowMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using buffer_t = sgp::CowBuffer;
+  using program_t = typename simple_hw_t::program_t;
+
+  // Copies share memory until written to.
+  buffer_t buffer;
+  REQUIRE(buffer.empty());
+  REQUIRE(buffer.Get(2) == 0.0);
+  REQUIRE(!buffer.Has(2));
+  buffer.Set(2, 4.0);
+  buffer.Access(-1) += 1.0;
+  REQUIRE(buffer.size() == 2);
+  REQUIRE(buffer == buffer_t({{2, 4.0}, {-1, 1.0}}));
+  buffer_t copy(buffer);
+  REQUIRE(buffer.IsShared());
+  REQUIRE(copy == buffer);
+  copy.Access(2) += 1.0;
+  REQUIRE(!buffer.IsShared());
+  REQUIRE(buffer.Get(2) == 4.0);
+  REQUIRE(copy.Get(2) == 5.0);
+  buffer_t merged;
+  merged.Merge(buffer);
+  REQUIRE(merged.IsShared());
+  merged.Merge(copy);
+  REQUIRE(!merged.IsShared());
+  REQUIRE(merged == buffer_t({{2, 5.0}, {-1, 1.0}}));
+  REQUIRE(buffer == buffer_t({{2, 4.0}, {-1, 1.0}}));
+  merged.clear();
+  REQUIRE(merged.empty());
+  REQUIRE(merged.begin() == merged.end());
+
+  // Shared instruction set (added in the same order, so instruction IDs line up).
+  auto add_insts = [](auto & inst_lib, auto * hw) {
+    using hw_t = std::remove_pointer_t<decltype(hw)>;
+    using inst_t = typename hw_t::inst_t;
+    using inst_prop_t = typename hw_t::InstProperty;
+    inst_lib.AddInst("ModuleDef", [](hw_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+    inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<hw_t, inst_t>, "");
+    inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<hw_t, inst_t>, "");
+    inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<hw_t, inst_t>, "");
+    inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<hw_t, inst_t>, "");
+    inst_lib.AddInst("SetMem", sgp::inst_impl::Inst_SetMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("If", sgp::inst_impl::Inst_If<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Countdown", sgp::inst_impl::Inst_Countdown<hw_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<hw_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+    inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<hw_t, inst_t>, "");
+    inst_lib.AddInst("Routine", sgp::inst_impl::Inst_Routine<hw_t, inst_t>, "");
+    inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<hw_t, inst_t>, "");
+    inst_lib.AddInst("CopyMem", sgp::inst_impl::Inst_CopyMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("SwapMem", sgp::inst_impl::Inst_SwapMem<hw_t, inst_t>, "");
+    inst_lib.AddInst("InputToWorking", sgp::inst_impl::Inst_InputToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToOutput", sgp::inst_impl::Inst_WorkingToOutput<hw_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<hw_t, inst_t>, "");
+    inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("FullWorkingToGlobal", sgp::inst_impl::Inst_FullWorkingToGlobal<hw_t, inst_t>, "");
+    inst_lib.AddInst("FullGlobalToWorking", sgp::inst_impl::Inst_FullGlobalToWorking<hw_t, inst_t>, "");
+    inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<hw_t, inst_t>, "");
+  };
+
+  typename simple_hw_t::inst_lib_t simple_inst_lib;
+  typename simple_hw_t::event_lib_t simple_event_lib;
+  typename cow_hw_t::inst_lib_t cow_inst_lib;
+  typename cow_hw_t::event_lib_t cow_event_lib;
+  add_insts(simple_inst_lib, (simple_hw_t*)nullptr);
+  add_insts(cow_inst_lib, (cow_hw_t*)nullptr);
+
+  emp::Random random(5);
+  emp::Random simple_random(6);
+  emp::Random cow_random(6);
+  simple_hw_t simple_hw(simple_random, simple_inst_lib, simple_event_lib);
+  cow_hw_t cow_hw(cow_random, cow_inst_lib, cow_event_lib);
+
+  auto same_value = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+  auto same_buffer = [&same_value](const auto & simple_buffer, const buffer_t & cow_buffer) {
+    if (simple_buffer.size() != cow_buffer.size()) return false;
+    for (const auto & mem : simple_buffer) {
+      if (!cow_buffer.Has(mem.first) || !same_value(mem.second, cow_buffer.Get(mem.first))) return false;
+    }
+    return true;
+  };
+
+  // Running the same program gives the same results under both memory models.
+  for (size_t i = 0; i < 100; ++i) {
+    program_t program(sgp::GenRandLinearProgram<simple_hw_t, TAG_WIDTH>(random, simple_inst_lib, {1, 64}, 1, 3, {0, 7}));
+    simple_hw.Reset();
+    cow_hw.Reset();
+    simple_hw.SetProgram(program);
+    cow_hw.SetProgram(program);
+    for (size_t step = 0; step < 512; ++step) {
+      if (!simple_hw.GetNumActiveThreads() && !simple_hw.GetNumPendingThreads()) simple_hw.SpawnThreadWithID(0);
+      if (!cow_hw.GetNumActiveThreads() && !cow_hw.GetNumPendingThreads()) cow_hw.SpawnThreadWithID(0);
+      simple_hw.SingleProcess();
+      cow_hw.SingleProcess();
+    }
+    REQUIRE(simple_hw.GetNumActiveThreads() == cow_hw.GetNumActiveThreads());
+    REQUIRE(same_buffer(simple_hw.GetMemoryModel().GetGlobalBuffer(), cow_hw.GetMemoryModel().GetGlobalBuffer()));
+    for (size_t thread_id : simple_hw.GetActiveThreadIDs()) {
+      REQUIRE(cow_hw.GetActiveThreadIDs().Has(thread_id));
+      auto & simple_stack = simple_hw.GetThread(thread_id).GetExecState().GetCallStack();
+      auto & cow_stack = cow_hw.GetThread(thread_id).GetExecState().GetCallStack();
+      REQUIRE(simple_stack.size() == cow_stack.size());
+      for (size_t c = 0; c < simple_stack.size(); ++c) {
+        auto & simple_mem = simple_stack[c].GetMemory();
+        auto & cow_mem = cow_stack[c].GetMemory();
+        REQUIRE(same_buffer(simple_mem.working_mem, cow_mem.working_mem));
+        REQUIRE(same_buffer(simple_mem.input_mem, cow_mem.input_mem));
+        REQUIRE(same_buffer(simple_mem.output_mem, cow_mem.output_mem));
+      }
+    }
+  }
+
+  // Calls share the caller's working memory with the callee's input memory; returns copy output
+  // memory back into (the caller's own copy of) working memory.
+  {
+    program_t program;
+    emp::BitSet<TAG_WIDTH> tag_0;
+    emp::BitSet<TAG_WIDTH> tag_1;
+    tag_1.SetUInt(0, 0xFFFF);
+    program.PushInst(cow_inst_lib, "ModuleDef", {0, 0, 0}, {tag_0});
+    program.PushInst(cow_inst_lib, "SetMem", {0, 5, 0});
+    program.PushInst(cow_inst_lib, "SetMem", {1, 6, 0});
+    program.PushInst(cow_inst_lib, "Call", {0, 0, 0}, {tag_1});
+    program.PushInst(cow_inst_lib, "ModuleDef", {0, 0, 0}, {tag_1});
+    program.PushInst(cow_inst_lib, "InputToWorking", {0, 2, 0});
+    program.PushInst(cow_inst_lib, "WorkingToOutput", {2, 3, 0});
+    cow_hw.Reset();
+    cow_hw.SetProgram(program);
+    auto spawned = cow_hw.SpawnThreadWithID(0);
+    REQUIRE((bool)spawned);
+    auto & call_stack = cow_hw.GetThread(spawned.value()).GetExecState().GetCallStack();
+    for (size_t i = 0; i < 3; ++i) cow_hw.SingleProcess();
+    REQUIRE(call_stack.size() == 2);
+    REQUIRE(call_stack[1].GetMemory().input_mem.IsShared());
+    REQUIRE(call_stack[1].GetMemory().input_mem == call_stack[0].GetMemory().working_mem);
+    cow_hw.SingleProcess();
+    // InputToWorking only reads input memory, so it stays shared.
+    REQUIRE(call_stack[1].GetMemory().input_mem.IsShared());
+    REQUIRE(call_stack[1].GetMemory().input_mem == call_stack[0].GetMemory().working_mem);
+    REQUIRE(call_stack[1].GetMemory().input_mem == buffer_t({{0, 5.0}, {1, 6.0}}));
+    REQUIRE(call_stack[1].GetMemory().working_mem == buffer_t({{2, 5.0}}));
+    cow_hw.SingleProcess();
+    cow_hw.SingleProcess(); // Return from call.
+    REQUIRE(call_stack.size() == 1);
+    REQUIRE(!call_stack[0].GetMemory().working_mem.IsShared());
+    REQUIRE(call_stack[0].GetMemory().working_mem == buffer_t({{0, 5.0}, {1, 6.0}, {3, 5.0}}));
+  }
+}
+
+TEST_CASE("SignalGP - FrameStack", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using call_state_t = typename signalgp_t::exec_state_t::call_state_t;
+
+  // Popped frames are recycled (and keep their flow stack capacity).
+  sgp::lsgp_utils::FrameStack<call_state_t> frames;
+  REQUIRE(frames.empty());
+  frames.emplace_back(sgp::SimpleMemoryModel::memory_state_t(), false);
+  frames.emplace_back(sgp::SimpleMemoryModel::memory_state_t({{1, 2.0}}), true);
+  REQUIRE(frames.size() == 2);
+  REQUIRE(frames.back().IsCircular());
+  REQUIRE(frames[1].GetMemory().GetWorking(1) == 2.0);
+  for (size_t i = 0; i < 10; ++i) frames.back().GetFlowStack().emplace_back(sgp::lsgp_utils::FlowType::BASIC);
+  const size_t flow_capacity = frames.back().GetFlowStack().capacity();
+  frames.pop_back();
+  REQUIRE(frames.size() == 1);
+  REQUIRE(frames.capacity() == 2);
+  frames.emplace_back(sgp::SimpleMemoryModel::memory_state_t(), false);
+  REQUIRE(frames.capacity() == 2);
+  REQUIRE(!frames.back().IsCircular());
+  REQUIRE(frames.back().GetFlowStack().empty());
+  REQUIRE(frames.back().GetFlowStack().capacity() == flow_capacity);
+  REQUIRE(frames.back().GetMemory().GetWorkingMemory().empty());
+  REQUIRE(std::distance(frames.begin(), frames.end()) == 2);
+  REQUIRE(std::distance(frames.rbegin(), frames.rend()) == 2);
+  frames.clear();
+  REQUIRE(frames.empty());
+  REQUIRE(frames.capacity() == 2);
+
+  // Call stacks keep their capacity across thread reuse and hardware resets.
+  typename signalgp_t::inst_lib_t inst_lib;
+  typename signalgp_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+  emp::Random random(1);
+  emp::BitSet<TAG_WIDTH> tag;
+  typename signalgp_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tag});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "Call", {0, 0, 0}, {tag});
+  signalgp_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  hw.SetThreadCapacity(1);
+  for (size_t rep = 0; rep < 3; ++rep) {
+    auto spawned = hw.SpawnThreadWithID(0);
+    REQUIRE(spawned.value() == 0);
+    auto & call_stack = hw.GetThread(0).GetExecState().GetCallStack();
+    for (size_t i = 0; i < 2 * 16; ++i) hw.SingleProcess();
+    REQUIRE(call_stack.size() == 17);
+    REQUIRE(call_stack.capacity() == (rep ? 256 : 17));
+    REQUIRE(call_stack.back().GetMemory().GetInput(0) == 1.0); // Recycled frames start with fresh memory.
+    while (hw.GetNumActiveThreads()) hw.SingleProcess(); // Recurse to max call depth, then unwind.
+    REQUIRE(call_stack.empty());
+    REQUIRE(call_stack.capacity() == 256);
+    if (rep == 1) hw.ResetThreads();
+  }
+
+  // Recycled frames reset their memory in place (buffers keep their storage).
+  typename signalgp_t::program_t flat_program;
+  flat_program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tag});
+  for (int i = 0; i < 64; ++i) flat_program.PushInst(inst_lib, "Inc", {i, 0, 0});
+  signalgp_t flat_hw(random, inst_lib, event_lib);
+  flat_hw.SetProgram(flat_program);
+  flat_hw.SetThreadCapacity(1);
+  const sgp::SimpleMemoryModel::mem_buffer_t * working_mem = nullptr;
+  size_t bucket_count = 0;
+  for (size_t rep = 0; rep < 3; ++rep) {
+    REQUIRE(flat_hw.SpawnThreadWithID(0).value() == 0);
+    auto & mem_state = flat_hw.GetThread(0).GetExecState().GetTopCallState().GetMemory();
+    REQUIRE(mem_state.GetWorkingMemory().empty());
+    if (rep) {
+      REQUIRE(&mem_state.GetWorkingMemory() == working_mem);
+      REQUIRE(mem_state.GetWorkingMemory().bucket_count() == bucket_count);
+    }
+    for (size_t i = 0; i < 64; ++i) flat_hw.SingleProcess();
+    REQUIRE(mem_state.GetWorkingMemory().size() == 64);
+    working_mem = &mem_state.GetWorkingMemory();
+    bucket_count = mem_state.GetWorkingMemory().bucket_count();
+    while (flat_hw.GetNumActiveThreads()) flat_hw.SingleProcess();
+    REQUIRE(mem_state.GetWorkingMemory().empty()); // Emptied when popped.
+    REQUIRE(mem_state.GetWorkingMemory().bucket_count() == bucket_count);
+  }
+
+  // Memory models without ResetMemoryState still work: recycled frames get CreateMemoryState().
+  struct LegacyMemoryModel {
+    using memory_state_t = sgp::SimpleMemoryModel::memory_state_t;
+    sgp::SimpleMemoryModel model;
+    memory_state_t CreateMemoryState() { return model.CreateMemoryState(); }
+    void Reset() { model.Reset(); }
+    void OnModuleCall(memory_state_t & caller_mem, memory_state_t & callee_mem) { model.OnModuleCall(caller_mem, callee_mem); }
+    void OnModuleReturn(memory_state_t & returning_mem, memory_state_t & caller_mem) { model.OnModuleReturn(returning_mem, caller_mem); }
+    void PrintMemoryState(const memory_state_t & state, std::ostream & os=std::cout) const { model.PrintMemoryState(state, os); }
+  };
+  static_assert(!sgp::lsgp_utils::internal::HasResetMemoryState<LegacyMemoryModel, LegacyMemoryModel::memory_state_t>::value);
+  static_assert(sgp::lsgp_utils::internal::HasResetMemoryState<sgp::SimpleMemoryModel, sgp::SimpleMemoryModel::memory_state_t>::value);
+  using legacy_hw_t = sgp::LinearProgramSignalGP<LegacyMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using legacy_inst_t = typename legacy_hw_t::inst_t;
+  typename legacy_hw_t::inst_lib_t legacy_inst_lib;
+  typename legacy_hw_t::event_lib_t legacy_event_lib;
+  legacy_inst_lib.AddInst("ModuleDef", [](legacy_hw_t & hw, const legacy_inst_t & inst) { ; }, "Module definition", {legacy_hw_t::InstProperty::MODULE});
+  legacy_inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<legacy_hw_t, legacy_inst_t>, "");
+  legacy_hw_t legacy_hw(random, legacy_inst_lib, legacy_event_lib);
+  legacy_hw.SetProgram(flat_program);
+  legacy_hw.SetThreadCapacity(1);
+  for (size_t rep = 0; rep < 3; ++rep) {
+    REQUIRE(legacy_hw.SpawnThreadWithID(0).value() == 0);
+    auto & mem_state = legacy_hw.GetThread(0).GetExecState().GetTopCallState().GetMemory();
+    REQUIRE(mem_state.GetWorkingMemory().empty());
+    for (size_t i = 0; i < 64; ++i) legacy_hw.SingleProcess();
+    REQUIRE(mem_state.GetWorkingMemory().size() == 64);
+    while (legacy_hw.GetNumActiveThreads()) legacy_hw.SingleProcess();
+    REQUIRE(mem_state.GetWorkingMemory().empty()); // Replaced when popped.
+  }
+}
+
+TEST_CASE("SignalGP - Thread quantum", "[general]") {
+  // Toy SignalGP: threads count down, then die.
+  {
+    using signalgp_t = ToySignalGP<>;
+    typename signalgp_t::event_lib_t event_lib;
+    signalgp_t hw(event_lib);
+    REQUIRE(hw.GetThreadQuantum() == 1);
+    hw.SetThreadQuantum(4);
+    hw.SetProgram({10, 2});
+    const size_t long_thread = hw.SpawnThreadWithID(0).value();
+    const size_t short_thread = hw.SpawnThreadWithID(1).value();
+    hw.SingleProcess();
+    REQUIRE(hw.GetThread(long_thread).GetExecState().value == 6);
+    // The short thread stopped early when it died (and got cleaned up).
+    REQUIRE(!hw.GetActiveThreadIDs().Has(short_thread));
+    REQUIRE(hw.GetNumActiveThreads() == 1);
+    hw.SingleProcess();
+    REQUIRE(hw.GetThread(long_thread).GetExecState().value == 2);
+    hw.SingleProcess();
+    REQUIRE(hw.GetNumActiveThreads() == 0);
+  }
+
+  // A single-threaded program does the same thing with a quantum of N in K SingleProcess steps
+  // as it does with a quantum of 1 in N*K steps.
+  constexpr size_t TAG_WIDTH = 16;
+  constexpr size_t QUANTUM = 8;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  typename signalgp_t::inst_lib_t inst_lib;
+  typename signalgp_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("TestLess", sgp::inst_impl::Inst_TestLess<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Terminate", sgp::inst_impl::Inst_Terminate<signalgp_t, inst_t>, "");
+
+  emp::Random random(7);
+  signalgp_t hw_1(random, inst_lib, event_lib);
+  signalgp_t hw_n(random, inst_lib, event_lib);
+  hw_n.SetThreadQuantum(QUANTUM);
+  for (size_t i = 0; i < 100; ++i) {
+    auto program = sgp::GenRandLinearProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {1, 64}, 1, 3, {0, 7});
+    hw_1.Reset();
+    hw_n.Reset();
+    hw_1.SetProgram(program);
+    hw_n.SetProgram(program);
+    hw_1.SpawnThreadWithID(0);
+    hw_n.SpawnThreadWithID(0);
+    for (size_t step = 0; step < 64; ++step) {
+      for (size_t q = 0; q < QUANTUM; ++q) hw_1.SingleProcess();
+      hw_n.SingleProcess();
+      REQUIRE(hw_1.GetNumActiveThreads() == hw_n.GetNumActiveThreads());
+      REQUIRE(hw_1.GetMemoryModel().GetGlobalBuffer() == hw_n.GetMemoryModel().GetGlobalBuffer());
+    }
+  }
+}
+
+/// Hardware that's missing most of what SignalGPBase requires.
+struct IncompleteHardware {
+  using thread_t = typename ToySignalGP<>::thread_t;
+  void ResetImpl() { ; }
+  void InitThread(thread_t &, size_t) { ; }
+};
+
+TEST_CASE("SignalGPBase - Static interface", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using toy_hw_t = ToySignalGP<>;
+  using lp_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using lfp_hw_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using thread_t = typename toy_hw_t::thread_t;
+
+  // No virtual functions (and so, no vtable pointer).
+  REQUIRE(!std::is_polymorphic<toy_hw_t>::value);
+  REQUIRE(!std::is_polymorphic<lp_hw_t>::value);
+  REQUIRE(!std::is_polymorphic<lfp_hw_t>::value);
+
+  REQUIRE(sgp::internal::HasResetImpl<toy_hw_t>::value);
+  REQUIRE(sgp::internal::HasSingleExecutionStep<toy_hw_t, thread_t>::value);
+  REQUIRE(sgp::internal::HasFindModuleMatch<toy_hw_t, size_t, size_t>::value);
+  REQUIRE(sgp::internal::HasInitThread<toy_hw_t, thread_t, size_t>::value);
+  REQUIRE(sgp::internal::HasResetImpl<lp_hw_t>::value);
+  REQUIRE(sgp::internal::HasSingleExecutionStep<lp_hw_t, typename lp_hw_t::thread_t>::value);
+  REQUIRE(sgp::internal::HasFindModuleMatch<lfp_hw_t, typename lfp_hw_t::tag_t, size_t>::value);
+  REQUIRE(sgp::internal::HasExecStateReset<typename lfp_hw_t::exec_state_t>::value);
+
+  REQUIRE(sgp::internal::HasResetImpl<IncompleteHardware>::value);
+  REQUIRE(sgp::internal::HasInitThread<IncompleteHardware, thread_t, size_t>::value);
+  REQUIRE(!sgp::internal::HasSingleExecutionStep<IncompleteHardware, thread_t>::value);
+  REQUIRE(!sgp::internal::HasFindModuleMatch<IncompleteHardware, size_t, size_t>::value);
+  REQUIRE(!sgp::internal::HasExecStateReset<int>::value);
+}
+
+/// Flow policy for the FlowHandler tests: closing a while loop exits it (like closing a BASIC block).
+struct ExitLoopsFlowPolicy : sgp::lsgp_utils::DefaultFlowPolicy {
+  template<typename HARDWARE_T, typename EXEC_STATE_T>
+  static void CloseFlow(HARDWARE_T & hw, sgp::lsgp_utils::FlowType type, EXEC_STATE_T & exec_state) {
+    using flow_t = sgp::lsgp_utils::FlowType;
+    DefaultFlowPolicy::CloseFlow(hw, (type == flow_t::WHILE_LOOP) ? flow_t::BASIC : type, exec_state);
+  }
+};
+
+TEST_CASE("SignalGP - FlowHandler overrides", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using exec_state_t = typename signalgp_t::exec_state_t;
+  using flow_t = typename signalgp_t::flow_t;
+  using policy_t = typename signalgp_t::flow_handler_t::policy_t;
+  typename signalgp_t::inst_lib_t inst_lib;
+  typename signalgp_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+  inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+
+  emp::Random random(2);
+  // Module 0: w[1] = 1; while (w[1]) { ++w[0]; }
+  typename signalgp_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {emp::BitSet<TAG_WIDTH>(random)});
+  program.PushInst(inst_lib, "Inc", {1, 0, 0});
+  program.PushInst(inst_lib, "While", {1, 0, 0});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "Close", {0, 0, 0});
+
+  signalgp_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  auto run = [&hw]() {
+    hw.ResetHardwareState();
+    const size_t id = hw.SpawnThreadWithID(0).value();
+    for (size_t i = 0; i < 32; ++i) hw.SingleProcess();
+    if (!hw.GetActiveThreadIDs().Has(id)) return 0.0;
+    return hw.GetThread(id).GetExecState().GetTopCallState().GetMemory().GetWorking(0);
+  };
+
+  // Default policy: loop forever (incrementing w[0] once every three steps).
+  const double default_count = run();
+  REQUIRE(default_count > 1.0);
+
+  // Override WHILE_LOOP's close to exit the loop (like closing a BASIC block).
+  size_t num_closes = 0;
+  hw.SetCloseFlowFun(flow_t::WHILE_LOOP, [&num_closes](signalgp_t & hw, exec_state_t & exec_state) {
+    ++num_closes;
+    policy_t::CloseFlow(hw, flow_t::BASIC, exec_state);
+  });
+  REQUIRE(hw.GetFlowHandler()[flow_t::WHILE_LOOP].close_flow_fun);
+  REQUIRE(!hw.GetFlowHandler()[flow_t::WHILE_LOOP].open_flow_fun);
+  REQUIRE(!hw.GetFlowHandler()[flow_t::BASIC].close_flow_fun);
+  const double override_count = run();
+  REQUIRE(num_closes == 1);
+
+  // Restoring the default.
+  hw.SetCloseFlowFun(flow_t::WHILE_LOOP, nullptr);
+  REQUIRE(run() == default_count);
+  REQUIRE(num_closes == 1);
+  hw.SetCloseFlowFun(flow_t::WHILE_LOOP, [&num_closes](signalgp_t & hw, exec_state_t & exec_state) { ++num_closes; });
+  hw.GetFlowHandler().ResetOverrides();
+  REQUIRE(run() == default_count);
+  REQUIRE(num_closes == 1);
+
+  // Handlers in effect (override or policy) can be fetched, e.g., to wrap the default.
+  REQUIRE(hw.GetOpenFlowFun(flow_t::BASIC));
+  REQUIRE(hw.GetBreakFlowFun(flow_t::CALL));
+  size_t num_wrapped_closes = 0;
+  hw.SetCloseFlowFun(flow_t::WHILE_LOOP, [&num_wrapped_closes, default_close=hw.GetCloseFlowFun(flow_t::WHILE_LOOP)](signalgp_t & hw, exec_state_t & exec_state) {
+    ++num_wrapped_closes;
+    default_close(hw, exec_state);
+  });
+  REQUIRE(run() == default_count);
+  REQUIRE(num_wrapped_closes > 1);
+  hw.GetFlowHandler().ResetOverrides();
+
+  // Hardware can be given another flow policy (with no overrides set).
+  using policy_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t,
+                                                 sgp::DefaultCustomComponent, sgp::NoInstrumentation, void,
+                                                 sgp::InstructionLibrary, ExitLoopsFlowPolicy>;
+  using policy_inst_t = typename policy_hw_t::inst_t;
+  using policy_inst_prop_t = typename policy_hw_t::InstProperty;
+  static_assert(std::is_same<typename policy_hw_t::flow_handler_t::policy_t, ExitLoopsFlowPolicy>::value);
+  typename policy_hw_t::inst_lib_t policy_inst_lib;
+  typename policy_hw_t::event_lib_t policy_event_lib;
+  policy_inst_lib.AddInst("ModuleDef", [](policy_hw_t & hw, const policy_inst_t & inst) { ; }, "Module definition", {policy_inst_prop_t::MODULE});
+  policy_inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<policy_hw_t, policy_inst_t>, "");
+  policy_inst_lib.AddInst("While", sgp::inst_impl::Inst_While<policy_hw_t, policy_inst_t>, "", {policy_inst_prop_t::BLOCK_DEF});
+  policy_inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<policy_hw_t, policy_inst_t>, "", {policy_inst_prop_t::BLOCK_CLOSE});
+  policy_hw_t policy_hw(random, policy_inst_lib, policy_event_lib);
+  policy_hw.SetProgram(program);
+  const size_t policy_id = policy_hw.SpawnThreadWithID(0).value();
+  for (size_t i = 0; i < 32; ++i) policy_hw.SingleProcess();
+  const double policy_count = policy_hw.GetActiveThreadIDs().Has(policy_id)
+                              ? policy_hw.GetThread(policy_id).GetExecState().GetTopCallState().GetMemory().GetWorking(0)
+                              : 0.0;
+  REQUIRE(policy_count == override_count);
+  REQUIRE(policy_count != default_count);
+}
+
+TEST_CASE("ProgramSerialization", "[general]") {
+  constexpr size_t TAG_WIDTH = 20; // Not a multiple of 8 (tags get padded).
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using lp_hw_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using lfp_hw_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+  using lp_program_t = typename lp_hw_t::program_t;
+  using lfp_program_t = typename lfp_hw_t::program_t;
+  using lp_inst_t = typename lp_hw_t::inst_t;
+  using lfp_inst_t = typename lfp_hw_t::inst_t;
+  namespace ser = sgp::serialization;
+
+  emp::Random random(11);
+  const emp::vector<std::string> names = {"Nop", "Inc", "Dec", "Add", "Call"};
+  typename lp_hw_t::inst_lib_t lp_lib;
+  typename lp_hw_t::inst_lib_t lp_lib_reordered;  // Same instructions, different ids.
+  typename lp_hw_t::inst_lib_t lp_lib_missing;    // Missing an instruction.
+  typename lfp_hw_t::inst_lib_t lfp_lib;
+  for (const std::string & name : names) {
+    lp_lib.AddInst(name, [](lp_hw_t & hw, const lp_inst_t & inst) { ; }, "");
+    lfp_lib.AddInst(name, [](lfp_hw_t & hw, const lfp_inst_t & inst) { ; }, "");
+    if (name != "Add") lp_lib_missing.AddInst(name, [](lp_hw_t & hw, const lp_inst_t & inst) { ; }, "");
+  }
+  for (auto it = names.rbegin(); it != names.rend(); ++it) {
+    lp_lib_reordered.AddInst(*it, [](lp_hw_t & hw, const lp_inst_t & inst) { ; }, "");
+  }
+
+  emp::vector<lp_program_t> lp_programs;
+  for (size_t i = 0; i < 50; ++i) {
+    lp_programs.emplace_back(sgp::GenRandLinearProgram<lp_hw_t, TAG_WIDTH>(random, lp_lib, {0, 32}, 2, 3, {-300, 300}));
+  }
+  // Extreme and oddly-sized arguments.
+  lp_programs[0].PushInst(0, {std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 0, -1, 64, 5000});
+  lp_programs[0].PushInst(1);
+
+  // Stream round trip.
+  std::stringstream lp_stream;
+  {
+    ser::ProgramWriter<lp_program_t> writer(lp_stream, lp_lib);
+    for (const lp_program_t & program : lp_programs) REQUIRE(writer.Write(program));
+    REQUIRE(writer.GetNumWritten() == lp_programs.size());
+    REQUIRE(writer.IsGood());
+  }
+  const std::string lp_bytes = lp_stream.str();
+
+  // Programs with instruction ids outside of the writer's library aren't written.
+  {
+    std::stringstream stream;
+    ser::ProgramWriter<lp_program_t> writer(stream, lp_lib);
+    const size_t header_size = stream.str().size();
+    lp_program_t bad_program(lp_programs[1]);
+    bad_program.PushInst(lp_lib.GetSize());
+    REQUIRE(!writer.Write(bad_program));
+    REQUIRE(writer.GetNumWritten() == 0);
+    REQUIRE(stream.str().size() == header_size);
+    REQUIRE(writer.Write(lp_programs[1]));
+    REQUIRE(writer.GetNumWritten() == 1);
+  }
+  {
+    std::istringstream in(lp_bytes);
+    ser::ProgramReader<lp_program_t> reader(in, lp_lib);
+    REQUIRE(reader.IsGood());
+    REQUIRE(reader.GetHeader().version == ser::FORMAT_VERSION);
+    REQUIRE(reader.GetHeader().tag_bits == TAG_WIDTH);
+    REQUIRE(reader.GetHeader().inst_names == names);
+    lp_program_t program;
+    size_t count = 0;
+    while (reader.Read(program)) {
+      REQUIRE(program == lp_programs[count]);
+      ++count;
+    }
+    REQUIRE(reader.IsGood());
+    REQUIRE(count == lp_programs.size());
+  }
+
+  // Instruction ids are remapped by name.
+  {
+    std::istringstream in(lp_bytes);
+    ser::ProgramReader<lp_program_t> reader(in, lp_lib_reordered);
+    lp_program_t program;
+    for (const lp_program_t & original : lp_programs) {
+      REQUIRE(reader.Read(program));
+      REQUIRE(program.GetSize() == original.GetSize());
+      for (size_t i = 0; i < program.GetSize(); ++i) {
+        REQUIRE(lp_lib_reordered.GetName(program[i].GetID()) == lp_lib.GetName(original[i].GetID()));
+        REQUIRE(program[i].GetArgs() == original[i].GetArgs());
+        REQUIRE(program[i].GetTags() == original[i].GetTags());
+      }
+    }
+    REQUIRE(!reader.Read(program));
+    REQUIRE(reader.IsGood());
+  }
+
+  // Errors: unknown instructions, wrong program kind, bad magic, truncated records.
+  {
+    std::istringstream in(lp_bytes);
+    ser::ProgramReader<lp_program_t> reader(in, lp_lib_missing);
+    lp_program_t program;
+    REQUIRE(!reader.IsGood());
+    REQUIRE(!reader.Read(program));
+  }
+  {
+    std::istringstream in(lp_bytes);
+    ser::ProgramReader<lfp_program_t> reader(in, lfp_lib);
+    REQUIRE(!reader.IsGood());
+  }
+  {
+    std::istringstream in("not a program file");
+    ser::ProgramReader<lp_program_t> reader(in, lp_lib);
+    REQUIRE(!reader.IsGood());
+  }
+  {
+    std::istringstream in(lp_bytes.substr(0, lp_bytes.size() - 3));
+    ser::ProgramReader<lp_program_t> reader(in, lp_lib);
+    lp_program_t program;
+    size_t count = 0;
+    while (reader.Read(program)) ++count;
+    REQUIRE(count == lp_programs.size() - 1);
+    REQUIRE(!reader.IsGood());
+  }
+
+  // LinearFunctionsProgram round trip (through a file), and memory-mapped reading.
+  emp::vector<lfp_program_t> lfp_programs;
+  for (size_t i = 0; i < 50; ++i) {
+    lfp_programs.emplace_back(sgp::GenRandLinearFunctionsProgram<lfp_hw_t, TAG_WIDTH>(random, lfp_lib, {1, 4}, 2, {0, 16}, 1, 3, {-7, 7}));
+  }
+  const std::string path = "sgp_serialization_test.sgpb";
+  {
+    std::ofstream out(path, std::ios::binary);
+    ser::ProgramWriter<lfp_program_t> writer(out, lfp_lib);
+    for (const lfp_program_t & program : lfp_programs) REQUIRE(writer.Write(program));
+    lfp_program_t bad_program(lfp_programs[0]);
+    bad_program.PushInst(0, lfp_lib.GetSize());
+    REQUIRE(!writer.Write(bad_program));
+    REQUIRE(writer.GetNumWritten() == lfp_programs.size());
+  }
+  {
+    std::ifstream in(path, std::ios::binary);
+    ser::ProgramReader<lfp_program_t> reader(in, lfp_lib);
+    lfp_program_t program;
+    size_t count = 0;
+    while (reader.Read(program)) REQUIRE(program == lfp_programs[count++]);
+    REQUIRE(reader.IsGood());
+    REQUIRE(count == lfp_programs.size());
+  }
+  {
+    ser::MappedProgramFile<lfp_program_t> file;
+    REQUIRE(file.Open(path, lfp_lib));
+    REQUIRE(file.GetSize() == lfp_programs.size());
+    for (size_t i = 0; i < file.GetSize(); ++i) {
+      const lfp_program_t & original = lfp_programs[i];
+      lfp_program_t program;
+      REQUIRE(file.Decode(i, program));
+      REQUIRE(program == original);
+      // Visit without building the program.
+      size_t num_functions = 0;
+      size_t num_insts = 0;
+      bool match = true;
+      const bool ok = file[i].Visit(
+        [&](const auto & function) {
+          match = match && function.GetFunction() == num_functions
+                        && function.GetTags().ToVector() == original[num_functions].GetTags();
+          ++num_functions;
+        },
+        [&](const auto & inst) {
+          match = match && inst.GetFunction() + 1 == num_functions && inst.GetID() < lfp_lib.GetSize();
+          ++num_insts;
+        });
+      REQUIRE(ok);
+      REQUIRE(match);
+      REQUIRE(num_functions == original.GetSize());
+      REQUIRE(num_insts == original.GetInstCount());
+    }
+    // Decoded instruction views match the program's instructions.
+    size_t checked = 0;
+    REQUIRE(file[0].ForEachInst([&](const auto & inst) {
+      size_t function = inst.GetFunction();
+      size_t pos = checked;
+      for (size_t f = 0; f < function; ++f) pos -= lfp_programs[0][f].GetSize();
+      const auto & expected = lfp_programs[0][function][pos];
+      REQUIRE(inst.GetID() == expected.GetID());
+      REQUIRE(emp::vector<int>(inst.GetArgs().begin(), inst.GetArgs().end()) == expected.GetArgs());
+      REQUIRE(inst.GetTags().ToVector() == expected.GetTags());
+      ++checked;
+    }));
+    REQUIRE(checked == lfp_programs[0].GetInstCount());
+    // Closing forgets the file's header.
+    REQUIRE(file.GetHeader().inst_names == names);
+    file.Close();
+    REQUIRE(!file.IsOpen());
+    REQUIRE(file.GetSize() == 0);
+    REQUIRE(file.GetHeader().inst_names.empty());
+    REQUIRE(file.GetHeader().tag_bits == 0);
+  }
+  {
+    ser::MappedProgramFile<lp_program_t> file;
+    REQUIRE(!file.Open(path, lp_lib));
+    REQUIRE(file.GetError().size());
+  }
+  std::remove(path.c_str());
+}
+
+/// Event that spawns a thread for the module that best matches its tag.
+template<size_t W>
+struct SignalEvent : public sgp::BaseEvent {
+  emp::BitSet<W> tag;
+  SignalEvent(size_t id, const emp::BitSet<W> & _tag) : BaseEvent(id), tag(_tag) { ; }
+};
+
+/// Run hw for the given number of steps (queuing a signal every few steps), and record a summary
+/// of its state after each step.
+template<typename HW_T, size_t W>
+emp::vector<std::string> RunAndRecord(HW_T & hw, size_t num_steps, size_t signal_id,
+                                      const emp::vector<emp::BitSet<W>> & signals) {
+  emp::vector<std::string> trace;
+  for (size_t step = 0; step < num_steps; ++step) {
+    if (step % 5 == 0) hw.QueueEvent(SignalEvent<W>(signal_id, signals[step % signals.size()]));
+    hw.SingleProcess();
+    std::ostringstream os;
+    os << hw.GetNumQueuedEvents() << "|";
+    for (size_t id : hw.GetThreadExecOrder()) os << id << ",";
+    os << "|";
+    for (size_t id : hw.GetPendingThreadIDs()) os << id << ",";
+    os << "|";
+    for (size_t id : hw.GetActiveThreadIDs()) {
+      const auto & exec_state = hw.GetThread(id).GetExecState();
+      os << id << ":" << exec_state.call_stack.size();
+      if (exec_state.call_stack.size()) {
+        auto & call_state = hw.GetThread(id).GetExecState().GetTopCallState();
+        os << "@" << call_state.GetMP() << "." << call_state.GetIP();
+        std::map<int, double> working(call_state.GetMemory().working_mem.begin(), call_state.GetMemory().working_mem.end());
+        for (const auto & entry : working) os << "w" << entry.first << "=" << entry.second;
+      }
+      os << ";";
+    }
+    os << "|";
+    const auto & global = hw.GetMemoryModel().GetGlobalBuffer();
+    std::map<int, double> sorted_global(global.begin(), global.end());
+    for (const auto & entry : sorted_global) os << entry.first << "=" << entry.second << ",";
+    os << "|";
+    for (size_t i = 0; i < hw.GetMatchBin().Size(); ++i) os << hw.GetMatchBin().ViewRegulator(i) << ",";
+    trace.emplace_back(os.str());
+  }
+  return trace;
+}
+
+/// Run hardware for a while, snapshot it, and check that hardware restored from the snapshot
+/// (whether it's the same hardware or other hardware) continues exactly like the original did.
+template<typename HW_T, size_t W>
+void CheckSnapshotRestore(typename HW_T::inst_lib_t & inst_lib, typename HW_T::event_lib_t & event_lib,
+                          size_t signal_id, const emp::vector<typename HW_T::program_t> & programs,
+                          emp::Random & random) {
+  emp::vector<emp::BitSet<W>> signals;
+  for (size_t i = 0; i < 4; ++i) signals.emplace_back(random);
+  HW_T hw(random, inst_lib, event_lib);
+  HW_T other(random, inst_lib, event_lib);
+  other.SetActiveThreadLimit(4); // Different settings get overwritten by Restore.
+  hw.SetThreadQuantum(2);
+  typename HW_T::snapshot_t reused = hw.Snapshot();
+  for (const auto & program : programs) {
+    hw.SetProgram(program);
+    hw.SpawnThreadWithID(0);
+    RunAndRecord(hw, 40, signal_id, signals);
+    hw.QueueEvent(SignalEvent<W>(signal_id, signals[0]));
+    const typename HW_T::snapshot_t snapshot = hw.Snapshot();
+    hw.Snapshot(reused);
+    const auto expected = RunAndRecord(hw, 60, signal_id, signals);
+    // Rewind.
+    hw.Restore(snapshot);
+    REQUIRE(RunAndRecord(hw, 60, signal_id, signals) == expected);
+    // Fork onto other hardware (with some other program loaded).
+    other.Restore(reused);
+    REQUIRE(other.GetProgram() == program);
+    REQUIRE(other.GetThreadQuantum() == 2);
+    REQUIRE(RunAndRecord(other, 60, signal_id, signals) == expected);
+    // Snapshots are unaffected by running restored hardware.
+    other.Restore(snapshot);
+    REQUIRE(RunAndRecord(other, 60, signal_id, signals) == expected);
+  }
+}
+
+TEST_CASE("SignalGP - Snapshot/Restore", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  emp::Random random(5);
+
+  // LinearProgramSignalGP
+  {
+    using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+    using inst_t = typename signalgp_t::inst_t;
+    using inst_prop_t = typename signalgp_t::InstProperty;
+    using event_t = typename signalgp_t::event_t;
+    typename signalgp_t::inst_lib_t inst_lib;
+    typename signalgp_t::event_lib_t event_lib;
+    inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+    inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("If", sgp::inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("While", sgp::inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+    inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("GlobalToWorking", sgp::inst_impl::Inst_GlobalToWorking<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("SetRegulator", sgp::inst_impl::Inst_SetRegulator<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("AdjRegulator", sgp::inst_impl::Inst_AdjRegulator<signalgp_t, inst_t>, "");
+    const size_t signal_id = event_lib.AddEvent("Signal", [](signalgp_t & hw, const event_t & e) {
+      hw.SpawnThreadWithTag(static_cast<const SignalEvent<TAG_WIDTH> &>(e).tag);
+    });
+    emp::vector<typename signalgp_t::program_t> programs;
+    for (size_t i = 0; i < 20; ++i) {
+      programs.emplace_back(sgp::GenRandLinearProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {16, 64}, 1, 3, {0, 7}));
+    }
+    CheckSnapshotRestore<signalgp_t, TAG_WIDTH>(inst_lib, event_lib, signal_id, programs, random);
+  }
+
+  // LinearFunctionsProgramSignalGP
+  {
+    using signalgp_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+    using inst_t = typename signalgp_t::inst_t;
+    using inst_prop_t = typename signalgp_t::InstProperty;
+    using event_t = typename signalgp_t::event_t;
+    typename signalgp_t::inst_lib_t inst_lib;
+    typename signalgp_t::event_lib_t event_lib;
+    inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Dec", sgp::inst_impl::Inst_Dec<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Add", sgp::inst_impl::Inst_Add<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Close", sgp::inst_impl::Inst_Close<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_CLOSE});
+    inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Return", sgp::inst_impl::Inst_Return<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("SetRegulator", sgp::inst_impl::Inst_SetRegulator<signalgp_t, inst_t>, "");
+    inst_lib.AddInst("If", sgp::lfp_inst_impl::Inst_If<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    inst_lib.AddInst("While", sgp::lfp_inst_impl::Inst_While<signalgp_t, inst_t>, "", {inst_prop_t::BLOCK_DEF});
+    const size_t signal_id = event_lib.AddEvent("Signal", [](signalgp_t & hw, const event_t & e) {
+      hw.SpawnThreadWithTag(static_cast<const SignalEvent<TAG_WIDTH> &>(e).tag);
+    });
+    emp::vector<typename signalgp_t::program_t> programs;
+    for (size_t i = 0; i < 20; ++i) {
+      programs.emplace_back(sgp::GenRandLinearFunctionsProgram<signalgp_t, TAG_WIDTH>(random, inst_lib, {1, 4}, 1, {1, 16}, 1, 3, {0, 7}));
+    }
+    CheckSnapshotRestore<signalgp_t, TAG_WIDTH>(inst_lib, event_lib, signal_id, programs, random);
+  }
+}
+
+TEST_CASE("SignalGP - Instrumentation", "[general]") {
+  constexpr size_t TAG_WIDTH = 16;
+  using matchbin_t = emp::MatchBin< size_t,
+                                    emp::HammingMetric<TAG_WIDTH>,
+                                    emp::RankedSelector<>,
+                                    emp::AdditiveCountdownRegulator<>
+                                  >;
+  using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t,
+                                                sgp::DefaultCustomComponent, sgp::ExecutionProfiler>;
+  using inst_t = typename signalgp_t::inst_t;
+  using inst_prop_t = typename signalgp_t::InstProperty;
+  using event_t = typename signalgp_t::event_t;
+  static_assert(signalgp_t::instrumentation_t::ENABLED);
+  static_assert(!sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel>::instrumentation_t::ENABLED);
+  typename signalgp_t::inst_lib_t inst_lib;
+  typename signalgp_t::event_lib_t event_lib;
+  inst_lib.AddInst("ModuleDef", [](signalgp_t & hw, const inst_t & inst) { ; }, "Module definition", {inst_prop_t::MODULE});
+  inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<signalgp_t, inst_t>, "");
+  inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<signalgp_t, inst_t>, "");
+  const size_t signal_id = event_lib.AddEvent("Signal", [](signalgp_t & hw, const event_t & e) {
+    hw.SpawnThreadWithTag(static_cast<const SignalEvent<TAG_WIDTH> &>(e).tag);
+  });
+  const size_t inc_id = inst_lib.GetID("Inc");
+  const size_t call_id = inst_lib.GetID("Call");
+
+  emp::Random random(7);
+  emp::vector<emp::BitSet<TAG_WIDTH>> tags;
+  for (size_t i = 0; i < 3; ++i) tags.emplace_back(random);
+  // Module 0: ++w0; call module 1; ++w0
+  // Module 1: call module 2
+  // Module 2: ++w1
+  typename signalgp_t::program_t program;
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tags[0]});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "Call", {0, 0, 0}, {tags[1]});
+  program.PushInst(inst_lib, "Inc", {0, 0, 0});
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tags[1]});
+  program.PushInst(inst_lib, "Call", {0, 0, 0}, {tags[2]});
+  program.PushInst(inst_lib, "ModuleDef", {0, 0, 0}, {tags[2]});
+  program.PushInst(inst_lib, "Inc", {1, 0, 0});
+
+  signalgp_t hw(random, inst_lib, event_lib);
+  hw.SetProgram(program);
+  const auto & profile = hw.GetInstrumentation();
+  REQUIRE(profile.GetTotalInstCount() == 0);
+  hw.QueueEvent(SignalEvent<TAG_WIDTH>(signal_id, tags[0]));
+  hw.QueueEvent(SignalEvent<TAG_WIDTH>(signal_id, tags[0]));
+  for (size_t i = 0; i < 32 && (hw.GetNumActiveThreads() || hw.GetNumQueuedEvents()); ++i) hw.SingleProcess();
+  REQUIRE(hw.GetNumActiveThreads() == 0);
+
+  REQUIRE(profile.GetEventCount(signal_id) == 2);
+  REQUIRE(profile.GetThreadsSpawned() == 2);
+  REQUIRE(profile.GetThreadsKilled() == 2);
+  REQUIRE(profile.GetModuleSpawns() == emp::vector<size_t>{2});
+  REQUIRE(profile.GetModuleEntries() == emp::vector<size_t>{2, 2, 2});
+  REQUIRE(profile.GetCallDepthHistogram() == emp::vector<size_t>{0, 2, 2, 2});
+  REQUIRE(profile.GetInstCount(inc_id) == 6);
+  REQUIRE(profile.GetInstCount(call_id) == 4);
+  REQUIRE(profile.GetTotalInstCount() == profile.GetInstCount(inc_id) + profile.GetInstCount(call_id)
+                                         + profile.GetInstCount(inst_lib.GetID("ModuleDef")));
+
+  // Killing and displacing threads.
+  hw.SpawnThreadWithID(0);
+  hw.SingleProcess();
+  REQUIRE(hw.KillActiveThread(hw.GetActiveThreadIDs()[0]));
+  REQUIRE(profile.GetThreadsKilled() == 3);
+  hw.SetActiveThreadLimit(1);
+  hw.SetThreadCapacity(1);
+  hw.SpawnThreadWithID(1, 1.0);
+  REQUIRE(hw.SpawnThreadWithID(2, 2.0)); // Displaces the pending thread.
+  REQUIRE(profile.GetThreadsSpawned() == 5);
+  REQUIRE(profile.GetThreadsKilled() == 4);
+  REQUIRE(profile.GetModuleSpawns() == emp::vector<size_t>{3, 1, 1});
+
+  // Instrumentation survives hardware resets (but can be reset itself).
+  hw.Reset();
+  REQUIRE(profile.GetThreadsSpawned() == 5);
+  hw.GetInstrumentation().Reset();
+  REQUIRE(profile.GetTotalInstCount() == 0);
+  REQUIRE(profile.GetThreadsSpawned() == 0);
+  REQUIRE(profile.GetCallDepthHistogram().empty());
+
+  // Report.
+  hw.SetProgram(program);
+  hw.HandleEvent(SignalEvent<TAG_WIDTH>(signal_id, tags[0]));
+  for (size_t i = 0; i < 32 && hw.GetNumActiveThreads() + hw.GetNumPendingThreads(); ++i) hw.SingleProcess();
+  std::ostringstream report;
+  profile.PrintReport(report, inst_lib, event_lib);
+  REQUIRE(report.str().find("\"total_instructions\": " + std::to_string(profile.GetTotalInstCount())) != std::string::npos);
+  REQUIRE(report.str().find("{\"id\": " + std::to_string(inc_id) + ", \"name\": \"Inc\", \"count\": 3}") != std::string::npos);
+  REQUIRE(report.str().find("\"name\": \"Signal\", \"count\": 1}") != std::string::npos);
+  REQUIRE(report.str().find("\"call_depths\": [0, 1, 1, 1]") != std::string::npos);
+  REQUIRE(report.str().find("\"threads\": {\"spawned\": 1, \"killed\": 1}") != std::string::npos);
+
+  // Instrumentation doesn't change execution (LinearFunctionsProgramSignalGP).
+  {
+    using lfp_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t,
+                                                      sgp::DefaultCustomComponent, sgp::ExecutionProfiler>;
+    using plain_lfp_t = sgp::LinearFunctionsProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<TAG_WIDTH>, int, matchbin_t>;
+    typename lfp_t::inst_lib_t lfp_inst_lib;
+    typename lfp_t::event_lib_t lfp_event_lib;
+    typename plain_lfp_t::inst_lib_t plain_inst_lib;
+    typename plain_lfp_t::event_lib_t plain_event_lib;
+    lfp_inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<lfp_t, typename lfp_t::inst_t>, "");
+    lfp_inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<lfp_t, typename lfp_t::inst_t>, "");
+    lfp_inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<lfp_t, typename lfp_t::inst_t>, "");
+    lfp_inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<lfp_t, typename lfp_t::inst_t>, "");
+    plain_inst_lib.AddInst("Inc", sgp::inst_impl::Inst_Inc<plain_lfp_t, typename plain_lfp_t::inst_t>, "");
+    plain_inst_lib.AddInst("Call", sgp::inst_impl::Inst_Call<plain_lfp_t, typename plain_lfp_t::inst_t>, "");
+    plain_inst_lib.AddInst("Fork", sgp::inst_impl::Inst_Fork<plain_lfp_t, typename plain_lfp_t::inst_t>, "");
+    plain_inst_lib.AddInst("WorkingToGlobal", sgp::inst_impl::Inst_WorkingToGlobal<plain_lfp_t, typename plain_lfp_t::inst_t>, "");
+    const size_t lfp_signal_id = lfp_event_lib.AddEvent("Signal", [](lfp_t & hw, const typename lfp_t::event_t & e) {
+      hw.SpawnThreadWithTag(static_cast<const SignalEvent<TAG_WIDTH> &>(e).tag);
+    });
+    plain_event_lib.AddEvent("Signal", [](plain_lfp_t & hw, const typename plain_lfp_t::event_t & e) {
+      hw.SpawnThreadWithTag(static_cast<const SignalEvent<TAG_WIDTH> &>(e).tag);
+    });
+    emp::vector<emp::BitSet<TAG_WIDTH>> signals;
+    for (size_t i = 0; i < 4; ++i) signals.emplace_back(random);
+    for (size_t i = 0; i < 10; ++i) {
+      const auto lfp_program = sgp::GenRandLinearFunctionsProgram<lfp_t, TAG_WIDTH>(random, lfp_inst_lib, {1, 4}, 1, {1, 16}, 1, 3, {0, 7});
+      emp::Random lfp_random(i), plain_random(i);
+      lfp_t lfp_hw(lfp_random, lfp_inst_lib, lfp_event_lib);
+      plain_lfp_t plain_hw(plain_random, plain_inst_lib, plain_event_lib);
+      lfp_hw.SetProgram(lfp_program);
+      plain_hw.SetProgram(lfp_program);
+      REQUIRE(RunAndRecord(lfp_hw, 50, lfp_signal_id, signals) == RunAndRecord(plain_hw, 50, lfp_signal_id, signals));
+      const auto & lfp_profile = lfp_hw.GetInstrumentation();
+      REQUIRE(lfp_profile.GetEventCount(lfp_signal_id) == 10);
+      REQUIRE(lfp_profile.GetThreadsSpawned() == lfp_profile.GetThreadsKilled() + lfp_hw.GetNumActiveThreads()
+                                                 + lfp_hw.GetNumPendingThreads());
+      // Every spawned thread enters its module at call depth 1.
+      REQUIRE(lfp_profile.GetCallDepthHistogram()[1] == lfp_profile.GetThreadsSpawned());
+    }
+  }
+}
+
+TEST_CASE("SignalGP - EventInbox", "[general]") {
+  // Event carrying which producer sent it and its position in that producer's sequence.
+  struct PostedEvent : public sgp::BaseEvent {
+    size_t producer;
+    size_t seq;
+    PostedEvent(size_t id, size_t p, size_t s) : BaseEvent(id), producer(p), seq(s) { ; }
+  };
+  // Non-trivial event: token counts live copies.
+  struct TokenEvent : public sgp::BaseEvent {
+    std::shared_ptr<int> token;
+    TokenEvent(size_t id, const std::shared_ptr<int> & t) : BaseEvent(id), token(t) { ; }
+  };
+  using inbox_t = sgp::EventInbox<sgp::BaseEvent>;
+  using policy_t = typename inbox_t::FullPolicy;
+
+  // Single-threaded behavior.
+  {
+    inbox_t inbox(5, policy_t::DROP);
+    REQUIRE(inbox.GetCapacity() == 8);
+    sgp::EventQueue<sgp::BaseEvent> queue;
+    REQUIRE(inbox.DrainInto(queue) == 0);
+    for (size_t i = 0; i < 8; ++i) REQUIRE(inbox.TryPush(PostedEvent(0, 0, i)));
+    REQUIRE(!inbox.TryPush(PostedEvent(0, 0, 8)));
+    REQUIRE(inbox.GetNumDropped() == 0);
+    REQUIRE(!inbox.Push(PostedEvent(0, 0, 8)));
+    REQUIRE(inbox.GetNumDropped() == 1);
+    REQUIRE(inbox.GetSize() == 8);
+    REQUIRE(inbox.DrainInto(queue, 3) == 3);
+    for (size_t i = 8; i < 11; ++i) REQUIRE(inbox.Push(PostedEvent(0, 0, i))); // Wraps around.
+    REQUIRE(inbox.DrainInto(queue) == 8);
+    REQUIRE(inbox.GetSize() == 0);
+    REQUIRE(inbox.GetNumPushed() == 11);
+    REQUIRE(inbox.GetNumDrained() == 11);
+    REQUIRE(queue.size() == 11);
+    for (size_t i = 0; i < 11; ++i) REQUIRE(static_cast<const PostedEvent &>(queue[i]).seq == i);
+
+    // Events are destroyed when drained, and when an undrained inbox is destroyed.
+    std::shared_ptr<int> token = std::make_shared<int>(0);
+    inbox.Push(TokenEvent(1, token));
+    inbox.Push(TokenEvent(1, token));
+    REQUIRE(token.use_count() == 3);
+    inbox.DrainInto(queue, 1);
+    REQUIRE(token.use_count() == 3); // One in the inbox, one in the queue.
+    queue.Clear();
+    REQUIRE(token.use_count() == 2);
+    {
+      inbox_t copy(inbox);  // Copies are empty.
+      REQUIRE(copy.GetCapacity() == 8);
+      REQUIRE(copy.DrainInto(queue) == 0);
+      inbox_t moved(std::move(inbox));
+      REQUIRE(token.use_count() == 2);
+    }
+    REQUIRE(token.use_count() == 1);
+  }
+
+  // Concurrent producers, draining while they push.
+  for (policy_t policy : {policy_t::WAIT, policy_t::DROP}) {
+    constexpr size_t NUM_PRODUCERS = 4;
+    constexpr size_t NUM_EVENTS = 20000;
+    inbox_t inbox(64, policy);
+    emp::vector<std::thread> producers;
+    std::atomic<size_t> num_done(0);
+    for (size_t p = 0; p < NUM_PRODUCERS; ++p) {
+      producers.emplace_back([&inbox, &num_done, p]() {
+        for (size_t i = 0; i < NUM_EVENTS; ++i) inbox.Push(PostedEvent(0, p, i));
+        ++num_done;
+      });
+    }
+    sgp::EventQueue<sgp::BaseEvent> queue;
+    emp::vector<size_t> next_seq(NUM_PRODUCERS, 0);
+    bool in_order = true;
+    size_t num_received = 0;
+    while (true) {
+      const bool done = num_done == NUM_PRODUCERS; // Check before draining so nothing is missed.
+      inbox.DrainInto(queue);
+      while (!queue.empty()) {
+        const PostedEvent & event = static_cast<const PostedEvent &>(queue.Front());
+        // Each producer's events arrive in order (some may have been dropped).
+        if (event.seq < next_seq[event.producer]) in_order = false;
+        next_seq[event.producer] = event.seq + 1;
+        ++num_received;
+        queue.PopFront();
+      }
+      if (done) break;
+    }
+    for (auto & producer : producers) producer.join();
+    REQUIRE(in_order);
+    REQUIRE(inbox.GetSize() == 0);
+    REQUIRE(num_received == inbox.GetNumPushed());
+    REQUIRE(inbox.GetNumPushed() + inbox.GetNumDropped() == NUM_PRODUCERS * NUM_EVENTS);
+    if (policy == policy_t::WAIT) {
+      REQUIRE(inbox.GetNumDropped() == 0);
+      REQUIRE(next_seq == emp::vector<size_t>(NUM_PRODUCERS, NUM_EVENTS));
+    }
+  }
+
+  // Posting events to hardware from other threads.
+  {
+    using signalgp_t = ToySignalGP<>;
+    typename signalgp_t::event_lib_t event_lib;
+    size_t num_handled = 0;
+    const size_t event_id = event_lib.AddEvent("Posted", [&num_handled](signalgp_t & hw, const sgp::BaseEvent & e) {
+      ++num_handled;
+    });
+    signalgp_t hw(event_lib);
+    REQUIRE(!hw.HasEventInbox());
+    hw.EnableEventInbox(128, policy_t::WAIT);
+    REQUIRE(hw.HasEventInbox());
+    constexpr size_t NUM_EVENTS = 5000;
+    std::thread producer([&hw, event_id]() {
+      for (size_t i = 0; i < NUM_EVENTS; ++i) hw.PostEvent(PostedEvent(event_id, 0, i));
+    });
+    while (hw.GetEventInbox().GetNumDrained() < NUM_EVENTS) hw.SingleProcess();
+    producer.join();
+    REQUIRE(num_handled == NUM_EVENTS);
+    REQUIRE(hw.GetNumQueuedEvents() == 0);
+    // Hardware resets leave posted events alone.
+    hw.PostEvent(PostedEvent(event_id, 0, 0));
+    hw.ResetBaseHardwareState();
+    hw.SingleProcess();
+    REQUIRE(num_handled == NUM_EVENTS + 1);
+    hw.DisableEventInbox();
+    REQUIRE(!hw.HasEventInbox());
+    hw.SingleProcess();
+  }
+}
+
+TEST_CASE("SignalGP - BroadcastEvent", "[general]") {
+  // Non-trivial event: token counts live copies.
+  struct TokenEvent : public sgp::BaseEvent {
+    std::shared_ptr<int> token;
+    emp::vector<int> payload;
+    TokenEvent(size_t id, const std::shared_ptr<int> & t, const emp::vector<int> & p={})
+      : BaseEvent(id), token(t), payload(p) { ; }
+  };
+  std::shared_ptr<int> token = std::make_shared<int>(0);
+
+  // Shared events in event queues.
+  {
+    sgp::EventQueue<sgp::BaseEvent> queue_a;
+    sgp::EventQueue<sgp::BaseEvent> queue_b;
+    {
+      const sgp::SharedEvent<TokenEvent> shared(TokenEvent(3, token, {1, 2, 3}));
+      REQUIRE(token.use_count() == 2);
+      REQUIRE(shared.GetRefCount() == 1);
+      REQUIRE(shared->GetID() == 3);
+      queue_a.Push(shared);
+      queue_a.Push(shared);
+      queue_b.Push(shared);
+      REQUIRE(shared.GetRefCount() == 4);
+      REQUIRE(token.use_count() == 2); // Queued by reference.
+      REQUIRE(&queue_a.Front() == &queue_b.Front());
+      REQUIRE(static_cast<const TokenEvent &>(queue_b.Front()).payload == emp::vector<int>({1, 2, 3}));
+      {
+        sgp::EventQueue<sgp::BaseEvent> copy(queue_a); // Copies share the event too.
+        REQUIRE(shared.GetRefCount() == 6);
+      }
+      REQUIRE(shared.GetRefCount() == 4);
+      queue_a.PopFront();
+      REQUIRE(shared.GetRefCount() == 3);
+    }
+    REQUIRE(token.use_count() == 2); // Handle's gone; queues still hold the event.
+    queue_a.Clear();
+    REQUIRE(token.use_count() == 2);
+    queue_b.PopFront();
+    REQUIRE(token.use_count() == 1);
+    REQUIRE(queue_b.empty());
+  }
+
+  // Broadcasting to hardware.
+  {
+    using signalgp_t = ToySignalGP<>;
+    typename signalgp_t::event_lib_t event_lib;
+    emp::vector<const sgp::BaseEvent *> handled;
+    const size_t event_id = event_lib.AddEvent("Broadcast", [&handled](signalgp_t & hw, const sgp::BaseEvent & e) {
+      handled.emplace_back(&e);
+    });
+    constexpr size_t NUM_HW = 50;
+    emp::vector<signalgp_t> hardware(NUM_HW, signalgp_t(event_lib));
+    emp::vector<signalgp_t *> recipients;
+    for (signalgp_t & hw : hardware) recipients.emplace_back(&hw);
+
+    event_lib.BroadcastEvent(recipients, TokenEvent(event_id, token, emp::vector<int>(100, 1)));
+    REQUIRE(token.use_count() == 2); // One copy, shared by all recipients.
+    for (signalgp_t & hw : hardware) REQUIRE(hw.GetNumQueuedEvents() == 1);
+    // Snapshotting hardware (by copy) shares queued events as well.
+    signalgp_t copy(hardware[0]);
+    REQUIRE(copy.GetNumQueuedEvents() == 1);
+    REQUIRE(token.use_count() == 2);
+    for (size_t i = 0; i < NUM_HW; ++i) {
+      hardware[i].SingleProcess();
+      REQUIRE(token.use_count() == 2);
+    }
+    REQUIRE(handled.size() == NUM_HW);
+    for (const sgp::BaseEvent * e : handled) REQUIRE(e == handled[0]); // Everyone handled the same event.
+    copy.SingleProcess();
+    REQUIRE(handled.size() == NUM_HW + 1);
+    REQUIRE(token.use_count() == 1);
+
+    // Broadcasting to a subset (any range of hardware pointers works).
+    const std::array<signalgp_t *, 2> some = {{&hardware[1], &hardware[3]}};
+    event_lib.BroadcastEvent(some, TokenEvent(event_id, token));
+    REQUIRE(hardware[0].GetNumQueuedEvents() == 0);
+    REQUIRE(hardware[1].GetNumQueuedEvents() == 1);
+    REQUIRE(hardware[3].GetNumQueuedEvents() == 1);
+    REQUIRE(token.use_count() == 2);
+    hardware[1].ResetBaseHardwareState();
+    hardware[3].ResetBaseHardwareState();
+    REQUIRE(token.use_count() == 1);
+  }
+}
+
+// Events (and handlers) for StaticEventLibrary tests.
+struct PingEvent {
+  size_t value;
+};
+struct PongEvent {
+  std::shared_ptr<int> token;
+  std::string msg;
+  void Print(std::ostream & os) const { os << "{pong:" << msg << "}"; }
+};
+struct PingPongHandlers {
+  emp::vector<std::string> * log;
+  template<typename HW_T>
+  void Handle(HW_T & hw, const PingEvent & e) const {
+    log->emplace_back("ping" + std::to_string(e.value));
+    if (e.value) hw.QueueEvent(PingEvent{e.value - 1}); // Queued while handling; handled this step.
+  }
+  template<typename HW_T>
+  void Handle(HW_T & hw, const PongEvent & e) const { log->emplace_back("pong:" + e.msg); }
+  template<typename HW_T, typename EVENT_T>
+  void Dispatch(HW_T & hw, const EVENT_T & e) const { log->emplace_back("dispatch"); }
+};
+
+TEST_CASE("SignalGP - StaticEventLibrary", "[general]") {
+  using event_lib_t = sgp::StaticEventLibrary<PingPongHandlers, PingEvent, PongEvent>;
+  using queue_t = typename event_lib_t::event_queue_t;
+  static_assert(event_lib_t::GetSize() == 2);
+  static_assert(event_lib_t::GetID<PingEvent>() == 0);
+  static_assert(event_lib_t::GetID<PongEvent>() == 1);
+  std::shared_ptr<int> token = std::make_shared<int>(0);
+
+  // Event queue.
+  {
+    queue_t queue;
+    REQUIRE(queue.empty());
+    queue.Push(PingEvent{0});
+    const auto & front = queue.Front();
+    for (size_t i = 1; i < 200; ++i) {
+      if (i % 2) queue.Push(PingEvent{i});
+      else queue.Push(PongEvent{token, std::to_string(i)});
+    }
+    REQUIRE(&front == &queue.Front()); // Queued events don't move.
+    REQUIRE(queue.size() == 200);
+    REQUIRE(token.use_count() == 100);
+    REQUIRE(event_lib_t::GetEventID(queue[3]) == 0);
+    REQUIRE(event_lib_t::GetEventID(queue[4]) == 1);
+    REQUIRE(std::get<PongEvent>(queue[4]).msg == "4");
+    queue_t copy(queue);
+    REQUIRE(token.use_count() == 199);
+    for (size_t i = 0; i < 3; ++i) copy.PopFront();
+    REQUIRE(token.use_count() == 198); // Popped events are destroyed.
+    queue_t moved(std::move(copy));
+    REQUIRE(copy.empty());
+    REQUIRE(moved.size() == 197);
+    REQUIRE(std::get<PingEvent>(moved.Front()).value == 3);
+    moved = queue;
+    REQUIRE(moved.size() == 200);
+    moved.Clear();
+    queue.clear();
+    REQUIRE(token.use_count() == 1);
+    queue.Push(PingEvent{5});
+    REQUIRE(std::get<PingEvent>(queue.Front()).value == 5);
+    queue.PopFront();
+    REQUIRE(queue.empty());
+
+    std::ostringstream os;
+    event_lib_t::PrintEvent(typename event_lib_t::event_t(PingEvent{1}), os);
+    event_lib_t::PrintEvent(typename event_lib_t::event_t(PongEvent{token, "hi"}), os);
+    REQUIRE(os.str() == "{id:0}{pong:hi}");
+  }
+
+  // Hardware with a static event library.
+  {
+    using signalgp_t = ToySignalGP<sgp::DefaultCustomComponent, event_lib_t>;
+    static_assert(std::is_same<typename signalgp_t::event_lib_t, event_lib_t>::value);
+    static_assert(std::is_same<typename signalgp_t::event_t, std::variant<PingEvent, PongEvent>>::value);
+    emp::vector<std::string> log;
+    event_lib_t event_lib(PingPongHandlers{&log});
+    signalgp_t hw(event_lib);
+    hw.QueueEvent(PingEvent{2});
+    hw.QueueEvent(PongEvent{token, "a"});
+    REQUIRE(hw.GetNumQueuedEvents() == 2);
+    std::ostringstream os;
+    hw.PrintEventQueue(os);
+    REQUIRE(os.str() == "Event queue (2): [{id:0}, {pong:a}]");
+    signalgp_t copy(hw);
+    hw.SingleProcess();
+    REQUIRE(log == emp::vector<std::string>({"ping2", "pong:a", "ping1", "ping0"}));
+    REQUIRE(hw.GetNumQueuedEvents() == 0);
+    REQUIRE(token.use_count() == 2); // Still queued on the copy.
+    log.clear();
+    copy.SingleProcess();
+    REQUIRE(log == emp::vector<std::string>({"ping2", "pong:a", "ping1", "ping0"}));
+    REQUIRE(token.use_count() == 1);
+
+    log.clear();
+    hw.HandleEvent(PongEvent{token, "now"});
+    hw.TriggerEvent(PingEvent{0});
+    REQUIRE(log == emp::vector<std::string>({"pong:now", "dispatch"}));
+
+    // Posting events from other threads.
+    log.clear();
+    hw.EnableEventInbox(16);
+    std::thread producer([&hw, &token]() {
+      hw.PostEvent(PingEvent{0});
+      hw.PostEvent(PongEvent{token, "posted"});
+    });
+    producer.join();
+    hw.SingleProcess();
+    REQUIRE(log == emp::vector<std::string>({"ping0", "pong:posted"}));
+  }
+
+  // Linear-program hardware with a static event library.
+  {
+    using signalgp_t = sgp::LinearProgramSignalGP<sgp::SimpleMemoryModel, emp::BitSet<16>, int,
+                                                  emp::MatchBin< size_t, emp::HammingMetric<16>,
+                                                                 emp::RankedSelector<>,
+                                                                 emp::AdditiveCountdownRegulator<> >,
+                                                  sgp::DefaultCustomComponent, sgp::NoInstrumentation,
+                                                  event_lib_t>;
+    emp::vector<std::string> log;
+    emp::Random random(2);
+    typename signalgp_t::inst_lib_t inst_lib;
+    event_lib_t event_lib(PingPongHandlers{&log});
+    signalgp_t hw(random, inst_lib, event_lib);
+    hw.QueueEvent(PingEvent{1});
+    hw.SingleProcess();
+    REQUIRE(log == emp::vector<std::string>({"ping1", "ping0"}));
+  }
+}
+
+TEST_CASE("SignalGP - EventTimerWheel", "[general]") {
+  // Non-trivial event: token counts live copies.
+  struct TokenEvent : public sgp::BaseEvent {
+    std::shared_ptr<int> token;
+    TokenEvent(size_t id, const std::shared_ptr<int> & t) : BaseEvent(id), token(t) { ; }
+  };
+  std::shared_ptr<int> token = std::make_shared<int>(0);
+
+  // Small wheel (2 levels of 4 buckets + overflow, spanning 16 steps) vs. brute force.
+  {
+    using queue_t = sgp::EventQueue<sgp::BaseEvent>;
+    sgp::EventTimerWheel<queue_t, 2, 2> wheel;
+    emp::Random random(5);
+    std::multimap<size_t, size_t> expected;          // Due step -> event id.
+    std::map<size_t, std::pair<size_t, size_t>> reps; // Repeating id -> (event id, period).
+    std::map<size_t, size_t> rep_next;               // Repeating id -> next due step.
+    size_t next_event_id = 0;
+    queue_t queue;
+    bool all_match = true;
+    for (size_t step = 0; step < 2000; ++step) {
+      // Schedule some events (with delays beyond the wheel's span, too).
+      const size_t num_new = random.GetUInt(4);
+      for (size_t i = 0; i < num_new; ++i) {
+        const size_t delay = random.P(0.1) ? random.GetUInt(200) : random.GetUInt(20);
+        const size_t id = next_event_id++;
+        if (random.P(0.05)) {
+          const size_t period = 1 + random.GetUInt(40);
+          const size_t rep_id = wheel.ScheduleRepeating(TokenEvent(id, token), period, delay);
+          reps[rep_id] = {id, period};
+          rep_next[rep_id] = wheel.GetTime() + delay + 1;
+        } else {
+          wheel.Schedule(TokenEvent(id, token), delay);
+          expected.emplace(wheel.GetTime() + delay + 1, id);
+        }
+      }
+      if (reps.size() && random.P(0.02)) {
+        const size_t rep_id = reps.begin()->first;
+        REQUIRE(wheel.CancelRepeating(rep_id));
+        REQUIRE(!wheel.CancelRepeating(rep_id));
+        reps.erase(rep_id);
+        rep_next.erase(rep_id);
+      }
+      wheel.Advance(queue);
+      const size_t now = wheel.GetTime();
+      emp::vector<size_t> due_ids;
+      for (auto it = expected.lower_bound(now); it != expected.upper_bound(now); ++it) due_ids.emplace_back(it->second);
+      expected.erase(now);
+      for (auto & [rep_id, next] : rep_next) {
+        if (next == now) {
+          due_ids.emplace_back(reps[rep_id].first);
+          next += reps[rep_id].second;
+        }
+      }
+      emp::vector<size_t> got_ids;
+      while (!queue.empty()) {
+        got_ids.emplace_back(queue.Front().GetID());
+        queue.PopFront();
+      }
+      std::sort(due_ids.begin(), due_ids.end());
+      std::sort(got_ids.begin(), got_ids.end());
+      if (due_ids != got_ids) all_match = false;
+    }
+    REQUIRE(all_match);
+    REQUIRE(wheel.GetNumRepeating() == reps.size());
+    REQUIRE(wheel.GetSize() >= expected.size() + reps.size());
+    REQUIRE(token.use_count() == 1 + (long)wheel.GetSize());
+    wheel.Clear();
+    REQUIRE(wheel.GetSize() == 0);
+    REQUIRE(wheel.GetTime() == 0);
+    REQUIRE(token.use_count() == 1);
+  }
+
+  // Scheduling events on hardware.
+  {
+    using signalgp_t = ToySignalGP<>;
+    typename signalgp_t::event_lib_t event_lib;
+    emp::vector<size_t> handled;
+    size_t step = 0;
+    const size_t event_id = event_lib.AddEvent("Timed", [&handled, &step](signalgp_t & hw, const sgp::BaseEvent & e) {
+      handled.emplace_back(step);
+    });
+    signalgp_t hw(event_lib);
+    REQUIRE(hw.GetNumScheduledEvents() == 0);
+    hw.ScheduleEvent(TokenEvent(event_id, token), 0);
+    hw.ScheduleEvent(TokenEvent(event_id, token), 3);
+    hw.ScheduleEvent(TokenEvent(event_id, token), 1000);
+    const size_t rep_id = hw.ScheduleRepeatingEvent(sgp::BaseEvent(event_id), 5, 1);
+    REQUIRE(hw.GetNumScheduledEvents() == 4);
+    REQUIRE(token.use_count() == 4);
+    // Snapshots (by copy or SaveBaseState) include scheduled events.
+    signalgp_t copy(hw);
+    typename signalgp_t::BaseState state;
+    hw.SaveBaseState(state);
+    for (step = 0; step < 12; ++step) hw.SingleProcess();
+    REQUIRE(handled == emp::vector<size_t>({0, 1, 3, 6, 11}));
+    REQUIRE(hw.GetNumScheduledEvents() == 2);
+    REQUIRE(hw.CancelRepeatingEvent(rep_id));
+    REQUIRE(!hw.CancelRepeatingEvent(rep_id));
+    handled.clear();
+    for (step = 0; step < 1000; ++step) hw.SingleProcess();
+    REQUIRE(handled == emp::vector<size_t>({988}));
+    REQUIRE(hw.GetNumScheduledEvents() == 0);
+
+    hw.RestoreBaseState(state);
+    REQUIRE(hw.GetNumScheduledEvents() == 4);
+    handled.clear();
+    for (step = 0; step < 4; ++step) hw.SingleProcess();
+    REQUIRE(handled == emp::vector<size_t>({0, 1, 3}));
+    hw.ResetBaseHardwareState(); // Resets clear scheduled events.
+    REQUIRE(hw.GetNumScheduledEvents() == 0);
+    state.timer_wheel.reset();
+    handled.clear();
+    for (step = 0; step < 20; ++step) copy.SingleProcess();
+    REQUIRE(handled == emp::vector<size_t>({0, 1, 3, 6, 11, 16}));
+    copy.ClearScheduledEvents();
+    REQUIRE(token.use_count() == 1);
+  }
+
+  // Scheduling events on hardware with a static event library.
+  {
+    using event_lib_t = sgp::StaticEventLibrary<PingPongHandlers, PingEvent, PongEvent>;
+    using signalgp_t = ToySignalGP<sgp::DefaultCustomComponent, event_lib_t>;
+    emp::vector<std::string> log;
+    event_lib_t event_lib(PingPongHandlers{&log});
+    signalgp_t hw(event_lib);
+    hw.ScheduleEvent(PongEvent{token, "later"}, 1);
+    hw.ScheduleRepeatingEvent(PingEvent{0}, 2);
+    for (size_t i = 0; i < 4; ++i) hw.SingleProcess();
+    REQUIRE(log == emp::vector<std::string>({"ping0", "pong:later", "ping0"}));
+    hw.ResetBaseHardwareState();
+    REQUIRE(token.use_count() == 1);
+  }
+}